@@ -0,0 +1,221 @@
+#include "AI/BombermanBotBrain.h"
+
+#include "AI/BombermanFlowFieldSubsystem.h"
+#include "Core/BombermanStats.h"
+
+namespace
+{
+	// Cells a player can walk through
+	constexpr EGridCellFlags WalkStop = EGridCellFlags::Wall | EGridCellFlags::Block | EGridCellFlags::Bomb;
+
+	// Earliest tick the cell burns, counting the bomb the bot is about to place (Scratch.OwnBlast)
+	int64 GetBurnTick(const FBotSnapshot& Snapshot, const FBotScratch& Scratch, FGridCoord Cell, int64 OwnBlastTick)
+	{
+		const int64 BurnTick = Snapshot.GetBurnTick(Cell);
+		if (Scratch.OwnBlast.Num() == 0 || !Snapshot.Grid.Contains(Cell) || !Scratch.OwnBlast[Snapshot.Grid.ToIndex(Cell)]) return BurnTick;
+
+		return FMath::Min(BurnTick, OwnBlastTick);
+	}
+
+	// First step towards the closest cell no blast reaches, going only through cells that stay
+	// clear until the bot is through. OutStep is From when From is already safe
+	bool FindSafeCell(const FBotSnapshot& Snapshot, const FBotView& View, FBotScratch& Scratch, int64 OwnBlastTick, FGridCoord& OutStep)
+	{
+		const FBombermanGrid& Grid = Snapshot.Grid;
+		const FGridCoord From	   = View.Cell;
+		if (!Grid.Contains(From)) return false;
+
+		Scratch.ArrivalTicks.Init(MAX_int64, Grid.Num());
+		Scratch.FirstSteps.Init(INDEX_NONE, Grid.Num());
+		Scratch.Queue.Reset(Grid.Num());
+
+		const int32 FromIndex			= Grid.ToIndex(From);
+		Scratch.ArrivalTicks[FromIndex] = Snapshot.Now;
+		Scratch.Queue.Add(FromIndex);
+
+		for (int32 Head = 0; Head < Scratch.Queue.Num(); Head++)
+		{
+			const int32 Index	  = Scratch.Queue[Head];
+			const FGridCoord Cell = Grid.ToCell(Index);
+			if (GetBurnTick(Snapshot, Scratch, Cell, OwnBlastTick) == FBombermanDangerMap::Never)
+			{
+				OutStep = Scratch.FirstSteps[Index] == INDEX_NONE ? From : From + GridDirections[Scratch.FirstSteps[Index]];
+				return true;
+			}
+
+			const int64 Arrival = Scratch.ArrivalTicks[Index] + View.TicksPerCell;
+			for (int32 Dir = 0; Dir < 4; Dir++)
+			{
+				const FGridCoord Next = Cell + GridDirections[Dir];
+				if (Grid.HasAny(Next, WalkStop)) continue;
+
+				// The bot has to be out of the cell again before it burns
+				const int32 NextIndex = Grid.ToIndex(Next);
+				if (Scratch.ArrivalTicks[NextIndex] != MAX_int64
+					|| GetBurnTick(Snapshot, Scratch, Next, OwnBlastTick) <= Arrival + View.TicksPerCell + View.Settings.SafetyMarginTicks)
+				{
+					continue;
+				}
+
+				Scratch.ArrivalTicks[NextIndex] = Arrival;
+				Scratch.FirstSteps[NextIndex]	= Scratch.FirstSteps[Index] == INDEX_NONE ? int8(Dir) : Scratch.FirstSteps[Index];
+				Scratch.Queue.Add(NextIndex);
+			}
+		}
+		return false;
+	}
+
+	bool IsWorthBombing(const FBombermanGrid& Grid, FGridCoord Cell, int32 Power)
+	{
+		if (Grid.HasAny(Cell, EGridCellFlags::Bomb)) return false;
+
+		bool bHits = false;
+		Grid.ForEachBlastCell(Cell, Power, [&bHits](FGridCoord, int32 Distance, bool, EGridCellFlags Flags)
+		{
+			bHits |= Distance > 0 && EnumHasAnyFlags(Flags, EGridCellFlags::Block | EGridCellFlags::Player);
+		});
+		return bHits;
+	}
+
+	// Direction (index into GridDirections) of an adjacent bomb that would roll at a player, INDEX_NONE if none
+	int32 FindKickDirection(const FBombermanGrid& Grid, FGridCoord Cell, int32 SightCells)
+	{
+		for (int32 Dir = 0; Dir < 4; Dir++)
+		{
+			const FGridCoord BombCell = Cell + GridDirections[Dir];
+			if (!Grid.HasAny(BombCell, EGridCellFlags::Bomb) || Grid.HasAny(BombCell + GridDirections[Dir], EGridCellFlags::KickStop)) continue;
+
+			// A player further down the line, before anything would stop the bomb
+			for (int32 Distance = 2; Distance <= SightCells; Distance++)
+			{
+				const EGridCellFlags Flags = Grid.Get(Cell + GridDirections[Dir] * Distance);
+				if (EnumHasAnyFlags(Flags, EGridCellFlags::Player)) return Dir;
+				if (EnumHasAnyFlags(Flags, EGridCellFlags::KickStop)) break;
+			}
+		}
+		return INDEX_NONE;
+	}
+
+	void MoveTo(const FBotView& View, FGridCoord To, FBotDecision& OutDecision)
+	{
+		OutDecision.MoveTarget		= To;
+		OutDecision.bThinkOnArrival = To != View.Cell;
+	}
+
+	void DecideBySearch(const FBotSnapshot& Snapshot, const FBotView& View, FBotScratch& Scratch, FBotDecision& OutDecision)
+	{
+		if (!Scratch.Planner)
+		{
+			Scratch.Planner = MakeUnique<FBombermanSimMcts>();
+		}
+
+		// One tree each, the bots of a batch already search side by side
+		FSimMctsConfig Config;
+		Config.NumTrees		 = 1;
+		Config.BudgetSeconds = View.SearchSeconds;
+		Config.Seed			 = int32(Snapshot.Now) * 31 + View.Seat;
+
+		const FSimMctsResult Result = Scratch.Planner->Search(Snapshot.SimState, View.Seat, Config);
+		switch (Result.Action)
+		{
+			case ESimMctsAction::PlaceBomb: OutDecision.Action = EBotAction::PlaceBomb; break;
+			case ESimMctsAction::Kick: OutDecision.Action = EBotAction::Kick; break;
+			case ESimMctsAction::Wait: break;
+			// Walking into a bomb turns the pawn towards it, which lines up a kick
+			default: MoveTo(View, View.Cell + GridDirections[int32(Result.Action)], OutDecision); break;
+		}
+
+		// Search again right after the step, waiting is the only action worth the think interval
+		OutDecision.bThinkOnArrival = Result.Action != ESimMctsAction::Wait;
+	}
+}
+
+namespace BombermanBotBrain
+{
+	void Decide(const FBotSnapshot& Snapshot, const FBotView& View, FBotScratch& Scratch, FBotDecision& OutDecision)
+	{
+		BOMBERMAN_SCOPE(BotThink);
+
+		const FBombermanGrid& Grid = Snapshot.Grid;
+		const FGridCoord Cell	   = View.Cell;
+		const int64 Now			   = Snapshot.Now;
+		FGridCoord Step;
+
+		OutDecision = FBotDecision();
+		MoveTo(View, Cell, OutDecision);
+		if (!Grid.Contains(Cell)) return;
+
+		if (View.SearchSeconds > 0.0 && Snapshot.bHasSimState && Snapshot.SimState.Players.IsValidIndex(View.Seat))
+		{
+			DecideBySearch(Snapshot, View, Scratch, OutDecision);
+			return;
+		}
+
+		// Out of anything that is going to burn first
+		if (Snapshot.GetBurnTick(Cell) != FBombermanDangerMap::Never)
+		{
+			MoveTo(View, FindSafeCell(Snapshot, View, Scratch, FBombermanDangerMap::Never, Step) ? Step : Cell, OutDecision);
+			return;
+		}
+
+		// Bomb when it hits something and the way out of the own blast stays open
+		if (View.bCanPlaceBomb && IsWorthBombing(Grid, Cell, View.BombPower))
+		{
+			Scratch.OwnBlast.Init(false, Grid.Num());
+			Grid.ForEachBlastCell(Cell, View.BombPower, [&Scratch, &Grid](FGridCoord BlastCell, int32, bool, EGridCellFlags)
+			{
+				if (Grid.Contains(BlastCell)) Scratch.OwnBlast[Grid.ToIndex(BlastCell)] = true;
+			});
+
+			const bool bCanEscape = FindSafeCell(Snapshot, View, Scratch, Now + View.Settings.EscapeBudgetTicks, Step);
+			Scratch.OwnBlast.Reset();
+			if (bCanEscape && Step != Cell)
+			{
+				OutDecision.Action = EBotAction::PlaceBomb;
+				MoveTo(View, Step, OutDecision);
+				return;
+			}
+		}
+
+		// Send a bomb down a line with a player in it, the pawn has to face the bomb to kick it
+		const int32 KickDir = View.bCanKick ? FindKickDirection(Grid, Cell, View.Settings.KickSightCells) : INDEX_NONE;
+		if (KickDir != INDEX_NONE)
+		{
+			if (View.FacingDir == KickDir) OutDecision.Action = EBotAction::Kick;
+			MoveTo(View, Cell + GridDirections[KickDir], OutDecision);
+			return;
+		}
+
+		// Chase the closest player, dig through blocks while none can be reached
+		const FGridFlowField* Field = nullptr;
+		int32 ClosestDistance		= MAX_int32;
+		for (int32 Index = 0; Index < Snapshot.PlayerCells.Num(); Index++)
+		{
+			if (Index == View.PlayerIndex) continue;
+
+			const int32 Distance = FGridCoord::Distance(Cell, Snapshot.PlayerCells[Index]);
+			if (Distance < ClosestDistance)
+			{
+				ClosestDistance = Distance;
+				Field			= Snapshot.PlayerFields[Index];
+			}
+		}
+		if (!Field || Field->GetDistance(Grid, Cell) == FGridFlowField::Unreachable)
+		{
+			Field = Snapshot.BlocksField;
+		}
+		if (!Field || Field->GetDistance(Grid, Cell) == FGridFlowField::Unreachable) return;
+
+		// Downhill, skipping cells that burn before the bot is through them
+		const uint8 Downhill = Field->GetDownhillMask(Grid, Cell);
+		for (int32 Dir = 0; Dir < 4; Dir++)
+		{
+			const FGridCoord Next = Cell + GridDirections[Dir];
+			if ((Downhill & (1 << Dir)) && Snapshot.GetBurnTick(Next) > Now + 2 * View.TicksPerCell + View.Settings.SafetyMarginTicks)
+			{
+				MoveTo(View, Next, OutDecision);
+				return;
+			}
+		}
+	}
+}
@@ -0,0 +1,200 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AI/BombermanBotController.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "HAL/IConsoleManager.h"
+
+#include "AI/BombermanBotBrain.h"
+#include "AI/BombermanBotSchedulerSubsystem.h"
+#include "Core/BombermanClock.h"
+#include "Core/BombermanLog.h"
+#include "Player/BombermanCharacter.h"
+#include "World/BombermanGridSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BombermanBotController)
+
+static FAutoConsoleCommandWithWorldAndArgs CmdAddBots(
+	TEXT("bomberman.Bot.Add"),
+	TEXT("Spawns bots at the player starts: bomberman.Bot.Add [Count]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		ABombermanBotController::SpawnBots(World, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1);
+	}));
+
+ABombermanBotController::ABombermanBotController()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	// Bots hold a seat like players do (collision channel, score)
+	bWantsPlayerState = true;
+}
+
+void ABombermanBotController::SpawnBots(UWorld* World, int32 Count)
+{
+	AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr;
+	if (!GameMode) return;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		ABombermanBotController* Bot = World->SpawnActor<ABombermanBotController>(SpawnParams);
+		UClass* PawnClass			 = GameMode->GetDefaultPawnClassForController(Bot);
+		AActor* Start				 = GameMode->ChoosePlayerStart(Bot);
+		APawn* Pawn					 = PawnClass && Start ? World->SpawnActor<APawn>(PawnClass, Start->GetActorTransform(), SpawnParams) : nullptr;
+		if (!Pawn)
+		{
+			Bot->Destroy();
+			UE_LOG(LogBomberman, Warning, TEXT("Could not spawn a bot pawn"));
+			return;
+		}
+		Bot->Possess(Pawn);
+	}
+
+	UE_LOG(LogBomberman, Log, TEXT("Spawned %d bots"), Count);
+}
+
+void ABombermanBotController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UBombermanBotSchedulerSubsystem* Scheduler = GetWorld()->GetSubsystem<UBombermanBotSchedulerSubsystem>())
+	{
+		Scheduler->Register(this);
+	}
+}
+
+void ABombermanBotController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UBombermanBotSchedulerSubsystem* Scheduler = GetWorld()->GetSubsystem<UBombermanBotSchedulerSubsystem>())
+	{
+		Scheduler->Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ABombermanBotController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	// Spread the bots' decisions over the interval instead of all on one frame
+	ThinkCountdown = FMath::FRand() * ThinkInterval;
+	bHasMoveTarget = false;
+}
+
+void ABombermanBotController::OnUnPossess()
+{
+	bHasMoveTarget = false;
+
+	Super::OnUnPossess();
+}
+
+ABombermanCharacter* ABombermanBotController::GetBot() const
+{
+	return GetPawn<ABombermanCharacter>();
+}
+
+void ABombermanBotController::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	ThinkCountdown -= DeltaSeconds;
+	if (ThinkCountdown <= 0.0f)
+	{
+		ThinkCountdown = ThinkInterval;
+		RequestDecision();
+	}
+
+	Steer();
+}
+
+// ===== Decisions =====
+
+void ABombermanBotController::RequestDecision()
+{
+	if (UBombermanBotSchedulerSubsystem* Scheduler = GetWorld()->GetSubsystem<UBombermanBotSchedulerSubsystem>())
+	{
+		Scheduler->RequestDecision(this);
+	}
+}
+
+bool ABombermanBotController::GetBotView(FBotView& OutView) const
+{
+	const ABombermanCharacter* Bot		= GetBot();
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Bot || Bot->IsDead() || !Grid || !Grid->GetGrid().IsValid()) return false;
+
+	const FBombermanGrid& GridData = Grid->GetGrid();
+	OutView.Cell				   = GridData.WorldToCell(Bot->GetActorLocation());
+	OutView.TicksPerCell		   = FMath::Max(1, FMath::CeilToInt32(GridData.CellSize / FMath::Max(1.0f, Bot->GetMoveSpeed()) * BombermanClock::TicksPerSecond));
+	OutView.BombPower			   = Bot->GetBombPower();
+	OutView.bCanPlaceBomb		   = Bot->GetBombCount() < Bot->GetMaxBombCount();
+	OutView.bCanKick			   = Bot->CanKickBombs();
+	OutView.FacingDir			   = GridDirectionFromVector(Bot->GetActorForwardVector());
+	OutView.PlayerIndex			   = INDEX_NONE;
+	OutView.Seat				   = Grid->GetPlayers().IndexOfByKey(Bot);
+	OutView.SearchSeconds		   = FMath::Max(0.0f, LookaheadBudgetMs) / 1000.0;
+
+	OutView.Settings.SafetyMarginTicks = SafetyMarginTicks;
+	OutView.Settings.EscapeBudgetTicks = BombermanClock::SecondsToTicks(EscapeBudgetSeconds);
+	OutView.Settings.KickSightCells	   = KickSightCells;
+	return true;
+}
+
+void ABombermanBotController::ApplyDecision(const FBotDecision& Decision)
+{
+	ABombermanCharacter* Bot = GetBot();
+	if (!Bot || Bot->IsDead())
+	{
+		bHasMoveTarget = false;
+		return;
+	}
+
+	switch (Decision.Action)
+	{
+	case EBotAction::PlaceBomb:
+		Bot->ApplyBombPlaceInput();
+		break;
+	case EBotAction::Kick:
+		Bot->ApplyBombKickInput();
+		break;
+	default:
+		break;
+	}
+
+	MoveTarget		= Decision.MoveTarget;
+	bHasMoveTarget	= true;
+	bThinkOnArrival = Decision.bThinkOnArrival;
+}
+
+// ===== Movement =====
+
+void ABombermanBotController::Steer()
+{
+	ABombermanCharacter* Bot			= GetBot();
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!bHasMoveTarget || !Bot || Bot->IsDead() || !Grid) return;
+
+	// Towards the cell center, which also pulls the pawn back into the lane
+	const FVector Location = Bot->GetActorLocation();
+	const FVector Delta	   = (Grid->CellToWorld(MoveTarget, Location.Z) - Location) * FVector(1.0, 1.0, 0.0);
+	if (Delta.SizeSquared() <= FMath::Square(ArriveTolerance * Grid->GetCellSize()))
+	{
+		bHasMoveTarget = false;
+
+		// Keep rolling into the next cell without waiting for the think interval
+		if (bThinkOnArrival)
+		{
+			ThinkCountdown = ThinkInterval;
+			RequestDecision();
+		}
+		return;
+	}
+
+	const FVector Direction = Delta.GetSafeNormal2D();
+	Bot->ApplyMoveInput(FVector2D(Direction.Y, Direction.X));
+}
@@ -0,0 +1,209 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AI/BombermanBotSchedulerSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#include "AI/BombermanBotController.h"
+#include "AI/BombermanFlowFieldSubsystem.h"
+#include "Core/BombermanStats.h"
+#include "Player/BombermanCharacter.h"
+#include "World/BombUpdateSubsystem.h"
+#include "World/BombermanGridSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BombermanBotSchedulerSubsystem)
+
+static TAutoConsoleVariable<float> CVarBotBudgetMs(
+	TEXT("bomberman.Bot.BudgetMs"),
+	0.5f,
+	TEXT("Game thread milliseconds per frame the bot scheduler may spend on decisions.\n")
+	TEXT("At least one batch runs every frame, the rest of the queue waits for the next one."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarBotBatchSize(
+	TEXT("bomberman.Bot.BatchSize"),
+	8,
+	TEXT("Bot decisions planned together in one parallel pass."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarBotParallel(
+	TEXT("bomberman.Bot.Parallel"),
+	true,
+	TEXT("Plan a batch of bot decisions on worker threads, 0 plans them one after another on the game thread."),
+	ECVF_Default);
+
+void UBombermanBotSchedulerSubsystem::Deinitialize()
+{
+	for (FBotEntry& Entry : Entries)
+	{
+		if (Entry.Bot) Entry.Bot->SchedulerSlot = INDEX_NONE;
+	}
+	Entries.Empty();
+	Queue.Empty();
+	Batch.Empty();
+	Snapshot = FBotSnapshot();
+	SnapshotPlayers.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UBombermanBotSchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBombermanBotSchedulerSubsystem, STATGROUP_Bomberman);
+}
+
+void UBombermanBotSchedulerSubsystem::Register(ABombermanBotController* Bot)
+{
+	if (!Bot || Bot->SchedulerSlot != INDEX_NONE) return;
+
+	Bot->SchedulerSlot = Entries.AddDefaulted();
+	Entries[Bot->SchedulerSlot].Bot = Bot;
+}
+
+void UBombermanBotSchedulerSubsystem::Unregister(ABombermanBotController* Bot)
+{
+	if (!Bot || !Entries.IsValidIndex(Bot->SchedulerSlot) || Entries[Bot->SchedulerSlot].Bot != Bot) return;
+
+	// Swap the last slot into the hole, its queued request moves along
+	const int32 Slot	 = Bot->SchedulerSlot;
+	const int32 LastSlot = Entries.Num() - 1;
+	Queue.Remove(Slot);
+	Entries.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+
+	if (Entries.IsValidIndex(Slot))
+	{
+		Entries[Slot].Bot->SchedulerSlot = Slot;
+		const int32 QueueIndex			 = Queue.Find(LastSlot);
+		if (QueueIndex != INDEX_NONE) Queue[QueueIndex] = Slot;
+	}
+	Bot->SchedulerSlot = INDEX_NONE;
+}
+
+void UBombermanBotSchedulerSubsystem::RequestDecision(ABombermanBotController* Bot)
+{
+	if (!Bot || !Entries.IsValidIndex(Bot->SchedulerSlot)) return;
+
+	FBotEntry& Entry = Entries[Bot->SchedulerSlot];
+	if (Entry.bQueued) return;
+
+	Entry.bQueued	  = true;
+	Entry.RequestTime = FPlatformTime::Seconds();
+	Queue.Add(Bot->SchedulerSlot);
+}
+
+bool UBombermanBotSchedulerSubsystem::UpdateSnapshot()
+{
+	const UBombermanGridSubsystem* Grid		 = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	UBombermanFlowFieldSubsystem* FlowFields = GetWorld()->GetSubsystem<UBombermanFlowFieldSubsystem>();
+	const UBombUpdateSubsystem* Updates		 = GetWorld()->GetSubsystem<UBombUpdateSubsystem>();
+	if (!Grid || !FlowFields || !Grid->GetGrid().IsValid()) return false;
+
+	// Bombs placed by an earlier batch of the frame have to show up for the next one
+	if (Snapshot.Frame == GFrameCounter && Snapshot.LayoutVersion == Grid->GetLayoutVersion()) return true;
+
+	const FBombermanGrid& GridData = Grid->GetGrid();
+	Snapshot.Grid				   = GridData;
+	Snapshot.Now				   = Updates ? Updates->GetCurrentTick() : 0;
+	Snapshot.LayoutVersion		   = Grid->GetLayoutVersion();
+	Snapshot.Frame				   = GFrameCounter;
+
+	Snapshot.BurnTicks.SetNumUninitialized(GridData.Num(), EAllowShrinking::No);
+	for (int32 Index = 0; Index < GridData.Num(); Index++)
+	{
+		Snapshot.BurnTicks[Index] = Grid->GetBurnTick(GridData.ToCell(Index));
+	}
+
+	// Fields are built here on the game thread, the planning tasks only read them
+	Snapshot.PlayerCells.Reset();
+	Snapshot.PlayerFields.Reset();
+	SnapshotPlayers.Reset();
+	for (const TWeakObjectPtr<ABombermanCharacter>& WeakPlayer : Grid->GetPlayers())
+	{
+		const ABombermanCharacter* Player = WeakPlayer.Get();
+		if (!Player || Player->IsDead()) continue;
+
+		const FGridCoord Cell = GridData.WorldToCell(Player->GetActorLocation());
+		Snapshot.PlayerCells.Add(Cell);
+		Snapshot.PlayerFields.Add(FlowFields->GetFieldToCell(Cell));
+		SnapshotPlayers.Add(Player);
+	}
+	Snapshot.BlocksField  = FlowFields->GetFieldToBlocks();
+	Snapshot.bHasSimState = false;
+	return true;
+}
+
+void UBombermanBotSchedulerSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	BOMBERMAN_SCOPE(BotSchedule);
+
+	const double StartTime		  = FPlatformTime::Seconds();
+	const double BudgetSeconds	  = FMath::Max(0.0f, CVarBotBudgetMs.GetValueOnGameThread()) / 1000.0;
+	const int32 BatchSize		  = FMath::Max(1, CVarBotBatchSize.GetValueOnGameThread());
+	const EParallelForFlags Flags = CVarBotParallel.GetValueOnGameThread() ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread;
+
+	int32 Head			  = 0;
+	int32 Decisions		  = 0;
+	double MaxLatencyMs	  = 0.0;
+	double ElapsedSeconds = 0.0;
+
+	// At least one batch per frame, a tight budget slows the bots down instead of stopping them
+	while (Head < Queue.Num() && (Decisions == 0 || ElapsedSeconds < BudgetSeconds) && UpdateSnapshot())
+	{
+		// Pawn state is read here on the game thread
+		Batch.Reset();
+		bool bBatchSearches = false;
+		while (Head < Queue.Num() && Batch.Num() < BatchSize)
+		{
+			const int32 Slot = Queue[Head++];
+			FBotEntry& Entry = Entries[Slot];
+			Entry.bQueued	 = false;
+			if (Entry.Bot->GetBotView(Entry.View))
+			{
+				Entry.View.PlayerIndex = SnapshotPlayers.IndexOfByKey(Entry.Bot->GetPawn());
+				bBatchSearches |= Entry.View.SearchSeconds > 0.0;
+				Batch.Add(Slot);
+			}
+		}
+
+		if (bBatchSearches && !Snapshot.bHasSimState)
+		{
+			GetWorld()->GetSubsystem<UBombermanGridSubsystem>()->CaptureSimState(FSimRules(), Snapshot.SimState);
+			Snapshot.bHasSimState = true;
+		}
+
+		// Searches differ a lot in length (fleeing vs following a field), let idle workers steal
+		ParallelFor(Batch.Num(), [this](int32 Index)
+		{
+			FBotEntry& Entry = Entries[Batch[Index]];
+			BombermanBotBrain::Decide(Snapshot, Entry.View, Entry.Scratch, Entry.Decision);
+		}, Flags);
+
+		const double Now = FPlatformTime::Seconds();
+		for (int32 Slot : Batch)
+		{
+			Entries[Slot].Bot->ApplyDecision(Entries[Slot].Decision);
+			MaxLatencyMs = FMath::Max(MaxLatencyMs, (Now - Entries[Slot].RequestTime) * 1000.0);
+		}
+		Decisions += Batch.Num();
+		ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+	}
+	Queue.RemoveAt(0, Head, EAllowShrinking::No);
+
+	const bool bOverran = Decisions > 0 && ElapsedSeconds > BudgetSeconds;
+	if (bOverran)
+	{
+		INC_DWORD_STAT(STAT_Bomberman_BotBudgetOverruns);
+	}
+	SET_DWORD_STAT(STAT_Bomberman_BotDecisions, Decisions);
+	SET_DWORD_STAT(STAT_Bomberman_BotQueue, Queue.Num());
+	SET_FLOAT_STAT(STAT_Bomberman_BotLatencyMax, MaxLatencyMs);
+
+	CSV_CUSTOM_STAT(Bomberman, BotDecisions, Decisions, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Bomberman, BotQueue, Queue.Num(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Bomberman, BotLatencyMaxMs, float(MaxLatencyMs), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Bomberman, BotBudgetOverruns, bOverran ? 1 : 0, ECsvCustomStatOp::Set);
+}
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AI/BombermanFlowFieldSubsystem.h"
+
+#include "Engine/World.h"
+
+#include "Core/BombermanStats.h"
+#include "World/BombermanGridSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BombermanFlowFieldSubsystem)
+
+namespace
+{
+	// Cells a player can walk through
+	constexpr EGridCellFlags WalkStop = EGridCellFlags::Wall | EGridCellFlags::Block | EGridCellFlags::Bomb;
+}
+
+uint8 FGridFlowField::GetDownhillMask(const FBombermanGrid& Grid, FGridCoord Cell) const
+{
+	const uint16 Distance = GetDistance(Grid, Cell);
+	if (Distance == 0 || Distance == Unreachable) return 0;
+
+	uint8 Mask = 0;
+	for (int32 Dir = 0; Dir < 4; Dir++)
+	{
+		if (GetDistance(Grid, Cell + GridDirections[Dir]) < Distance)
+		{
+			Mask |= 1 << Dir;
+		}
+	}
+	return Mask;
+}
+
+void UBombermanFlowFieldSubsystem::Deinitialize()
+{
+	Fields.Empty();
+	Queue.Empty();
+
+	Super::Deinitialize();
+}
+
+const FGridFlowField* UBombermanFlowFieldSubsystem::GetFieldToCell(FGridCoord Goal)
+{
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid || !Grid->GetGrid().Contains(Goal)) return nullptr;
+
+	return FindOrBuild(Grid->GetGrid().ToIndex(Goal));
+}
+
+const FGridFlowField* UBombermanFlowFieldSubsystem::GetFieldToBlocks()
+{
+	return FindOrBuild(BlocksKey);
+}
+
+FGridFlowField* UBombermanFlowFieldSubsystem::FindOrBuild(int32 Key)
+{
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid || !Grid->GetGrid().IsValid()) return nullptr;
+
+	TUniquePtr<FGridFlowField>* Found = Fields.Find(Key);
+	FGridFlowField* Field			   = Found ? Found->Get() : nullptr;
+	if (!Field)
+	{
+		// Make room by dropping the field nobody asked for the longest, unless it was asked for this frame
+		if (Fields.Num() >= FMath::Max(1, MaxCachedFields))
+		{
+			int32 OldestKey		  = Fields.CreateConstIterator().Key();
+			uint64 OldestUsedFrame = MAX_uint64;
+			for (const TPair<int32, TUniquePtr<FGridFlowField>>& Pair : Fields)
+			{
+				if (Pair.Value->LastUsedFrame < OldestUsedFrame)
+				{
+					OldestKey		= Pair.Key;
+					OldestUsedFrame = Pair.Value->LastUsedFrame;
+				}
+			}
+			if (OldestUsedFrame != GFrameCounter)
+			{
+				Fields.Remove(OldestKey);
+			}
+		}
+
+		Field = Fields.Add(Key, MakeUnique<FGridFlowField>()).Get();
+		Build(Grid->GetGrid(), Key, *Field);
+	}
+	else if (Field->LayoutVersion != Grid->GetLayoutVersion() || Field->Distances.Num() != Grid->GetGrid().Num())
+	{
+		Build(Grid->GetGrid(), Key, *Field);
+	}
+
+	Field->LayoutVersion = Grid->GetLayoutVersion();
+	Field->LastUsedFrame = GFrameCounter;
+	return Field;
+}
+
+void UBombermanFlowFieldSubsystem::Build(const FBombermanGrid& Grid, int32 Key, FGridFlowField& Field)
+{
+	BOMBERMAN_SCOPE(FlowFieldBuild);
+
+	Field.Distances.Init(FGridFlowField::Unreachable, Grid.Num());
+	Queue.Reset(Grid.Num());
+
+	// Seeds: the goal itself, or every walkable cell a block can be bombed from
+	if (Key == BlocksKey)
+	{
+		for (int32 Index = 0; Index < Grid.Num(); Index++)
+		{
+			if (EnumHasAnyFlags(Grid.Cells[Index], WalkStop)) continue;
+
+			const FGridCoord Cell = Grid.ToCell(Index);
+			for (const FGridCoord& Dir : GridDirections)
+			{
+				if (Grid.HasAny(Cell + Dir, EGridCellFlags::Block))
+				{
+					Field.Distances[Index] = 0;
+					Queue.Add(Index);
+					break;
+				}
+			}
+		}
+	}
+	else if (Field.Distances.IsValidIndex(Key))
+	{
+		// A goal standing on its own bomb is still a goal
+		Field.Distances[Key] = 0;
+		Queue.Add(Key);
+	}
+
+	for (int32 Head = 0; Head < Queue.Num(); Head++)
+	{
+		const int32 Index	  = Queue[Head];
+		const FGridCoord Cell = Grid.ToCell(Index);
+		const uint16 Next	  = uint16(FMath::Min<int32>(Field.Distances[Index] + 1, FGridFlowField::Unreachable - 1));
+
+		for (const FGridCoord& Dir : GridDirections)
+		{
+			const FGridCoord Neighbor = Cell + Dir;
+			if (Grid.HasAny(Neighbor, WalkStop)) continue;
+
+			const int32 NeighborIndex = Grid.ToIndex(Neighbor);
+			if (Field.Distances[NeighborIndex] == FGridFlowField::Unreachable)
+			{
+				Field.Distances[NeighborIndex] = Next;
+				Queue.Add(NeighborIndex);
+			}
+		}
+	}
+}
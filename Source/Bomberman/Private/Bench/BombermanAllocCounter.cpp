@@ -0,0 +1,103 @@
+#include "Bench/BombermanAllocCounter.h"
+
+#include "HAL/MemoryBase.h"
+
+namespace
+{
+	thread_local uint64 ThreadAllocations = 0;
+
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		FMalloc* GetInner() const { return Inner; }
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			ThreadAllocations++;
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			ThreadAllocations++;
+			return Inner->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (IsGrowing(Original, Count)) ThreadAllocations++;
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (IsGrowing(Original, Count)) ThreadAllocations++;
+			return Inner->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void MarkTLSCachesAsUsedOnCurrentThread() override { Inner->MarkTLSCachesAsUsedOnCurrentThread(); }
+		virtual void MarkTLSCachesAsUnusedOnCurrentThread() override { Inner->MarkTLSCachesAsUnusedOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+		FMalloc* Inner;
+
+		// Shrinking or freeing through Realloc is not an allocation. A block of unknown size counts as growing.
+		bool IsGrowing(void* Original, SIZE_T Count) const
+		{
+			if (Count == 0) return false;
+
+			SIZE_T OldSize = 0;
+			return !Original || !Inner->GetAllocationSize(Original, OldSize) || Count > OldSize;
+		}
+	};
+
+	FCountingMalloc* CountingMalloc = nullptr;
+}
+
+void FBombermanAllocCounter::Install()
+{
+	check(IsInGameThread());
+	if (CountingMalloc) return;
+
+	CountingMalloc = new FCountingMalloc(GMalloc);
+	GMalloc		   = CountingMalloc;
+}
+
+void FBombermanAllocCounter::Uninstall()
+{
+	check(IsInGameThread());
+	if (!CountingMalloc || GMalloc != CountingMalloc) return;
+
+	// Blocks allocated through the proxy came from the inner allocator, freeing them there is fine.
+	// The proxy itself is leaked on purpose: other threads may still be inside one of its calls.
+	GMalloc		   = CountingMalloc->GetInner();
+	CountingMalloc = nullptr;
+}
+
+bool FBombermanAllocCounter::IsInstalled()
+{
+	return CountingMalloc != nullptr;
+}
+
+uint64 FBombermanAllocCounter::GetThreadAllocations()
+{
+	return ThreadAllocations;
+}
@@ -0,0 +1,392 @@
+#include "Bench/BombermanBenchmark.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/PlatformTime.h"
+#include "UObject/UObjectGlobals.h"
+
+#include "Core/ActorPoolSubsystem.h"
+#include "Core/BombermanLog.h"
+#include "Player/BombermanCharacter.h"
+#include "World/Bomb.h"
+#include "World/BombermanGridSubsystem.h"
+#include "World/ChainReactionSubsystem.h"
+#include "World/DestructibleBlock.h"
+
+namespace
+{
+	// Calls per sample for operations too short to time one by one
+	constexpr int32 CallsPerSample = 64;
+
+	// Long enough for every explosion of a blast to go back to its pool
+	constexpr float ExplosionSettleSeconds = 2.0f;
+
+	constexpr float SimDeltaSeconds = 1.0f / 60.0f;
+
+	// Unmeasured runs first, so scratch arrays and pools reach their steady size
+	constexpr int32 WarmupIterations = 8;
+}
+
+const TCHAR* FBombermanBenchmark::DefaultCharacterClassPath = TEXT("/Game/Blueprints/B_BombermanCharacter.B_BombermanCharacter_C");
+
+FBombermanBenchmark::FBombermanBenchmark(UClass* InCharacterClass, UClass* InBombClass, int32 InIterations)
+	: CharacterClass(InCharacterClass)
+	, BombClass(InBombClass)
+	, Iterations(FMath::Max(1, InIterations))
+{
+}
+
+bool FBombermanBenchmark::CreateWorld(int32 ArenaSize)
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("BombermanBenchmark"));
+	if (!World) return false;
+
+	FWorldContext& Context = GEngine->CreateNewWorldContext(EWorldType::Game);
+	Context.SetCurrentWorld(World);
+
+	// A game mode is what lets the world begin play
+	World->SetGameMode(FURL());
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	SpawnHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateLambda([this](AActor*) { SpawnCount++; }));
+
+	Grid  = World->GetSubsystem<UBombermanGridSubsystem>();
+	Chain = World->GetSubsystem<UChainReactionSubsystem>();
+	Pool  = World->GetSubsystem<UActorPoolSubsystem>();
+	if (!Grid || !Chain || !Pool) return false;
+
+	// Player starts in two corners give the grid its bounds
+	World->SpawnActor<APlayerStart>(APlayerStart::StaticClass(), FTransform(CellToWorld(FGridCoord(0, 0))));
+	World->SpawnActor<APlayerStart>(APlayerStart::StaticClass(), FTransform(CellToWorld(FGridCoord(ArenaSize - 1, ArenaSize - 1))));
+
+	Character = World->SpawnActor<ABombermanCharacter>(CharacterClass, FTransform(CellToWorld(FGridCoord(1, 1))));
+	if (!Character) return false;
+
+	// Stays where it is put, survives every blast and never runs out of bombs
+	Character->GetCharacterMovement()->DisableMovement();
+	Character->SetInvincibleForTest(true);
+	Character->SetMaxBombCountForTest(1024);
+
+	if (!BombClass)
+	{
+		BombClass = Character->GetBombClass();
+	}
+	return BombClass != nullptr;
+}
+
+void FBombermanBenchmark::DestroyWorld()
+{
+	if (!World) return;
+
+	World->RemoveOnActorSpawnedHandler(SpawnHandle);
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+
+	World	  = nullptr;
+	Character = nullptr;
+	Grid	  = nullptr;
+	Chain	  = nullptr;
+	Pool	  = nullptr;
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+void FBombermanBenchmark::Advance(float Seconds)
+{
+	for (float Time = 0.0f; Time < Seconds; Time += SimDeltaSeconds)
+	{
+		World->Tick(LEVELTICK_All, SimDeltaSeconds);
+	}
+}
+
+FVector FBombermanBenchmark::CellToWorld(FGridCoord Cell) const
+{
+	return Cell.ToWorld(Grid->GetCellSize(), 50.0f);
+}
+
+float FBombermanBenchmark::GetFuseSeconds() const
+{
+	return Cast<ABomb>(BombClass->GetDefaultObject())->GetDefaultExplosionTime();
+}
+
+void FBombermanBenchmark::SpawnBlock(FGridCoord Cell)
+{
+	const FTransform Transform(CellToWorld(Cell));
+	ADestructibleBlock* Block = World->SpawnActorDeferred<ADestructibleBlock>(ADestructibleBlock::StaticClass(), Transform);
+	if (!Block) return;
+
+	// The native block has no components, give it a root so the location sticks
+	USceneComponent* Root = NewObject<USceneComponent>(Block, TEXT("Root"));
+	Block->SetRootComponent(Root);
+	Root->RegisterComponent();
+
+	Block->FinishSpawning(Transform);
+}
+
+ABomb* FBombermanBenchmark::SpawnBomb(FGridCoord Cell, int32 Power)
+{
+	ABomb* Bomb = Pool->Acquire<ABomb>(BombClass, FTransform(CellToWorld(Cell)), Character);
+	if (Bomb)
+	{
+		Bomb->SetBombPower(Power);
+		Bomb->SetBombOwner(Character);
+	}
+	return Bomb;
+}
+
+FGridCoord FBombermanBenchmark::PickFreeCell(const TArray<FGridCoord>& FreeCells) const
+{
+	return FreeCells[Random.RandRange(0, FreeCells.Num() - 1)];
+}
+
+int32 FBombermanBenchmark::AddOp(const TCHAR* Scenario, const TCHAR* Operation, bool bRequireZeroAllocs)
+{
+	const int32 Index			 = Results.AddDefaulted();
+	FBombermanBenchmarkOp& Stats = Results[Index];
+	Stats.Scenario				 = Scenario;
+	Stats.Operation				 = Operation;
+	Stats.bRequireZeroAllocs	 = bRequireZeroAllocs;
+	Stats.Micros.Reserve(Iterations);
+	return Index;
+}
+
+bool FBombermanBenchmark::Run(const FString& Scenario)
+{
+	if (Scenario == TEXT("ChainGrid"))
+	{
+		RunChainGrid();
+		return true;
+	}
+
+	const bool bDense = Scenario == TEXT("Dense");
+	if (!bDense && Scenario != TEXT("Empty"))
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Unknown benchmark scenario: %s"), *Scenario);
+		return false;
+	}
+
+	constexpr int32 ArenaSize = 15;
+	if (!CreateWorld(ArenaSize))
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Could not set up the benchmark world"));
+		DestroyWorld();
+		return false;
+	}
+
+	// Dense: every other cell is a block, so blasts stop at or burn a block in most directions
+	TArray<FGridCoord> FreeCells;
+	for (int32 Y = 0; Y < ArenaSize; Y++)
+	{
+		for (int32 X = 0; X < ArenaSize; X++)
+		{
+			if (bDense && Random.RandRange(0, 99) < 50) SpawnBlock(FGridCoord(X, Y));
+			else FreeCells.Add(FGridCoord(X, Y));
+		}
+	}
+	Grid->RebuildFromWorld();
+
+	RunCommon(*Scenario, ArenaSize, FreeCells);
+	DestroyWorld();
+	return true;
+}
+
+void FBombermanBenchmark::RunCommon(const TCHAR* Scenario, int32 ArenaSize, const TArray<FGridCoord>& FreeCells)
+{
+	const int32 CanPlace	= AddOp(Scenario, TEXT("CanPlaceBombAt"), true);
+	const int32 PlaceBomb	= AddOp(Scenario, TEXT("PlaceBomb"));
+	const int32 FindBomb	= AddOp(Scenario, TEXT("FindNearbyBomb"), true);
+	const int32 BlastWalk	= AddOp(Scenario, TEXT("BlastWalk"), true);
+	const int32 BlastKernel = AddOp(Scenario, TEXT("BlastKernel"), true);
+	const int32 Detonation	= AddOp(Scenario, TEXT("Detonation"), true);
+
+	// Placement and lookup: the character stands on a free cell, places, then looks for a bomb to kick
+	TArray<FGridCoord> Cells;
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		Cells.Reset();
+		for (int32 Call = 0; Call < CallsPerSample; Call++)
+		{
+			Cells.Add(PickFreeCell(FreeCells));
+		}
+		Measure(CanPlace, CallsPerSample, [&]
+		{
+			for (const FGridCoord Cell : Cells)
+			{
+				Character->CanPlaceBombAtForTest(Cell);
+			}
+		});
+
+		Character->SetActorLocation(CellToWorld(PickFreeCell(FreeCells)));
+		Character->ResetBombCooldownForTest();
+		Measure(PlaceBomb, 1, [&] { Character->PlaceBomb(); });
+		Measure(FindBomb, 1, [&] { Character->FindNearbyBombForTest(); });
+
+		// Let a batch of placed bombs go off before the arena fills up
+		if (Character->GetBombCount() >= 16)
+		{
+			Advance(GetFuseSeconds() + ExplosionSettleSeconds);
+		}
+	}
+	Advance(GetFuseSeconds() + ExplosionSettleSeconds);
+
+	// Blast propagation on the grid alone
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		const FGridCoord Origin = PickFreeCell(FreeCells);
+		int32 Burned		   = 0;
+		Measure(BlastWalk, CallsPerSample, [&]
+		{
+			for (int32 Call = 0; Call < CallsPerSample; Call++)
+			{
+				Grid->GetGrid().ForEachBlastCell(Origin, 5, [&Burned](FGridCoord, int32, bool, EGridCellFlags) { Burned++; });
+			}
+		});
+	}
+
+	// One bomb of power 3: the kernel resolves its cells on the grid, the detonation takes its explosions
+	// from the pool, burns the cells and returns the bomb. Warmup iterations only size the scratch arrays;
+	// the explosion pool is filled up front, a blast in open space needs more cells than one by a wall.
+	if (UClass* ExplosionClass = Cast<ABomb>(BombClass->GetDefaultObject())->GetExplosionClass().Get())
+	{
+		Pool->Prewarm(ExplosionClass, 64);
+	}
+	for (int32 Iteration = -WarmupIterations; Iteration < Iterations; Iteration++)
+	{
+		ABomb* Bomb = SpawnBomb(PickFreeCell(FreeCells), 3);
+		if (!Bomb) continue;
+
+		if (Iteration < 0)
+		{
+			Bomb->Explode();
+			Chain->Tick(0.0f);
+		}
+		else
+		{
+			Measure(BlastKernel, 1, [&]
+			{
+				Bomb->Explode();
+				Chain->ResolveQueued();
+			});
+			Measure(Detonation, 1, [&] { Chain->Tick(0.0f); });
+		}
+		Advance(ExplosionSettleSeconds);
+	}
+}
+
+void FBombermanBenchmark::RunChainGrid()
+{
+	// Bombs on every odd cell of a 23 x 23 arena (121 bombs), power 2 reaches the next bomb in line
+	constexpr int32 ArenaSize = 23;
+	if (!CreateWorld(ArenaSize))
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Could not set up the benchmark world"));
+		DestroyWorld();
+		return;
+	}
+	Grid->RebuildFromWorld();
+
+	// Pool misses still show up as spawns once the pool cap is reached
+	UClass* ExplosionClass = Cast<ABomb>(BombClass->GetDefaultObject())->GetExplosionClass().Get();
+	Pool->Prewarm(BombClass, 128);
+	if (ExplosionClass) Pool->Prewarm(ExplosionClass, 512);
+
+	const int32 Resolve		= AddOp(TEXT("ChainGrid"), TEXT("ChainResolve"));
+	const int32 Propagation = AddOp(TEXT("ChainGrid"), TEXT("ChainPropagation"));
+
+	const int32 ChainIterations = FMath::Max(5, Iterations / 10);
+	TArray<ABomb*> Bombs;
+	for (int32 Iteration = 0; Iteration < ChainIterations; Iteration++)
+	{
+		Bombs.Reset();
+		for (int32 Y = 1; Y < ArenaSize; Y += 2)
+		{
+			for (int32 X = 1; X < ArenaSize; X += 2)
+			{
+				if (ABomb* Bomb = SpawnBomb(FGridCoord(X, Y), 2)) Bombs.Add(Bomb);
+			}
+		}
+		if (Bombs.Num() == 0) break;
+
+		// The whole chain is resolved in the first tick, the first bomb goes off right away
+		Measure(Resolve, 1, [&]
+		{
+			Bombs[0]->Explode();
+			Chain->Tick(0.0f);
+		});
+
+		// Chained bombs go off as their delays pass, world ticks included
+		Measure(Propagation, 1, [&]
+		{
+			for (int32 Tick = 0; Tick < 600 && Grid->GetBombs().Num() > 0; Tick++)
+			{
+				World->Tick(LEVELTICK_All, SimDeltaSeconds);
+			}
+		});
+		Advance(ExplosionSettleSeconds);
+	}
+
+	DestroyWorld();
+}
+
+void FBombermanBenchmark::LogSummary() const
+{
+	for (const FBombermanBenchmarkOp& Stats : Results)
+	{
+		TArray<double> Sorted = Stats.Micros;
+		Sorted.Sort();
+
+		const double Calls = FMath::Max<int64>(1, Stats.Calls);
+		UE_LOG(LogBomberman, Display, TEXT("%-10s %-24s p50 %9.2fus  p90 %9.2fus  p99 %9.2fus  allocs/op %7.2f  spawns/op %6.2f"),
+			*Stats.Scenario, *Stats.Operation, Stats.Percentile(Sorted, 0.5), Stats.Percentile(Sorted, 0.9), Stats.Percentile(Sorted, 0.99),
+			Stats.Allocations / Calls, Stats.Spawns / Calls);
+	}
+}
+
+bool FBombermanBenchmark::CheckAllocations() const
+{
+	bool bPassed = true;
+	for (const FBombermanBenchmarkOp& Stats : Results)
+	{
+		if (Stats.bRequireZeroAllocs && Stats.Allocations > 0)
+		{
+			UE_LOG(LogBomberman, Error, TEXT("%s %s must not allocate, made %llu heap allocations in %lld calls"), *Stats.Scenario, *Stats.Operation, Stats.Allocations, Stats.Calls);
+			bPassed = false;
+		}
+	}
+	return bPassed;
+}
+
+FString FBombermanBenchmark::ToJson() const
+{
+	FString Json = TEXT("{\n\t\"operations\": [\n");
+	for (int32 Index = 0; Index < Results.Num(); Index++)
+	{
+		const FBombermanBenchmarkOp& Stats = Results[Index];
+
+		TArray<double> Sorted = Stats.Micros;
+		Sorted.Sort();
+
+		double Total = 0.0;
+		for (const double Micros : Sorted)
+		{
+			Total += Micros;
+		}
+
+		const double Calls = FMath::Max<int64>(1, Stats.Calls);
+		Json += FString::Printf(TEXT("\t\t{\"scenario\": \"%s\", \"operation\": \"%s\", \"samples\": %d, \"calls\": %lld, ")
+									TEXT("\"meanUs\": %.3f, \"p50Us\": %.3f, \"p90Us\": %.3f, \"p99Us\": %.3f, \"maxUs\": %.3f, ")
+									TEXT("\"allocsPerOp\": %.3f, \"spawnsPerOp\": %.3f}%s\n"),
+			*Stats.Scenario, *Stats.Operation, Sorted.Num(), Stats.Calls,
+			Sorted.Num() > 0 ? Total / Sorted.Num() : 0.0, Stats.Percentile(Sorted, 0.5), Stats.Percentile(Sorted, 0.9), Stats.Percentile(Sorted, 0.99),
+			Sorted.Num() > 0 ? Sorted.Last() : 0.0, Stats.Allocations / Calls, Stats.Spawns / Calls, Index + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("\t]\n}\n");
+	return Json;
+}
+
+#endif
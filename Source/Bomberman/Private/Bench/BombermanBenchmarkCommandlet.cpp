@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Bench/BombermanBenchmarkCommandlet.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Bench/BombermanAllocCounter.h"
+#include "Bench/BombermanBenchmark.h"
+#include "Core/BombermanLog.h"
+#include "Player/BombermanCharacter.h"
+#include "World/Bomb.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BombermanBenchmarkCommandlet)
+
+UBombermanBenchmarkCommandlet::UBombermanBenchmarkCommandlet()
+{
+	IsClient	 = false;
+	IsServer	 = false;
+	IsEditor	 = false;
+	LogToConsole = true;
+}
+
+int32 UBombermanBenchmarkCommandlet::Main(const FString& Params)
+{
+#if WITH_DEV_AUTOMATION_TESTS
+	int32 Iterations = 200;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+
+	FString CharacterClassPath = FBombermanBenchmark::DefaultCharacterClassPath;
+	FString BombClassPath;
+	FParse::Value(*Params, TEXT("CharacterClass="), CharacterClassPath);
+	FParse::Value(*Params, TEXT("BombClass="), BombClassPath);
+
+	UClass* CharacterClass = LoadClass<ABombermanCharacter>(nullptr, *CharacterClassPath);
+	UClass* BombClass	   = BombClassPath.IsEmpty() ? nullptr : LoadClass<ABomb>(nullptr, *BombClassPath);
+	if (!CharacterClass || (!BombClassPath.IsEmpty() && !BombClass))
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Could not load the character or bomb class"));
+		return 1;
+	}
+
+	FString ScenarioList = TEXT("Empty,Dense,ChainGrid");
+	FParse::Value(*Params, TEXT("Scenarios="), ScenarioList, false);
+	TArray<FString> Scenarios;
+	ScenarioList.ParseIntoArray(Scenarios, TEXT(","));
+
+	FString OutPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks/Bomberman.json");
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+
+	FBombermanAllocCounter::Install();
+
+	FBombermanBenchmark Benchmark(CharacterClass, BombClass, Iterations);
+	bool bSucceeded = true;
+	for (const FString& Scenario : Scenarios)
+	{
+		bSucceeded &= Benchmark.Run(Scenario);
+	}
+
+	FBombermanAllocCounter::Uninstall();
+
+	Benchmark.LogSummary();
+	bSucceeded &= Benchmark.CheckAllocations();
+	if (!FFileHelper::SaveStringToFile(Benchmark.ToJson(), *OutPath))
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Could not write results to %s"), *OutPath);
+		return 1;
+	}
+	UE_LOG(LogBomberman, Display, TEXT("Results written to %s"), *OutPath);
+	return bSucceeded ? 0 : 1;
+#else
+	UE_LOG(LogBomberman, Error, TEXT("The benchmark needs a build with dev automation tests"));
+	return 1;
+#endif
+}
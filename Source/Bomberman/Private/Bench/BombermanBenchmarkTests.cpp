@@ -0,0 +1,54 @@
+#include "Bench/BombermanBenchmark.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Player/BombermanCharacter.h"
+
+// One test per scenario, run headless: -ExecCmds="Automation RunTests Bomberman.Benchmark" -nullrhi -unattended
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FBombermanBenchmarkTest, "Bomberman.Benchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FBombermanBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const TCHAR* Scenario : {TEXT("Empty"), TEXT("Dense"), TEXT("ChainGrid")})
+	{
+		OutBeautifiedNames.Add(Scenario);
+		OutTestCommands.Add(Scenario);
+	}
+}
+
+bool FBombermanBenchmarkTest::RunTest(const FString& Parameters)
+{
+	UClass* CharacterClass = LoadClass<ABombermanCharacter>(nullptr, FBombermanBenchmark::DefaultCharacterClassPath);
+	if (!TestNotNull(TEXT("Character class"), CharacterClass)) return false;
+
+	FBombermanAllocCounter::Install();
+
+	FBombermanBenchmark Benchmark(CharacterClass, nullptr, 100);
+	const bool bRan = Benchmark.Run(Parameters);
+
+	FBombermanAllocCounter::Uninstall();
+
+	if (!TestTrue(TEXT("Scenario ran"), bRan)) return false;
+
+	Benchmark.LogSummary();
+	for (const FBombermanBenchmarkOp& Op : Benchmark.GetResults())
+	{
+		TestTrue(FString::Printf(TEXT("%s was measured"), *Op.Operation), Op.Calls > 0);
+		if (Op.bRequireZeroAllocs)
+		{
+			TestEqual(FString::Printf(TEXT("%s heap allocations"), *Op.Operation), int64(Op.Allocations), int64(0));
+		}
+	}
+
+	// Same JSON as the commandlet, one file per scenario so CI can diff them against a baseline
+	const FString OutPath = FPaths::ProjectSavedDir() / FString::Printf(TEXT("Benchmarks/Bomberman_%s.json"), *Parameters);
+	TestTrue(TEXT("Results written"), FFileHelper::SaveStringToFile(Benchmark.ToJson(), *OutPath));
+	return true;
+}
+
+#endif
@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Core/ActorPoolSubsystem.h"
+
+#include "Engine/World.h"
+
+#include "Core/BombermanLog.h"
+#include "Core/BombermanStats.h"
+#include "Core/PoolableActor.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ActorPoolSubsystem)
+
+void UActorPoolSubsystem::Deinitialize()
+{
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+AActor* UActorPoolSubsystem::AcquireActor(UClass* Class, const FTransform& Transform, AActor* Owner)
+{
+	BOMBERMAN_SCOPE(PoolAcquire);
+
+	if (!Class) return nullptr;
+
+	FClassPool& Pool = Pools.FindOrAdd(Class);
+	Pool.Stats.Acquired++;
+
+	AActor* Actor = nullptr;
+	while (!Actor && Pool.Free.Num() > 0)
+	{
+		// Instances may have been destroyed behind our back (level teardown)
+		Actor = Pool.Free.Pop(EAllowShrinking::No).Get();
+	}
+	Pool.Stats.Pooled = Pool.Free.Num();
+
+	if (Actor)
+	{
+		Pool.Stats.Reused++;
+
+		Actor->SetOwner(Owner);
+		Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+		Cast<IPoolableActor>(Actor)->OnAcquiredFromPool();
+	}
+	else
+	{
+		Pool.Stats.Misses++;
+		Actor = SpawnPooledActor(Class, Transform, Owner, false);
+	}
+
+	if (Actor)
+	{
+		Pool.Stats.Active++;
+		Pool.Stats.PeakActive = FMath::Max(Pool.Stats.PeakActive, Pool.Stats.Active);
+	}
+	return Actor;
+}
+
+void UActorPoolSubsystem::Release(AActor* Actor)
+{
+	if (!IsValid(Actor)) return;
+
+	IPoolableActor* Poolable = Cast<IPoolableActor>(Actor);
+	if (!Poolable)
+	{
+		Actor->Destroy();
+		return;
+	}
+
+	// A second release would queue the instance twice and hand it out to two owners
+	if (Poolable->IsInPool())
+	{
+		UE_LOG(LogBomberman, Warning, TEXT("%s released to its pool twice, ignored"), *Actor->GetName());
+		return;
+	}
+
+	FClassPool& Pool = Pools.FindOrAdd(Actor->GetClass());
+	Pool.Stats.Released++;
+	Pool.Stats.Active = FMath::Max(0, Pool.Stats.Active - 1);
+
+	if (Pool.Free.Num() >= MaxPooledPerClass)
+	{
+		Pool.Stats.Discarded++;
+		Actor->Destroy();
+		return;
+	}
+
+	Poolable->OnReturnedToPool();
+	Pool.Free.Add(Actor);
+	Pool.Stats.Pooled = Pool.Free.Num();
+}
+
+void UActorPoolSubsystem::Prewarm(UClass* Class, int32 Count)
+{
+	if (!Class || !Class->ImplementsInterface(UPoolableActor::StaticClass())) return;
+
+	FClassPool& Pool   = Pools.FindOrAdd(Class);
+	const int32 Target = FMath::Min(Count < 0 ? PrewarmCount : Count, MaxPooledPerClass);
+
+	while (Pool.Free.Num() < Target)
+	{
+		AActor* Actor = SpawnPooledActor(Class, FTransform::Identity, nullptr, true);
+		if (!Actor) break;
+
+		Pool.Free.Add(Actor);
+	}
+	Pool.Stats.Pooled = Pool.Free.Num();
+
+	UE_LOG(LogBomberman, Log, TEXT("Pool prewarmed: %s x %d"), *Class->GetName(), Pool.Free.Num());
+}
+
+FActorPoolStats UActorPoolSubsystem::GetPoolStats(TSubclassOf<AActor> Class) const
+{
+	const FClassPool* Pool = Pools.Find(Class.Get());
+	return Pool ? Pool->Stats : FActorPoolStats();
+}
+
+AActor* UActorPoolSubsystem::SpawnPooledActor(UClass* Class, const FTransform& Transform, AActor* Owner, bool bStartInactive)
+{
+	UWorld* World = GetWorld();
+	if (!World) return nullptr;
+
+	AActor* Actor = World->SpawnActorDeferred<AActor>(Class, Transform, Owner, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+	if (!Actor) return nullptr;
+
+	INC_DWORD_STAT(STAT_Bomberman_PoolSpawns);
+	CSV_CUSTOM_STAT(Bomberman, PoolSpawns, 1, ECsvCustomStatOp::Accumulate);
+
+	// Deactivate before BeginPlay so pre-warmed instances never show up or tick their timers
+	if (bStartInactive)
+	{
+		if (IPoolableActor* Poolable = Cast<IPoolableActor>(Actor))
+		{
+			Poolable->OnReturnedToPool();
+		}
+	}
+
+	Actor->FinishSpawning(Transform);
+	return Actor;
+}
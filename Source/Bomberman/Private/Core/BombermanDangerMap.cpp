@@ -0,0 +1,302 @@
+#include "Core/BombermanDangerMap.h"
+
+#include "Core/BombermanStats.h"
+
+namespace
+{
+	// GridDirections come in opposite pairs: +X -X +Y -Y
+	constexpr int32 OppositeDirection(int32 Dir) { return Dir ^ 1; }
+
+	bool CompareFrontier(const TPair<int64, int32>& A, const TPair<int64, int32>& B) { return A.Key < B.Key; }
+}
+
+void FBombermanDangerMap::Reset(const FBombermanGrid& Grid)
+{
+	Bombs.Reset();
+	BombAtCell.Init(INDEX_NONE, Grid.Num());
+	BurnTicks.Init(Never, Grid.Num());
+	DirtyCellBits.Init(false, Grid.Num());
+	DirtyCells.Reset();
+	Seeds.Reset();
+	MaxRange = 0;
+}
+
+int32 FBombermanDangerMap::FindBomb(const FBombermanGrid& Grid, FGridCoord Cell) const
+{
+	return Grid.Contains(Cell) && BombAtCell.Num() == Grid.Num() ? BombAtCell[Grid.ToIndex(Cell)] : INDEX_NONE;
+}
+
+int64 FBombermanDangerMap::GetDetonateTick(const FBombermanGrid& Grid, FGridCoord Cell) const
+{
+	const int32 Slot = FindBomb(Grid, Cell);
+	return Slot != INDEX_NONE ? Bombs[Slot].DetonateTick : Never;
+}
+
+// ===== Changes =====
+
+void FBombermanDangerMap::AddBomb(const FBombermanGrid& Grid, FGridCoord Cell, int32 Range, int64 FuseTick, int32 ChainDelayTicks)
+{
+	if (!Grid.Contains(Cell) || BombAtCell.Num() != Grid.Num() || FindBomb(Grid, Cell) != INDEX_NONE) return;
+
+	const int32 Slot = Bombs.AddDefaulted();
+	FBomb& Bomb		 = Bombs[Slot];
+	Bomb.Cell			 = Cell;
+	Bomb.Range			 = FMath::Clamp(Range, 0, int32(MAX_uint8));
+	Bomb.ChainDelayTicks = FMath::Max(0, ChainDelayTicks);
+	Bomb.FuseTick		 = FuseTick;
+	BombAtCell[Grid.ToIndex(Cell)] = Slot;
+	MaxRange					   = FMath::Max(MaxRange, Bomb.Range);
+
+	// The new bomb cuts the blasts running through its cell
+	ReblockAround(Grid, Cell);
+
+	ComputeReach(Grid, Bombs[Slot]);
+	Seeds.Add(Slot);
+	Propagate(Grid);
+}
+
+void FBombermanDangerMap::RemoveBomb(const FBombermanGrid& Grid, FGridCoord Cell)
+{
+	const int32 Slot = FindBomb(Grid, Cell);
+	if (Slot == INDEX_NONE) return;
+
+	// Cells it reached lose it, bombs it chained into fall back to their own fuse
+	MarkFootprint(Grid, Bombs[Slot]);
+
+	BombAtCell[Grid.ToIndex(Cell)] = INDEX_NONE;
+	Bombs.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	if (Bombs.IsValidIndex(Slot))
+	{
+		BombAtCell[Grid.ToIndex(Bombs[Slot].Cell)] = Slot;
+	}
+
+	// Blasts that stopped on it run further now
+	ReblockAround(Grid, Cell);
+	Propagate(Grid);
+}
+
+void FBombermanDangerMap::MoveBomb(const FBombermanGrid& Grid, FGridCoord From, FGridCoord To)
+{
+	const int32 Slot = FindBomb(Grid, From);
+	if (Slot == INDEX_NONE) return;
+
+	// Bombs never share a cell
+	if (!Grid.Contains(To) || FindBomb(Grid, To) != INDEX_NONE)
+	{
+		RemoveBomb(Grid, From);
+		return;
+	}
+
+	MarkFootprint(Grid, Bombs[Slot]);
+
+	BombAtCell[Grid.ToIndex(From)] = INDEX_NONE;
+	BombAtCell[Grid.ToIndex(To)]   = Slot;
+	Bombs[Slot].Cell			   = To;
+
+	// Before the neighbours look at it, its old reach does not fit the new cell
+	ComputeReach(Grid, Bombs[Slot]);
+	Seeds.Add(Slot);
+
+	ReblockAround(Grid, From);
+	ReblockAround(Grid, To);
+	Propagate(Grid);
+}
+
+void FBombermanDangerMap::SetBombFuseTick(const FBombermanGrid& Grid, FGridCoord Cell, int64 FuseTick)
+{
+	const int32 Slot = FindBomb(Grid, Cell);
+	if (Slot == INDEX_NONE || Bombs[Slot].FuseTick == FuseTick) return;
+
+	Bombs[Slot].FuseTick = FuseTick;
+	Seeds.Add(Slot);
+	Propagate(Grid);
+}
+
+void FBombermanDangerMap::SetBombRange(const FBombermanGrid& Grid, FGridCoord Cell, int32 Range)
+{
+	const int32 Slot = FindBomb(Grid, Cell);
+	Range			 = FMath::Clamp(Range, 0, int32(MAX_uint8));
+	if (Slot == INDEX_NONE || Bombs[Slot].Range == Range) return;
+
+	MarkFootprint(Grid, Bombs[Slot]);
+
+	Bombs[Slot].Range = Range;
+	MaxRange		  = FMath::Max(MaxRange, Range);
+	ComputeReach(Grid, Bombs[Slot]);
+	Seeds.Add(Slot);
+	Propagate(Grid);
+}
+
+void FBombermanDangerMap::CellChanged(const FBombermanGrid& Grid, FGridCoord Cell)
+{
+	if (Bombs.Num() == 0 || !Grid.Contains(Cell)) return;
+
+	ReblockAround(Grid, Cell);
+	Propagate(Grid);
+}
+
+// ===== Propagation =====
+
+void FBombermanDangerMap::ComputeReach(const FBombermanGrid& Grid, FBomb& Bomb) const
+{
+	// Same walk as FBombermanGrid::ForEachBlastCell
+	for (int32 Dir = 0; Dir < 4; Dir++)
+	{
+		int32 Reach = 0;
+		for (int32 Distance = 1; Distance <= Bomb.Range; Distance++)
+		{
+			const EGridCellFlags Flags = Grid.Get(Bomb.Cell + GridDirections[Dir] * Distance);
+			if (EnumHasAnyFlags(Flags, EGridCellFlags::Wall)) break;
+
+			Reach = Distance;
+			if (EnumHasAnyFlags(Flags, EGridCellFlags::BlastStop)) break;
+		}
+		Bomb.Reach[Dir] = uint8(Reach);
+	}
+}
+
+template <typename FVisitor>
+void FBombermanDangerMap::ForEachFootprintCell(const FBombermanGrid& Grid, const FBomb& Bomb, FVisitor&& Visit) const
+{
+	Visit(Grid.ToIndex(Bomb.Cell), 0);
+
+	for (int32 Dir = 0; Dir < 4; Dir++)
+	{
+		for (int32 Distance = 1; Distance <= Bomb.Reach[Dir]; Distance++)
+		{
+			Visit(Grid.ToIndex(Bomb.Cell + GridDirections[Dir] * Distance), Distance);
+		}
+	}
+}
+
+template <typename FVisitor>
+void FBombermanDangerMap::ForEachCoveringBomb(const FBombermanGrid& Grid, FGridCoord Cell, FVisitor&& Visit) const
+{
+	if (BombAtCell[Grid.ToIndex(Cell)] != INDEX_NONE)
+	{
+		Visit(BombAtCell[Grid.ToIndex(Cell)]);
+	}
+
+	// Walk away from the cell until something would stop a blast coming back towards it
+	for (int32 Dir = 0; Dir < 4; Dir++)
+	{
+		for (int32 Distance = 1; Distance <= MaxRange; Distance++)
+		{
+			const FGridCoord Other = Cell + GridDirections[Dir] * Distance;
+			if (!Grid.Contains(Other)) break;
+
+			const int32 Slot = BombAtCell[Grid.ToIndex(Other)];
+			if (Slot != INDEX_NONE && Bombs[Slot].Reach[OppositeDirection(Dir)] >= Distance)
+			{
+				Visit(Slot);
+			}
+
+			if (Grid.HasAny(Other, EGridCellFlags::Wall | EGridCellFlags::BlastStop)) break;
+		}
+	}
+}
+
+void FBombermanDangerMap::MarkFootprint(const FBombermanGrid& Grid, const FBomb& Bomb)
+{
+	ForEachFootprintCell(Grid, Bomb, [this](int32 CellIndex, int32)
+	{
+		if (!DirtyCellBits[CellIndex])
+		{
+			DirtyCellBits[CellIndex] = true;
+			DirtyCells.Add(CellIndex);
+		}
+	});
+}
+
+void FBombermanDangerMap::ReblockAround(const FBombermanGrid& Grid, FGridCoord Cell)
+{
+	// Stored reach still describes the blasts before the change, which is what reaches Cell
+	ForEachCoveringBomb(Grid, Cell, [this, &Grid](int32 Slot)
+	{
+		MarkFootprint(Grid, Bombs[Slot]);
+		ComputeReach(Grid, Bombs[Slot]);
+		Seeds.Add(Slot);
+	});
+}
+
+void FBombermanDangerMap::Propagate(const FBombermanGrid& Grid)
+{
+	BOMBERMAN_SCOPE(DangerUpdate);
+
+	// Bombs a changed blast reached (or used to) may go off at another time now
+	for (int32 CellIndex : DirtyCells)
+	{
+		if (BombAtCell[CellIndex] != INDEX_NONE) Seeds.Add(BombAtCell[CellIndex]);
+	}
+
+	// Everything chained with the seeds, in either direction
+	Component.Reset();
+	InComponent.Init(false, Bombs.Num());
+	auto AddToComponent = [this](int32 Slot)
+	{
+		if (!InComponent[Slot])
+		{
+			InComponent[Slot] = true;
+			Component.Add(Slot);
+		}
+	};
+	for (int32 Slot : Seeds)
+	{
+		AddToComponent(Slot);
+	}
+	for (int32 Head = 0; Head < Component.Num(); Head++)
+	{
+		const FBomb& Bomb = Bombs[Component[Head]];
+		ForEachFootprintCell(Grid, Bomb, [this, &AddToComponent](int32 CellIndex, int32)
+		{
+			if (BombAtCell[CellIndex] != INDEX_NONE) AddToComponent(BombAtCell[CellIndex]);
+		});
+		ForEachCoveringBomb(Grid, Bomb.Cell, AddToComponent);
+	}
+
+	// Earliest detonation first, a chained bomb goes off its chain delay after the blast reaching it
+	Frontier.Reset();
+	for (int32 Slot : Component)
+	{
+		Bombs[Slot].DetonateTick = Bombs[Slot].FuseTick;
+		if (Bombs[Slot].FuseTick != Never) Frontier.HeapPush({Bombs[Slot].FuseTick, Slot}, CompareFrontier);
+	}
+	while (Frontier.Num() > 0)
+	{
+		TPair<int64, int32> Entry;
+		Frontier.HeapPop(Entry, CompareFrontier, EAllowShrinking::No);
+
+		const FBomb& Bomb = Bombs[Entry.Value];
+		if (Entry.Key != Bomb.DetonateTick) continue;
+
+		const int64 ChainTick = Bomb.DetonateTick + Bomb.ChainDelayTicks;
+		ForEachFootprintCell(Grid, Bomb, [this, ChainTick](int32 CellIndex, int32 Distance)
+		{
+			const int32 Slot = BombAtCell[CellIndex];
+			if (Distance > 0 && Slot != INDEX_NONE && ChainTick < Bombs[Slot].DetonateTick)
+			{
+				Bombs[Slot].DetonateTick = ChainTick;
+				Frontier.HeapPush({ChainTick, Slot}, CompareFrontier);
+			}
+		});
+	}
+
+	for (int32 Slot : Component)
+	{
+		MarkFootprint(Grid, Bombs[Slot]);
+	}
+
+	// Only the cells whose covering bombs changed
+	for (int32 CellIndex : DirtyCells)
+	{
+		int64 BurnTick = Never;
+		ForEachCoveringBomb(Grid, Grid.ToCell(CellIndex), [this, &BurnTick](int32 Slot)
+		{
+			BurnTick = FMath::Min(BurnTick, Bombs[Slot].DetonateTick);
+		});
+		BurnTicks[CellIndex]	 = BurnTick;
+		DirtyCellBits[CellIndex] = false;
+	}
+	DirtyCells.Reset();
+	Seeds.Reset();
+}
@@ -1,11 +1,19 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Core/BombermanGameMode.h"
+
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+
+#include "Core/BombermanGameState.h"
+#include "Core/BombermanLog.h"
 #include "Player/BombermanController.h"
 #include "Player/BombermanState.h"
+#include "World/BombermanGridSubsystem.h"
 
 ABombermanGameMode::ABombermanGameMode()
 {
+	GameStateClass = ABombermanGameState::StaticClass();
 	NextPlayerID = 0;
 }
 
@@ -21,6 +29,31 @@ void ABombermanGameMode::RespawnPlayer(APlayerController* Player)
 {
 }
 
+AActor* ABombermanGameMode::ChoosePlayerStart_Implementation(AController* Player)
+{
+	AActor* DefaultStart = Super::ChoosePlayerStart_Implementation(Player);
+
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid || !DefaultStart || Grid->GetBurnTick(Grid->WorldToCell(DefaultStart->GetActorLocation())) == FBombermanDangerMap::Never)
+	{
+		return DefaultStart;
+	}
+
+	// The default start is about to burn, take the one a blast reaches last (if at all)
+	AActor* BestStart  = DefaultStart;
+	int64 BestBurnTick = Grid->GetBurnTick(Grid->WorldToCell(DefaultStart->GetActorLocation()));
+	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	{
+		const int64 BurnTick = Grid->GetBurnTick(Grid->WorldToCell(It->GetActorLocation()));
+		if (BurnTick > BestBurnTick)
+		{
+			BestStart	 = *It;
+			BestBurnTick = BurnTick;
+		}
+	}
+	return BestStart;
+}
+
 void ABombermanGameMode::PostLogin(APlayerController* NewPlayer)
 {
 	Super::PostLogin(NewPlayer);
@@ -31,5 +64,5 @@ void ABombermanGameMode::PostLogin(APlayerController* NewPlayer)
 		NewPS->SetPlayerID(NextPlayerID++); // Increment the id for the next player
 	}
 
-    UE_LOG(LogTemp, Log, TEXT("PostLogin at: %s, NewPlayerID: %d"), *NewPlayer->GetName(), NextPlayerID-1);
+    UE_LOG(LogBomberman, Log, TEXT("PostLogin at: %s, NewPlayerID: %d"), *NewPlayer->GetName(), NextPlayerID-1);
 }
\ No newline at end of file
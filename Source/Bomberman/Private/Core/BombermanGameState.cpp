@@ -0,0 +1,13 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Core/BombermanGameState.h"
+
+#include "Net/BombermanGridStateComponent.h"
+
+ABombermanGameState::ABombermanGameState()
+{
+	GridState = CreateDefaultSubobject<UBombermanGridStateComponent>(TEXT("GridState"));
+
+	// Grid events are pushed with ForceNetUpdate, this only bounds the idle rate
+	SetNetUpdateFrequency(30.0f);
+}
@@ -0,0 +1,3 @@
+#include "Core/BombermanLog.h"
+
+DEFINE_LOG_CATEGORY(LogBomberman);
@@ -0,0 +1,41 @@
+#include "Core/BombermanStats.h"
+
+DEFINE_STAT(STAT_Bomberman_PlaceBomb);
+DEFINE_STAT(STAT_Bomberman_KickSweep);
+DEFINE_STAT(STAT_Bomberman_ChainResolve);
+DEFINE_STAT(STAT_Bomberman_ChainDetonate);
+DEFINE_STAT(STAT_Bomberman_CreateExplosion);
+DEFINE_STAT(STAT_Bomberman_ExplosionEvents);
+DEFINE_STAT(STAT_Bomberman_BlastDamage);
+DEFINE_STAT(STAT_Bomberman_PoolAcquire);
+DEFINE_STAT(STAT_Bomberman_ReplayRecord);
+DEFINE_STAT(STAT_Bomberman_DangerUpdate);
+DEFINE_STAT(STAT_Bomberman_FlowFieldBuild);
+DEFINE_STAT(STAT_Bomberman_BotThink);
+DEFINE_STAT(STAT_Bomberman_BotSchedule);
+
+DEFINE_STAT(STAT_Bomberman_ActiveBombs);
+DEFINE_STAT(STAT_Bomberman_ExplosionCells);
+DEFINE_STAT(STAT_Bomberman_PoolSpawns);
+DEFINE_STAT(STAT_Bomberman_BotDecisions);
+DEFINE_STAT(STAT_Bomberman_BotQueue);
+DEFINE_STAT(STAT_Bomberman_BotLatencyMax);
+DEFINE_STAT(STAT_Bomberman_BotBudgetOverruns);
+
+UE_TRACE_CHANNEL_DEFINE(BombermanChannel);
+
+CSV_DEFINE_CATEGORY_MODULE(BOMBERMAN_API, Bomberman, true);
+
+namespace BombermanStats
+{
+	int32 LiveExplosionCells = 0;
+
+	void ReportGauges(int32 ActiveBombs)
+	{
+		SET_DWORD_STAT(STAT_Bomberman_ActiveBombs, ActiveBombs);
+		SET_DWORD_STAT(STAT_Bomberman_ExplosionCells, LiveExplosionCells);
+
+		CSV_CUSTOM_STAT(Bomberman, ActiveBombs, ActiveBombs, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(Bomberman, ExplosionCells, LiveExplosionCells, ECsvCustomStatOp::Set);
+	}
+}
@@ -0,0 +1,551 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Net/BombermanGridStateComponent.h"
+
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "Net/UnrealNetwork.h"
+
+#include "Core/ActorPoolSubsystem.h"
+#include "Core/BombermanGameState.h"
+#include "Core/BombermanLog.h"
+#include "Player/BombermanCharacter.h"
+#include "Player/BombermanState.h"
+#include "World/Bomb.h"
+#include "World/BombUpdateSubsystem.h"
+#include "World/BombermanGridSubsystem.h"
+#include "World/ChainReactionSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BombermanGridStateComponent)
+
+namespace
+{
+	// Late joiners receive the whole array, blasts that are long over are not replayed
+	constexpr int32 StaleBurnMs = 1000;
+
+	int32 ToTimeMs(double Seconds) { return int32(Seconds * 1000.0); }
+}
+
+void FGridEvent::PostReplicatedAdd(const FGridEventArray& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->ApplyEvent(*this);
+	}
+}
+
+bool FGridEvent::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << CellIndex;
+	Ar << Type;
+	Ar << Param;
+	Ar << BombId;
+	if (Type == EGridEventType::BombPlaced)
+	{
+		Ar << OwnerSeat;
+		Ar << PredictionKey;
+	}
+
+	// Milliseconds since the match started fit in 3 bytes for hours
+	uint32 PackedTime = uint32(FMath::Max(0, TimeMs));
+	Ar.SerializeIntPacked(PackedTime);
+	TimeMs = int32(PackedTime);
+
+	bOutSuccess = true;
+	return true;
+}
+
+UBombermanGridStateComponent::UBombermanGridStateComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	SetIsReplicatedByDefault(true);
+}
+
+UBombermanGridStateComponent* UBombermanGridStateComponent::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!World) return nullptr;
+
+	if (const ABombermanGameState* GameState = World->GetGameState<ABombermanGameState>())
+	{
+		return GameState->GetGridState();
+	}
+	return nullptr;
+}
+
+void UBombermanGridStateComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ThisClass, Events);
+	DOREPLIFETIME(ThisClass, CellZ);
+	DOREPLIFETIME(ThisClass, BombClass);
+}
+
+void UBombermanGridStateComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Events.Owner = this;
+
+	if (IsServer())
+	{
+		if (UChainReactionSubsystem* Chain = GetWorld()->GetSubsystem<UChainReactionSubsystem>())
+		{
+			ChainResolvedHandle = Chain->OnChainReactionResolved.AddUObject(this, &ThisClass::RecordChain);
+		}
+	}
+}
+
+void UBombermanGridStateComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UChainReactionSubsystem* Chain = GetWorld()->GetSubsystem<UChainReactionSubsystem>())
+	{
+		Chain->OnChainReactionResolved.Remove(ChainResolvedHandle);
+	}
+	ProxyBombs.Empty();
+	PendingBurns.Empty();
+	PredictedBombs.Empty();
+	PredictedKicks.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UBombermanGridStateComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (IsServer())
+	{
+		PruneEvents(GetWorld()->GetTimeSeconds());
+		return;
+	}
+
+	if (PendingBurns.Num() > 0)
+	{
+		BurnDueCells(GetServerTime());
+	}
+	if (PredictedBombs.Num() > 0 || PredictedKicks.Num() > 0)
+	{
+		ExpirePredictions(GetWorld()->GetTimeSeconds());
+	}
+}
+
+double UBombermanGridStateComponent::GetServerTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+uint8 UBombermanGridStateComponent::GetOwnerSeat(const ABombermanCharacter* Player)
+{
+	const ABombermanState* State = Player ? Player->GetPlayerState<ABombermanState>() : nullptr;
+	return State && State->GetPlayerID() >= 0 ? uint8(State->GetPlayerID() + 1) : 0;
+}
+
+bool UBombermanGridStateComponent::IsServer() const
+{
+	// Nothing to replicate in a standalone game
+	return GetOwner() && GetOwner()->HasAuthority() && GetNetMode() != NM_Standalone;
+}
+
+// =================== Server =================================
+
+FGridEvent* UBombermanGridStateComponent::AddEvent(EGridEventType Type, FGridCoord Cell, uint16 BombId, uint8 Param, double Time)
+{
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid || !Grid->GetGrid().Contains(Cell)) return nullptr;
+
+	FGridEvent& Event = Events.Items.AddDefaulted_GetRef();
+	Event.CellIndex	  = uint16(Grid->GetGrid().ToIndex(Cell));
+	Event.Type		  = Type;
+	Event.Param		  = Param;
+	Event.BombId	  = BombId;
+	Event.TimeMs	  = ToTimeMs(Time);
+	Event.RecordTime  = GetWorld()->GetTimeSeconds();
+	Events.MarkItemDirty(Event);
+	return &Event;
+}
+
+void UBombermanGridStateComponent::RecordBombPlaced(ABomb* Bomb, uint8 PredictionKey)
+{
+	if (!Bomb || !IsServer()) return;
+
+	// 0 is left for bombs the clients do not know about
+	Bomb->NetId = NextBombId;
+	NextBombId	= NextBombId == MAX_uint16 ? 1 : NextBombId + 1;
+
+	CellZ	  = Bomb->GetActorLocation().Z;
+	BombClass = Bomb->GetClass();
+
+	const UBombUpdateSubsystem* Updates = GetWorld()->GetSubsystem<UBombUpdateSubsystem>();
+	const double FuseEnd				= GetWorld()->GetTimeSeconds() + (Updates ? Updates->GetFuseRemaining(Bomb) : 0.0f);
+
+	if (FGridEvent* Event = AddEvent(EGridEventType::BombPlaced, Bomb->GetGridCell(), Bomb->NetId, uint8(FMath::Clamp(Bomb->GetBombPower(), 0, MAX_uint8)), FuseEnd))
+	{
+		Event->OwnerSeat	 = GetOwnerSeat(Bomb->GetBombOwner());
+		Event->PredictionKey = PredictionKey;
+	}
+	GetOwner()->ForceNetUpdate();
+}
+
+void UBombermanGridStateComponent::RecordBombKicked(const ABomb* Bomb, int32 Dir)
+{
+	if (!Bomb || Dir == INDEX_NONE || !IsServer()) return;
+
+	AddEvent(EGridEventType::BombKicked, Bomb->GetGridCell(), Bomb->NetId, uint8(Dir), GetWorld()->GetTimeSeconds());
+	GetOwner()->ForceNetUpdate();
+}
+
+void UBombermanGridStateComponent::RecordBombStopped(const ABomb* Bomb)
+{
+	if (!Bomb || !IsServer()) return;
+
+	AddEvent(EGridEventType::BombStopped, Bomb->GetGridCell(), Bomb->NetId, 0, GetWorld()->GetTimeSeconds());
+	GetOwner()->ForceNetUpdate();
+}
+
+void UBombermanGridStateComponent::RecordChain(const FChainReactionResult& Result)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// Burn times are absolute, clients hold the cells back until the server clock reaches them
+	for (const FChainBomb& ChainBomb : Result.Bombs)
+	{
+		const ABomb* Bomb	= ChainBomb.Bomb.Get();
+		const uint16 BombId = Bomb ? Bomb->NetId : 0;
+		const double Time	= Now + ChainBomb.Delay;
+
+		AddEvent(EGridEventType::BombDetonated, ChainBomb.Cell, BombId, 0, Time);
+		for (int32 Index = ChainBomb.FirstCell; Index < ChainBomb.FirstCell + ChainBomb.NumCells; Index++)
+		{
+			const FBlastCell& Cell = Result.Cells[Index];
+			AddEvent(EGridEventType::CellBurned, Cell.Cell, BombId, uint8(Cell.Type), Time);
+		}
+	}
+	GetOwner()->ForceNetUpdate();
+}
+
+void UBombermanGridStateComponent::PruneEvents(double Now)
+{
+	// Events are appended in time order, the expired ones are all at the front
+	int32 NumExpired = 0;
+	while (NumExpired < Events.Items.Num() && Events.Items[NumExpired].RecordTime + EventLifetime < Now)
+	{
+		NumExpired++;
+	}
+	if (NumExpired == 0) return;
+
+	Events.Items.RemoveAt(0, NumExpired, EAllowShrinking::No);
+	Events.MarkArrayDirty();
+}
+
+// =================== Client =================================
+
+ABomb* UBombermanGridStateComponent::FindProxyBomb(uint16 BombId) const
+{
+	const FProxyBomb* Proxy = ProxyBombs.Find(BombId);
+	return Proxy ? Proxy->Bomb.Get() : nullptr;
+}
+
+void UBombermanGridStateComponent::ApplyEvent(const FGridEvent& Event)
+{
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid || Event.CellIndex >= Grid->GetGrid().Num()) return;
+
+	const FGridCoord Cell = Grid->GetGrid().ToCell(Event.CellIndex);
+
+	switch (Event.Type)
+	{
+		case EGridEventType::BombPlaced:
+		{
+			// Our own prediction becomes the bomb, anything else is spawned now
+			ABomb* Bomb = AdoptPredictedBomb(Event);
+			if (!Bomb) Bomb = SpawnProxyBomb(GetProxyBombClass(nullptr), Cell, Event.Param);
+			if (!Bomb) break;
+
+			// Rolled back onto the server's cell if the prediction was off
+			if (Bomb->GetGridCell() != Cell) Bomb->SnapToCell(Cell);
+
+			// Fuse only drives the visuals, clients never detonate on their own
+			Bomb->NetId = Event.BombId;
+			Bomb->SetBombPower(Event.Param);
+			Bomb->StartTimer(FMath::Max(0.0f, float(Event.TimeMs / 1000.0 - GetServerTime())));
+			ProxyBombs.Add(Event.BombId, {Bomb, Event.OwnerSeat});
+			break;
+		}
+
+		case EGridEventType::BombKicked:
+			if (ABomb* Bomb = FindProxyBomb(Event.BombId))
+			{
+				const int32 KickIndex = PredictedKicks.IndexOfByPredicate([&Event](const FPredictedKick& Kick) { return Kick.BombId == Event.BombId; });
+				if (KickIndex != INDEX_NONE)
+				{
+					const FPredictedKick Kick = PredictedKicks[KickIndex];
+					PredictedKicks.RemoveAtSwap(KickIndex, 1, EAllowShrinking::No);
+
+					// Prediction held, the bomb is already on its way
+					if (Kick.StartCell == Cell && Kick.Dir == Event.Param) break;
+				}
+				ReplayKick(Bomb, Event, Cell);
+			}
+			break;
+
+		case EGridEventType::BombStopped:
+			if (ABomb* Bomb = FindProxyBomb(Event.BombId))
+			{
+				Bomb->StopKick();
+				Bomb->SnapToCell(Cell);
+			}
+			break;
+
+		case EGridEventType::BombDetonated:
+		case EGridEventType::CellBurned:
+			PendingBurns.Add(Event);
+			break;
+	}
+
+	UE_LOG(LogBomberman, Verbose, TEXT("Grid event %d at %s, bomb %d"), int32(Event.Type), *Cell.ToString(), Event.BombId);
+}
+
+UClass* UBombermanGridStateComponent::GetProxyBombClass(const ABombermanCharacter* Placer) const
+{
+	if (Placer && Placer->GetBombClass()) return Placer->GetBombClass();
+	if (BombClass) return BombClass;
+
+	const APlayerController* LocalController = GetWorld()->GetFirstPlayerController();
+	const ABombermanCharacter* LocalPlayer	 = LocalController ? Cast<ABombermanCharacter>(LocalController->GetPawn()) : nullptr;
+	return LocalPlayer ? LocalPlayer->GetBombClass().Get() : nullptr;
+}
+
+ABomb* UBombermanGridStateComponent::SpawnProxyBomb(UClass* Class, FGridCoord Cell, int32 Power)
+{
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	UActorPoolSubsystem* Pool			= GetWorld()->GetSubsystem<UActorPoolSubsystem>();
+	if (!Grid || !Pool) return nullptr;
+
+	if (!Class)
+	{
+		UE_LOG(LogBomberman, Error, TEXT("No bomb class known yet, cannot show a replicated bomb"));
+		return nullptr;
+	}
+
+	ABomb* Bomb = Pool->Acquire<ABomb>(Class, FTransform(Grid->CellToWorld(Cell, CellZ)), nullptr);
+	if (Bomb)
+	{
+		Bomb->SetBombPower(Power);
+	}
+	return Bomb;
+}
+
+ABomb* UBombermanGridStateComponent::AdoptPredictedBomb(const FGridEvent& Event)
+{
+	if (Event.OwnerSeat == 0 || Event.PredictionKey == 0) return nullptr;
+
+	const int32 Index = PredictedBombs.IndexOfByPredicate([&Event](const FPredictedBomb& Predicted)
+	{
+		return Predicted.Key == Event.PredictionKey && Predicted.OwnerSeat == Event.OwnerSeat;
+	});
+	if (Index == INDEX_NONE) return nullptr;
+
+	ABomb* Bomb = PredictedBombs[Index].Bomb.Get();
+	PredictedBombs.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	return Bomb;
+}
+
+void UBombermanGridStateComponent::ReplayKick(ABomb* Bomb, const FGridEvent& Event, FGridCoord Cell)
+{
+	if (Event.Param >= UE_ARRAY_COUNT(GridDirections)) return;
+
+	// Start over from the server's cell and catch up on the time the event spent in flight
+	Bomb->StopKick();
+	Bomb->SnapToCell(Cell);
+
+	const FGridCoord Dir = GridDirections[Event.Param];
+	Bomb->StartKick(FVector(Dir.X, Dir.Y, 0.0f), nullptr);
+
+	if (UBombUpdateSubsystem* Updates = GetWorld()->GetSubsystem<UBombUpdateSubsystem>())
+	{
+		Updates->AdvanceKick(Bomb, FMath::Max(0.0f, float(GetServerTime() - Event.TimeMs / 1000.0)));
+	}
+}
+
+// =================== Client prediction =================================
+
+uint8 UBombermanGridStateComponent::PredictBombPlaced(ABombermanCharacter* Player, FGridCoord Cell, int32 Power)
+{
+	const uint8 OwnerSeat = GetOwnerSeat(Player);
+	if (OwnerSeat == 0) return 0;
+
+	ABomb* Bomb = SpawnProxyBomb(GetProxyBombClass(Player), Cell, Power);
+	if (!Bomb) return 0;
+
+	// The owner stands on its bomb until it walks off, like on the server
+	Bomb->SetBombOwner(Player);
+	Bomb->DisableOwnerCollision();
+
+	const uint8 Key	  = NextPredictionKey;
+	NextPredictionKey = NextPredictionKey == MAX_uint8 ? 1 : NextPredictionKey + 1;
+
+	PredictedBombs.Add({Key, OwnerSeat, Bomb, GetWorld()->GetTimeSeconds()});
+	return Key;
+}
+
+void UBombermanGridStateComponent::RejectBombPrediction(uint8 Key)
+{
+	const int32 Index = PredictedBombs.IndexOfByPredicate([Key](const FPredictedBomb& Predicted) { return Predicted.Key == Key; });
+	if (Index == INDEX_NONE) return;
+
+	ABomb* Bomb = PredictedBombs[Index].Bomb.Get();
+	PredictedBombs.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
+	if (Bomb && Pool) Pool->Release(Bomb);
+
+	UE_LOG(LogBomberman, Verbose, TEXT("Predicted bomb %d rolled back"), Key);
+}
+
+uint16 UBombermanGridStateComponent::PredictKick(ABomb* Bomb, const FVector& Direction, ABombermanCharacter* Kicker)
+{
+	// Bombs the server has not confirmed yet have no id to reconcile against
+	const int32 Dir = GridDirectionFromVector(Direction);
+	if (!Bomb || Bomb->NetId == 0 || Dir == INDEX_NONE || !Bomb->CanBeKicked()) return 0;
+
+	PredictedKicks.Add({Bomb->NetId, Bomb->GetGridCell(), uint8(Dir), GetWorld()->GetTimeSeconds()});
+	Bomb->StartKick(Direction, Kicker);
+	return Bomb->NetId;
+}
+
+void UBombermanGridStateComponent::RejectKickPrediction(uint16 BombId)
+{
+	const int32 Index = PredictedKicks.IndexOfByPredicate([BombId](const FPredictedKick& Kick) { return Kick.BombId == BombId; });
+	if (Index == INDEX_NONE) return;
+
+	const FGridCoord StartCell = PredictedKicks[Index].StartCell;
+	PredictedKicks.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	if (ABomb* Bomb = FindProxyBomb(BombId))
+	{
+		Bomb->StopKick();
+		Bomb->SnapToCell(StartCell);
+	}
+
+	UE_LOG(LogBomberman, Verbose, TEXT("Predicted kick of bomb %d rolled back"), BombId);
+}
+
+int32 UBombermanGridStateComponent::CountLocalBombs(const ABombermanCharacter* Player) const
+{
+	const uint8 OwnerSeat = GetOwnerSeat(Player);
+	if (OwnerSeat == 0) return 0;
+
+	int32 Count = 0;
+	for (const FPredictedBomb& Predicted : PredictedBombs)
+	{
+		if (Predicted.OwnerSeat == OwnerSeat && Predicted.Bomb.IsValid()) Count++;
+	}
+
+	// Confirmed bombs stay counted until their burn plays here, the server frees the slot no later than that
+	for (const TPair<uint16, FProxyBomb>& Pair : ProxyBombs)
+	{
+		const ABomb* Bomb = Pair.Value.Bomb.Get();
+		if (Pair.Value.OwnerSeat == OwnerSeat && Bomb && !Bomb->IsInPool() && !Bomb->IsExploding()) Count++;
+	}
+	return Count;
+}
+
+void UBombermanGridStateComponent::ExpirePredictions(double Now)
+{
+	// Unanswered for too long: treat as rejected rather than leave a bomb the server never placed
+	for (int32 Index = PredictedBombs.Num() - 1; Index >= 0; Index--)
+	{
+		if (PredictedBombs[Index].Time + PredictionTimeout < Now) RejectBombPrediction(PredictedBombs[Index].Key);
+	}
+	for (int32 Index = PredictedKicks.Num() - 1; Index >= 0; Index--)
+	{
+		if (PredictedKicks[Index].Time + PredictionTimeout < Now) RejectKickPrediction(PredictedKicks[Index].BombId);
+	}
+}
+
+void UBombermanGridStateComponent::BurnDueCells(double ServerNow)
+{
+	const int32 NowMs = ToTimeMs(ServerNow);
+
+	DueBurns.Reset();
+	for (int32 Index = PendingBurns.Num() - 1; Index >= 0; Index--)
+	{
+		if (PendingBurns[Index].TimeMs > NowMs) continue;
+
+		DueBurns.Add(PendingBurns[Index]);
+		PendingBurns.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+	if (DueBurns.Num() == 0) return;
+
+	// A bomb's cells were recorded together, group them back by bomb
+	DueBurns.StableSort([](const FGridEvent& A, const FGridEvent& B) { return A.BombId < B.BombId; });
+
+	for (int32 First = 0; First < DueBurns.Num();)
+	{
+		int32 End = First + 1;
+		while (End < DueBurns.Num() && DueBurns[End].BombId == DueBurns[First].BombId)
+		{
+			End++;
+		}
+
+		const TConstArrayView<FGridEvent> Burns(DueBurns.GetData() + First, End - First);
+		if (NowMs - Burns[0].TimeMs > StaleBurnMs)
+		{
+			// Only drop the bomb that is long gone
+			if (ABomb* Bomb = FindProxyBomb(Burns[0].BombId))
+			{
+				ProxyBombs.Remove(Burns[0].BombId);
+				if (UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>()) Pool->Release(Bomb);
+			}
+		}
+		else
+		{
+			BurnCellsOf(Burns[0].BombId, Burns);
+		}
+		First = End;
+	}
+}
+
+void UBombermanGridStateComponent::BurnCellsOf(uint16 BombId, TConstArrayView<FGridEvent> Burns)
+{
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid) return;
+
+	BurnCells.Reset();
+	for (const FGridEvent& Burn : Burns)
+	{
+		if (Burn.Type != EGridEventType::CellBurned) continue;
+
+		// Blocks and bombs are read from the local grid, which mirrors the server's
+		const FGridCoord Cell = Grid->GetGrid().ToCell(Burn.CellIndex);
+		BurnCells.Add({Cell, EExplosionType(Burn.Param), Grid->GetGrid().Get(Cell)});
+	}
+
+	// The bomb spawns its explosions exactly like on the server
+	ABomb* Bomb = BombId != 0 ? FindProxyBomb(BombId) : nullptr;
+	if (Bomb && !Bomb->IsExploding())
+	{
+		ProxyBombs.Remove(BombId);
+		Bomb->BeginDetonation();
+		Bomb->Detonate(BurnCells);
+		return;
+	}
+
+	// Bomb unknown here (placed before we joined, or not placed by a player): draw the cells alone
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
+	const UClass* ProxyClass  = GetProxyBombClass(nullptr);
+	const ABomb* BombCDO	  = ProxyClass ? ProxyClass->GetDefaultObject<ABomb>() : nullptr;
+	if (!Pool || !BombCDO || !BombCDO->GetExplosionClass()) return;
+
+	for (const FBlastCell& Cell : BurnCells)
+	{
+		if (AExplosion* Explosion = Pool->Acquire<AExplosion>(BombCDO->GetExplosionClass(), FTransform(Grid->CellToWorld(Cell.Cell, CellZ)), nullptr))
+		{
+			Explosion->InitializeExplosion(Cell.Type, nullptr, nullptr);
+		}
+	}
+}
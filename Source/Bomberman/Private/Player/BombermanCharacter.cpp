@@ -9,18 +9,25 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "Perception/AIPerceptionStimuliSourceComponent.h"
-#include "Kismet/GameplayStatics.h"
 #include "GameFramework/PlayerState.h"
 #include "GameFramework/PlayerController.h"
+#include "Net/UnrealNetwork.h"
 
+#include "AI/BombermanBotController.h"
 #include "Player/BombermanController.h"
 #include "Player/BombermanState.h"
 #include "Core/BombermanGameMode.h"
 #include "Core/GameplayLibrary.h"
 #include "Core/BombermanTypes.h"
+#include "Core/ActorPoolSubsystem.h"
+#include "Core/BombermanLog.h"
+#include "Core/BombermanStats.h"
 #include "World/Bomb.h"
 #include "World/Explosion.h"
 #include "World/Powerup.h"
+#include "World/BombermanGridSubsystem.h"
+#include "Net/BombermanGridStateComponent.h"
+#include "Replay/ReplayRecorderSubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(BombermanCharacter)
 
@@ -28,6 +35,9 @@ ABombermanCharacter::ABombermanCharacter()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
+	// Characters placed in the level without a player play as bots
+	AIControllerClass = ABombermanBotController::StaticClass();
+
 	// Character settings
 	GetCharacterMovement()->MaxWalkSpeed			  = BaseMoveSpeed;
 	GetCharacterMovement()->RotationRate			  = FRotator(0.0f, 540.0f, 0.0f);
@@ -53,6 +63,7 @@ void ABombermanCharacter::BeginPlay()
 	// Initialize
 	CurrentBombCount = 0;
 	UpdateMovementSpeed();
+	UpdateServerCells(true);
 
 	// Player controller settings
 	if (APlayerController* PC = Cast<APlayerController>(GetController()))
@@ -64,9 +75,53 @@ void ABombermanCharacter::BeginPlay()
 	// Set player-specific collision channels
 	GetCapsuleComponent()->SetCollisionObjectType(GetPlayerCollisionChannel());
 
+	// Warm up the bomb and explosion pools before the first placement
+	if (UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>())
+	{
+		if (const ABomb* BombCDO = BombClass ? BombClass->GetDefaultObject<ABomb>() : nullptr)
+		{
+			Pool->Prewarm(BombClass);
+			Pool->Prewarm(BombCDO->GetExplosionClass());
+		}
+	}
+	PlacedBombs.Reserve(MaxBombCount);
+
+	// Track the occupied cell on the grid
+	if (UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>())
+	{
+		Grid->RegisterPlayer(this);
+	}
+
 	const auto* PC = GetController<ABombermanController>();
 	const auto* PS = GetPlayerState<ABombermanState>();
-	UE_LOG(LogTemp, Log, TEXT("BeginPlay : %s, PlayerID: %d"), *PC->GetName(), PS->GetPlayerID());
+	UE_LOG(LogBomberman, Log, TEXT("BeginPlay : %s, PlayerID: %d"), PC ? *PC->GetName() : TEXT("None"), PS ? PS->GetPlayerID() : -1);
+}
+
+void ABombermanCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// The owning client predicts its placements and kicks with these
+	DOREPLIFETIME_CONDITION(ThisClass, MaxBombCount, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(ThisClass, BombPower, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(ThisClass, bCanKickBombs, COND_OwnerOnly);
+}
+
+void ABombermanCharacter::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (HasAuthority()) UpdateServerCells();
+}
+
+void ABombermanCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>())
+	{
+		Grid->UnregisterPlayer(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ABombermanCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -95,16 +150,42 @@ void ABombermanCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInput
 void ABombermanCharacter::Handle_Move(const FInputActionInstance& Instance)
 {
 	// Get value from input (combined value from WASD keys or single Gamepad stick) and convert to Vector (x,y)
-	const FVector2D AxisValue = Instance.GetValue().Get<FVector2D>();
-	MoveForward(AxisValue.Y);
-	MoveRight(AxisValue.X);
+	ApplyMoveInput(Instance.GetValue().Get<FVector2D>());
 }
 void ABombermanCharacter::Handle_BombPlace(const FInputActionValue& InputValue)
 {
-	PlaceBombInput();
+	ApplyBombPlaceInput();
 }
 void ABombermanCharacter::Handle_BombKick(const FInputActionValue& InputValue)
 {
+	ApplyBombKickInput();
+}
+
+void ABombermanCharacter::ApplyMoveInput(const FVector2D& Axis)
+{
+	if (UReplayRecorderSubsystem* Replay = UReplayRecorderSubsystem::GetActive(this))
+	{
+		Replay->RecordMove(this, Axis);
+	}
+	MoveForward(Axis.Y);
+	MoveRight(Axis.X);
+}
+
+void ABombermanCharacter::ApplyBombPlaceInput()
+{
+	if (UReplayRecorderSubsystem* Replay = UReplayRecorderSubsystem::GetActive(this))
+	{
+		Replay->RecordButtons(this, EReplayButtons::PlaceBomb);
+	}
+	PlaceBombInput();
+}
+
+void ABombermanCharacter::ApplyBombKickInput()
+{
+	if (UReplayRecorderSubsystem* Replay = UReplayRecorderSubsystem::GetActive(this))
+	{
+		Replay->RecordButtons(this, EReplayButtons::Kick);
+	}
 	KickBombInput();
 }
 
@@ -133,32 +214,85 @@ void ABombermanCharacter::PlaceBombInput()
 	if (bIsDead)
 		return;
 
-	PlaceBomb();
+	const FGridCoord Cell = FGridCoord::FromWorld(GetActorLocation(), GridSize);
+	if (!HasAuthority())
+	{
+		// Show the bomb right away, the server confirms it or rolls it back
+		uint8 PredictionKey = 0;
+		const float CurrentTime = GetWorld()->GetTimeSeconds();
+		UBombermanGridStateComponent* GridState = UBombermanGridStateComponent::Get(this);
+		// CurrentBombCount only lives on the server, the bombs ticking here stand in for it
+		if (GridState && CurrentTime - LastBombPlaceTime >= BombPlacementCooldown && GridState->CountLocalBombs(this) < MaxBombCount
+			&& CanPlaceBombAt(Cell))
+		{
+			PredictionKey	  = GridState->PredictBombPlaced(this, Cell, BombPower);
+			LastBombPlaceTime = CurrentTime;
+		}
+		ServerPlaceBomb(int32(Cell.Pack()), PredictionKey);
+		return;
+	}
+	PlaceBombAt(Cell);
+}
+
+void ABombermanCharacter::UpdateServerCells(bool bTeleported)
+{
+	const FGridCoord Cell = FGridCoord::FromWorld(GetActorLocation(), GridSize);
+	if (Cell == ServerCell && !bTeleported) return;
+
+	PreviousServerCell = bTeleported ? Cell : ServerCell;
+	ServerCell		   = Cell;
+}
+
+void ABombermanCharacter::ServerPlaceBomb_Implementation(int32 PackedCell, uint8 PredictionKey)
+{
+	// Movement lags behind the client, so the cell the player just left is accepted too, nothing else
+	UpdateServerCells();
+	const FGridCoord Cell = FGridCoord::Unpack(uint32(PackedCell));
+
+	const ABomb* Bomb = !bIsDead && (Cell == ServerCell || Cell == PreviousServerCell) ? PlaceBombAt(Cell, PredictionKey) : nullptr;
+	if (!Bomb && PredictionKey != 0)
+	{
+		ClientRejectBomb(PredictionKey);
+	}
+}
+
+void ABombermanCharacter::ClientRejectBomb_Implementation(uint8 PredictionKey)
+{
+	if (UBombermanGridStateComponent* GridState = UBombermanGridStateComponent::Get(this))
+	{
+		GridState->RejectBombPrediction(PredictionKey);
+	}
 }
 
 void ABombermanCharacter::PlaceBomb()
 {
+	PlaceBombAt(FGridCoord::FromWorld(GetActorLocation(), GridSize));
+}
+
+ABomb* ABombermanCharacter::PlaceBombAt(FGridCoord Cell, uint8 PredictionKey)
+{
+	BOMBERMAN_SCOPE(PlaceBomb);
+
 	// Cooldown check
 	float CurrentTime = GetWorld()->GetTimeSeconds();
 	if (CurrentTime - LastBombPlaceTime < BombPlacementCooldown)
-		return;
+		return nullptr;
 
 	// Check the number of bombs
 	if (CurrentBombCount >= MaxBombCount)
-		return;
+		return nullptr;
 
 	// Grid position calculation
-	FVector GridPosition = GetGridPosition(GetActorLocation());
+	const FVector GridPosition = Cell.ToWorld(GridSize, GetActorLocation().Z);
 
 	// Check if there are already bombs
-	if (!CanPlaceBombAtPosition(GridPosition))
-		return;
+	if (!CanPlaceBombAt(Cell))
+		return nullptr;
 
-	// Spawn a bomb
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.Owner = this;
-	// SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	// Take a bomb from the pool
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
+	if (!Pool)
+		return nullptr;
 
 	auto BombCDO = BombClass ? BombClass->GetDefaultObject<ABomb>() : nullptr;
 	auto OffsetZ = UGameplayLibrary::GetActorHalfHeightFromRootPrimitive(BombCDO);
@@ -168,7 +302,7 @@ void ABombermanCharacter::PlaceBomb()
 	float CharacterFeet = GetActorLocation().Z - GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 	SpawnPosition.Z		= CharacterFeet + OffsetZ;
 
-	ABomb* NewBomb = GetWorld()->SpawnActor<ABomb>(BombClass, SpawnPosition, FRotator::ZeroRotator, SpawnParams);
+	ABomb* NewBomb = Pool->Acquire<ABomb>(BombClass, FTransform(SpawnPosition), this);
 
 	if (NewBomb)
 	{
@@ -181,19 +315,26 @@ void ABombermanCharacter::PlaceBomb()
 		PlacedBombs.Add(NewBomb);
 		CurrentBombCount++;
 
-		// Set a callback when bombs explode
-		NewBomb->OnBombExploded.AddDynamic(this, &ThisClass::OnBombExploded);
+		// Set a callback when bombs explode (recycled bombs keep the binding)
+		NewBomb->OnBombExploded.AddUniqueDynamic(this, &ThisClass::OnBombExploded);
 
 		LastBombPlaceTime = CurrentTime;
 
 		// Blueprint event call
 		OnBombPlaced(NewBomb);
 
-		UE_LOG(LogTemp, Log, TEXT("Bomb placed at: %s, Current Count: %d / %d"), *GridPosition.ToString(), CurrentBombCount, MaxBombCount);
-	}
+		if (UBombermanGridStateComponent* GridState = UBombermanGridStateComponent::Get(this))
+		{
+			GridState->RecordBombPlaced(NewBomb, PredictionKey);
+		}
+		if (UReplayRecorderSubsystem* Replay = UReplayRecorderSubsystem::GetActive(this))
+		{
+			Replay->RecordBombPlaced(this, NewBomb);
+		}
 
-	APlayerState* PS = GetPlayerState();
-	PS->GetPlayerId();
+		UE_LOG(LogBomberman, Verbose, TEXT("Bomb placed at: %s, Current Count: %d / %d"), *GridPosition.ToString(), CurrentBombCount, MaxBombCount);
+	}
+	return NewBomb;
 }
 
 ECollisionChannel ABombermanCharacter::GetPlayerCollisionChannel() const
@@ -219,42 +360,16 @@ void ABombermanCharacter::PossessedBy(AController* NewController)
 
 }
 
-FVector ABombermanCharacter::GetGridPosition(FVector WorldPosition) const
+bool ABombermanCharacter::CanPlaceBombAt(FGridCoord Cell) const
 {
-	float X = FMath::RoundToFloat(WorldPosition.X / GridSize) * GridSize;
-	float Y = FMath::RoundToFloat(WorldPosition.Y / GridSize) * GridSize;
-	float Z = WorldPosition.Z;
-
-	return FVector(X, Y, Z);
-}
-
-bool ABombermanCharacter::CanPlaceBombAtPosition(FVector Position) const
-{
-	// Overlapping checks with existing bombs
-	for (const ABomb* Bomb : PlacedBombs)
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid)
 	{
-		if (Bomb && FVector::Dist2D(Bomb->GetActorLocation(), Position) < GridSize * 0.5f)
-		{
-			return false;
-		}
+		return false;
 	}
 
-	// Checking overlapping with blocks
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
-	QueryParams.bTraceComplex = false;
-
-	FHitResult HitResult;
-	bool bHit = GetWorld()->SweepSingleByChannel(
-		HitResult,
-		Position,
-		Position + FVector(0, 0, 1),
-		FQuat::Identity,
-		ECC_WorldStatic,
-		FCollisionShape::MakeBox(FVector(GridSize * 0.4f, GridSize * 0.4f, 50.0f)),
-		QueryParams);
-
-	return !bHit;
+	// Existing bombs, blocks and walls all live on the grid
+	return !Grid->HasAny(Cell, EGridCellFlags::PlaceStop);
 }
 
 void ABombermanCharacter::OnBombExploded(ABomb* ExplodedBomb)
@@ -264,7 +379,7 @@ void ABombermanCharacter::OnBombExploded(ABomb* ExplodedBomb)
 		PlacedBombs.Remove(ExplodedBomb);
 		CurrentBombCount = FMath::Max(0, CurrentBombCount - 1);
 
-		UE_LOG(LogTemp, Log, TEXT("Bomb exploded, remaining count: %d"), CurrentBombCount);
+		UE_LOG(LogBomberman, Verbose, TEXT("Bomb exploded, remaining count: %d"), CurrentBombCount);
 	}
 }
 
@@ -275,6 +390,19 @@ void ABombermanCharacter::KickBombInput()
 	if (!bCanKickBombs || bIsDead)
 		return;
 
+	if (!HasAuthority())
+	{
+		// Kick the local copy right away, the server's kick events correct it
+		uint16 PredictedBombId = 0;
+		ABomb* NearbyBomb	   = FindNearbyBomb();
+		if (UBombermanGridStateComponent* GridState = NearbyBomb ? UBombermanGridStateComponent::Get(this) : nullptr)
+		{
+			PredictedBombId = GridState->PredictKick(NearbyBomb, GetKickDirection(NearbyBomb), this);
+		}
+		ServerKickBomb(PredictedBombId);
+		return;
+	}
+
 	ABomb* NearbyBomb = FindNearbyBomb();
 	if (NearbyBomb)
 	{
@@ -288,44 +416,59 @@ void ABombermanCharacter::KickBomb(ABomb* Bomb)
 		return;
 
 	// Calculate kick direction
-	FVector KickDirection = (Bomb->GetActorLocation() - GetActorLocation()).GetSafeNormal2D();
+	FVector KickDirection = GetKickDirection(Bomb);
 
 	// Delegating the kicks to the bomb
 	if (Bomb->CanBeKicked())
 	{
 		Bomb->StartKick(KickDirection, this);
-		UE_LOG(LogTemp, Log, TEXT("Bomb kicked in direction: %s"), *KickDirection.ToString());
+		UE_LOG(LogBomberman, Verbose, TEXT("Bomb kicked in direction: %s"), *KickDirection.ToString());
 	}
 }
 
-ABomb* ABombermanCharacter::FindNearbyBomb(float SearchRadius) const
+FVector ABombermanCharacter::GetKickDirection(const ABomb* Bomb) const
 {
-	FVector PlayerLocation = GetActorLocation();
+	return (Bomb->GetActorLocation() - GetActorLocation()).GetSafeNormal2D();
+}
 
-	for (ABomb* Bomb : PlacedBombs)
+void ABombermanCharacter::ServerKickBomb_Implementation(uint16 PredictedBombId)
+{
+	ABomb* NearbyBomb  = bCanKickBombs && !bIsDead ? FindNearbyBomb() : nullptr;
+	const bool bKicked = NearbyBomb && NearbyBomb->CanBeKicked();
+	if (bKicked)
 	{
-		if (Bomb && FVector::Dist2D(Bomb->GetActorLocation(), PlayerLocation) <= SearchRadius)
-		{
-			return Bomb;
-		}
+		KickBomb(NearbyBomb);
 	}
 
-	// Check out other players' bombs too
-	TArray<AActor*> FoundBombs;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ABomb::StaticClass(), FoundBombs);
+	// The client kicked a bomb the server did not
+	if (PredictedBombId != 0 && (!bKicked || NearbyBomb->GetNetId() != PredictedBombId))
+	{
+		ClientRejectKick(PredictedBombId);
+	}
+}
 
-	for (AActor* Actor : FoundBombs)
+void ABombermanCharacter::ClientRejectKick_Implementation(uint16 PredictedBombId)
+{
+	if (UBombermanGridStateComponent* GridState = UBombermanGridStateComponent::Get(this))
 	{
-		if (ABomb* Bomb = Cast<ABomb>(Actor))
-		{
-			if (FVector::Dist2D(Bomb->GetActorLocation(), PlayerLocation) <= SearchRadius)
-			{
-				return Bomb;
-			}
-		}
+		GridState->RejectKickPrediction(PredictedBombId);
 	}
+}
 
-	return nullptr;
+ABomb* ABombermanCharacter::FindNearbyBomb() const
+{
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid)
+		return nullptr;
+
+	const FGridCoord PlayerCell = Grid->WorldToCell(GetActorLocation());
+
+	// The bomb right in front of the player first, then the one being stood on
+	if (ABomb* FacingBomb = Grid->GetAdjacentBomb(PlayerCell, GridDirectionFromVector(GetActorForwardVector())))
+	{
+		return FacingBomb;
+	}
+	return Grid->GetBombAt(PlayerCell);
 }
 
 // =============== Power-up System =================================
@@ -339,28 +482,28 @@ void ABombermanCharacter::PickupPowerup(APowerup* Powerup)
 	   {
 		   case EPowerupType::BombCount:
 			   MaxBombCount = FMath::Min(MaxBombCount + Powerup->GetPowerupValue(), 10);
-			   UE_LOG(LogTemp, Log, TEXT("Bomb count increased to: %d"), MaxBombCount);
+			   UE_LOG(LogBomberman, Log, TEXT("Bomb count increased to: %d"), MaxBombCount);
 			   break;
 
 		   case EPowerupType::BombPower:
 			   BombPower = FMath::Min(BombPower + Powerup->GetPowerupValue(), 10);
-			   UE_LOG(LogTemp, Log, TEXT("Bomb power increased to: %d"), BombPower);
+			   UE_LOG(LogBomberman, Log, TEXT("Bomb power increased to: %d"), BombPower);
 			   break;
 
 		   case EPowerupType::Speed:
 			   BaseMoveSpeed = FMath::Min(BaseMoveSpeed + (Powerup->GetPowerupValue() * 50.0f), 600.0f);
 			   UpdateMovementSpeed();
-			   UE_LOG(LogTemp, Log, TEXT("Move speed increased to: %f"), BaseMoveSpeed);
+			   UE_LOG(LogBomberman, Log, TEXT("Move speed increased to: %f"), BaseMoveSpeed);
 			   break;
 
 		   case EPowerupType::KickBomb:
 			   bCanKickBombs = true;
-			   UE_LOG(LogTemp, Log, TEXT("Kick bomb ability acquired"));
+			   UE_LOG(LogBomberman, Log, TEXT("Kick bomb ability acquired"));
 			   break;
 
 		   case EPowerupType::PushBomb:
 			   bCanPushBombs = true;
-			   UE_LOG(LogTemp, Log, TEXT("Push bomb ability acquired"));
+			   UE_LOG(LogBomberman, Log, TEXT("Push bomb ability acquired"));
 			   break;
 	   } */
 
@@ -386,7 +529,7 @@ void ABombermanCharacter::TakeBombDamage(float DamageAmount, AActor* DamageSourc
 	if (bIsDead || bIsInvincible)
 		return;
 
-	UE_LOG(LogTemp, Warning, TEXT("Player %s took damage from %s"), *GetName(), DamageSource ? *DamageSource->GetName() : TEXT("Unknown"));
+	UE_LOG(LogBomberman, Log, TEXT("Player %s took damage from %s"), *GetName(), DamageSource ? *DamageSource->GetName() : TEXT("Unknown"));
 
 	// Blueprint Event call
 	OnDamageReceived(DamageAmount, DamageSource);
@@ -402,6 +545,11 @@ void ABombermanCharacter::Die()
 
 	bIsDead = true;
 
+	if (UReplayRecorderSubsystem* Replay = UReplayRecorderSubsystem::GetActive(this))
+	{
+		Replay->RecordPlayerDied(this);
+	}
+
 	// Stop moving
 	GetCharacterMovement()->DisableMovement();
 
@@ -426,7 +574,7 @@ void ABombermanCharacter::Die()
 	// Respawn timer starts
 	GetWorldTimerManager().SetTimer(RespawnTimerHandle, this, &ThisClass::Respawn, RespawnDelay, false);
 
-	UE_LOG(LogTemp, Warning, TEXT("Player %s died"), *GetName());
+	UE_LOG(LogBomberman, Log, TEXT("Player %s died"), *GetName());
 }
 
 void ABombermanCharacter::Respawn()
@@ -457,6 +605,7 @@ void ABombermanCharacter::Respawn()
 			SetActorLocation(SpawnPoint->GetActorLocation());
 		}
 	}
+	UpdateServerCells(true);
 
 	// Temporary invincibility
 	StartInvincibility();
@@ -464,7 +613,7 @@ void ABombermanCharacter::Respawn()
 	// Blueprint event call
 	OnPlayerRespawned();
 
-	UE_LOG(LogTemp, Log, TEXT("Player %s respawned"), *GetName());
+	UE_LOG(LogBomberman, Log, TEXT("Player %s respawned"), *GetName());
 }
 
 void ABombermanCharacter::StartInvincibility()
@@ -498,21 +647,10 @@ void ABombermanCharacter::NotifyActorBeginOverlap(AActor* OtherActor)
 	if (bIsDead)
 		return;
 
-	// Contact with power-up
+	// Contact with power-up (explosion damage is applied by the grid)
 	if (APowerup* Powerup = Cast<APowerup>(OtherActor))
 	{
 		PickupPowerup(Powerup);
 		return;
 	}
-
-	// Contact with the explosion
-	if (AExplosion* Explosion = Cast<AExplosion>(OtherActor))
-	{
-		// Ignore your own bomb explosion
-		if (Explosion->GetOwner() != this)
-		{
-			TakeBombDamage(100.0f, Explosion);
-		}
-		return;
-	}
 }
\ No newline at end of file
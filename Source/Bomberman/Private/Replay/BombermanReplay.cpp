@@ -0,0 +1,623 @@
+#include "Replay/BombermanReplay.h"
+
+#include "Algo/BinarySearch.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+
+#include "Core/BombermanLog.h"
+
+namespace
+{
+	// Plain data arrays in one block, the length is checked against what is left when loading
+	template <typename T>
+	void SerializeRawArray(FArchive& Ar, TArray<T>& Array)
+	{
+		int32 Num = Array.Num();
+		Ar << Num;
+		if (Ar.IsLoading())
+		{
+			if (Num < 0 || int64(Num) * int64(sizeof(T)) > Ar.TotalSize() - Ar.Tell())
+			{
+				Ar.SetError();
+				return;
+			}
+			Array.SetNumUninitialized(Num);
+		}
+		Ar.Serialize(Array.GetData(), int64(Num) * sizeof(T));
+	}
+
+	void SerializeCell(FArchive& Ar, FGridCoord& Cell)
+	{
+		Ar << Cell.X << Cell.Y;
+	}
+
+	void SerializeBomb(FArchive& Ar, FSimBomb& Bomb)
+	{
+		SerializeCell(Ar, Bomb.Cell);
+		Ar << Bomb.Owner << Bomb.Range << Bomb.FuseTicks << Bomb.ChainDepth;
+		Ar << Bomb.KickDir << Bomb.KickCellsLeft << Bomb.KickTicks << Bomb.bCountsForOwner;
+	}
+
+	void SerializePlayer(FArchive& Ar, FSimPlayer& Player)
+	{
+		SerializeCell(Ar, Player.Cell);
+		SerializeCell(Ar, Player.SpawnCell);
+		Ar << Player.Facing << Player.MaxBombCount << Player.BombPower << Player.MoveSpeed << Player.bCanKickBombs;
+		Ar << Player.ActiveBombs << Player.MoveCooldown << Player.RespawnTicks << Player.InvincibleTicks << Player.bAlive;
+		Ar << Player.Kills << Player.Deaths;
+	}
+
+	template <typename T, typename FSerializeItem>
+	void SerializeItems(FArchive& Ar, TArray<T>& Items, FSerializeItem&& SerializeItem)
+	{
+		int32 Num = Items.Num();
+		Ar << Num;
+		if (Ar.IsLoading())
+		{
+			// Keyframes hold a few bombs and players, anything bigger is a corrupt file
+			if (Num < 0 || Num > MAX_uint16)
+			{
+				Ar.SetError();
+				return;
+			}
+			Items.SetNum(Num);
+		}
+		for (T& Item : Items)
+		{
+			SerializeItem(Ar, Item);
+		}
+	}
+}
+
+FArchive& operator<<(FArchive& Ar, FReplayHeader& Header)
+{
+	Ar << Header.TicksPerSecond << Header.KeyframeInterval << Header.MapName << Header.RecordedAt;
+	return Ar;
+}
+
+void SerializeSimState(FArchive& Ar, FSimState& State)
+{
+	FBombermanGrid& Grid = State.Grid;
+	SerializeCell(Ar, Grid.MinCell);
+	Ar << Grid.Width << Grid.Height << Grid.CellSize;
+
+	SerializeRawArray(Ar, Grid.Cells);
+	SerializeRawArray(Ar, State.Powerups);
+	SerializeRawArray(Ar, State.BurnTicks);
+	SerializeRawArray(Ar, State.BurnOwners);
+
+	SerializeItems(Ar, State.Bombs, &SerializeBomb);
+	SerializeItems(Ar, State.Players, &SerializePlayer);
+
+	// The stream continues from its current seed, the initial one is not needed
+	int32 Seed = State.Random.GetCurrentSeed();
+	Ar << State.Tick << Seed;
+	if (Ar.IsLoading())
+	{
+		State.Random.Initialize(Seed);
+
+		// Everything indexed like the grid has to agree, or the state cannot be played
+		const int32 Num = Grid.Width * Grid.Height;
+		if (Grid.Cells.Num() != Num || State.Powerups.Num() != Num || State.BurnTicks.Num() != Num || State.BurnOwners.Num() != Num)
+		{
+			Ar.SetError();
+		}
+	}
+}
+
+// ===== Writer =====
+
+FBombermanReplayWriter::FBombermanReplayWriter()
+	: WritePipe(TEXT("BombermanReplayWrite"))
+	, Ar(Buffer)
+{
+}
+
+FBombermanReplayWriter::~FBombermanReplayWriter()
+{
+	Close();
+}
+
+bool FBombermanReplayWriter::Open(const FString& Path, FReplayHeader Header)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Path));
+
+	IFileHandle* Handle = PlatformFile.OpenWrite(*Path);
+	if (!Handle)
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Could not open replay file %s"), *Path);
+		return false;
+	}
+	File = MakeShareable(Handle);
+
+	Buffer.Reset(FlushBytes * 2);
+	Ar.Seek(0);
+	CurrentTick	 = 0;
+	WrittenTick	 = 0;
+	BytesFlushed = 0;
+
+	uint32 Magic   = FReplayHeader::Magic;
+	uint32 Version = FReplayHeader::Version;
+	Ar << Magic << Version << Header;
+	return true;
+}
+
+void FBombermanReplayWriter::Close()
+{
+	if (!File.IsValid()) return;
+
+	BeginRecord(EReplayRecord::End);
+	Flush();
+	WritePipe.WaitUntilEmpty();
+	File.Reset();
+}
+
+void FBombermanReplayWriter::SetTick(int64 Tick)
+{
+	CurrentTick = FMath::Max(CurrentTick, Tick);
+}
+
+void FBombermanReplayWriter::WriteMove(int32 Seat, int8 AxisX, int8 AxisY)
+{
+	BeginRecord(EReplayRecord::Move);
+	WriteByte(uint8(Seat));
+	WriteByte(uint8(AxisX));
+	WriteByte(uint8(AxisY));
+}
+
+void FBombermanReplayWriter::WriteButtons(int32 Seat, EReplayButtons Buttons)
+{
+	BeginRecord(EReplayRecord::Buttons);
+	WriteByte(uint8(Seat));
+	WriteByte(uint8(Buttons));
+}
+
+void FBombermanReplayWriter::WritePlayerCell(int32 Seat, int32 CellIndex)
+{
+	BeginRecord(EReplayRecord::PlayerCell);
+	WriteByte(uint8(Seat));
+	WritePacked(uint32(CellIndex));
+}
+
+void FBombermanReplayWriter::WriteBombPlaced(int32 Seat, int32 CellIndex, int32 Power, int32 FuseTicks)
+{
+	BeginRecord(EReplayRecord::BombPlaced);
+	WriteByte(uint8(Seat));
+	WritePacked(uint32(CellIndex));
+	WriteByte(uint8(FMath::Clamp(Power, 0, MAX_uint8)));
+	WritePacked(uint32(FMath::Max(0, FuseTicks)));
+}
+
+void FBombermanReplayWriter::WriteBombKicked(int32 Seat, int32 CellIndex, int32 Dir)
+{
+	BeginRecord(EReplayRecord::BombKicked);
+	WriteByte(uint8(Seat));
+	WritePacked(uint32(CellIndex));
+	WriteByte(uint8(Dir));
+}
+
+void FBombermanReplayWriter::WriteBombDetonated(int32 CellIndex, int32 DelayTicks)
+{
+	BeginRecord(EReplayRecord::BombDetonated);
+	WritePacked(uint32(CellIndex));
+	WritePacked(uint32(FMath::Max(0, DelayTicks)));
+}
+
+void FBombermanReplayWriter::WritePlayerDied(int32 Seat, int32 CellIndex)
+{
+	BeginRecord(EReplayRecord::PlayerDied);
+	WriteByte(uint8(Seat));
+	WritePacked(uint32(CellIndex));
+}
+
+void FBombermanReplayWriter::WriteKeyframe(const FSimState& State)
+{
+	// Size first so readers can index keyframes without decoding them
+	KeyframeBuffer.Reset();
+	FMemoryWriter KeyframeAr(KeyframeBuffer);
+	SerializeSimState(KeyframeAr, const_cast<FSimState&>(State));
+
+	BeginRecord(EReplayRecord::Keyframe);
+	WritePacked(uint32(KeyframeBuffer.Num()));
+	Ar.Serialize(KeyframeBuffer.GetData(), KeyframeBuffer.Num());
+}
+
+void FBombermanReplayWriter::BeginRecord(EReplayRecord Type)
+{
+	if (Buffer.Num() >= FlushBytes)
+	{
+		Flush();
+	}
+
+	if (CurrentTick != WrittenTick)
+	{
+		WriteByte(uint8(EReplayRecord::Tick));
+		WritePacked(uint32(CurrentTick - WrittenTick));
+		WrittenTick = CurrentTick;
+	}
+	WriteByte(uint8(Type));
+}
+
+void FBombermanReplayWriter::WritePacked(uint32 Value)
+{
+	Ar.SerializeIntPacked(Value);
+}
+
+void FBombermanReplayWriter::WriteByte(uint8 Value)
+{
+	Ar << Value;
+}
+
+void FBombermanReplayWriter::Flush()
+{
+	if (Buffer.Num() == 0) return;
+
+	BytesFlushed += Buffer.Num();
+
+	// Chunks are written in order on a worker, the game thread only hands the buffer over
+	WritePipe.Launch(TEXT("BombermanReplayChunk"), [File = File, Chunk = MoveTemp(Buffer)]()
+	{
+		File->Write(Chunk.GetData(), Chunk.Num());
+	});
+
+	Buffer.Reset(FlushBytes * 2);
+	Ar.Seek(0);
+}
+
+// ===== Player =====
+
+FBombermanReplayPlayer::FBombermanReplayPlayer(const FSimRules& InRules)
+	: Rules(InRules)
+	, Sim(InRules)
+{
+}
+
+bool FBombermanReplayPlayer::Load(const FString& Path)
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *Path))
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Could not read replay file %s"), *Path);
+		return false;
+	}
+	return Load(MoveTemp(FileData));
+}
+
+bool FBombermanReplayPlayer::Load(TArray<uint8>&& InData)
+{
+	Data = MoveTemp(InData);
+	Keyframes.Reset();
+	EndTick = 0;
+
+	FMemoryReader Reader(Data);
+	uint32 Magic   = 0;
+	uint32 Version = 0;
+	Reader << Magic << Version;
+	if (Reader.IsError() || Magic != FReplayHeader::Magic || Version != FReplayHeader::Version)
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Not a replay or unsupported version %u"), Version);
+		return false;
+	}
+
+	Reader << Header;
+	if (Reader.IsError() || Header.TicksPerSecond != Rules.TicksPerSecond)
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Replay recorded at %d ticks per second, the simulation runs at %d"), Header.TicksPerSecond, Rules.TicksPerSecond);
+		return false;
+	}
+	RecordsOffset = Reader.Tell();
+
+	// Index the keyframes. A replay cut short by a crash ends at its last complete record
+	int64 Tick = 0;
+	FReplayRecord Record;
+	for (;;)
+	{
+		const int64 Offset = Reader.Tell();
+		if (!ReadRecord(Reader, Record, nullptr) || Record.Type == EReplayRecord::End) break;
+
+		if (Record.Type == EReplayRecord::Tick)
+		{
+			Tick += Record.Value;
+		}
+		else if (Record.Type == EReplayRecord::Keyframe)
+		{
+			Keyframes.Add({Tick, Offset});
+		}
+		EndTick = Tick + 1;
+	}
+
+	if (Keyframes.Num() == 0)
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Replay has no keyframe"));
+		return false;
+	}
+	return RestoreKeyframe(0);
+}
+
+bool FBombermanReplayPlayer::ReadRecord(FArchive& Reader, FReplayRecord& OutRecord, FSimState* OutKeyframe)
+{
+	if (Reader.AtEnd()) return false;
+
+	auto ReadByte = [&Reader]()
+	{
+		uint8 Value = 0;
+		Reader << Value;
+		return Value;
+	};
+	auto ReadPacked = [&Reader]()
+	{
+		uint32 Value = 0;
+		Reader.SerializeIntPacked(Value);
+		return int32(FMath::Min<uint32>(Value, MAX_int32));
+	};
+
+	OutRecord		= FReplayRecord();
+	OutRecord.Type	= EReplayRecord(ReadByte());
+
+	switch (OutRecord.Type)
+	{
+		case EReplayRecord::Tick:
+			OutRecord.Value = ReadPacked();
+			break;
+		case EReplayRecord::Move:
+			OutRecord.Seat	 = ReadByte();
+			OutRecord.Value	 = int8(ReadByte());
+			OutRecord.Value2 = int8(ReadByte());
+			break;
+		case EReplayRecord::Buttons:
+			OutRecord.Seat	= ReadByte();
+			OutRecord.Value = ReadByte();
+			break;
+		case EReplayRecord::PlayerCell:
+		case EReplayRecord::PlayerDied:
+			OutRecord.Seat		= ReadByte();
+			OutRecord.CellIndex = ReadPacked();
+			break;
+		case EReplayRecord::BombPlaced:
+			OutRecord.Seat		= ReadByte();
+			OutRecord.CellIndex = ReadPacked();
+			OutRecord.Value		= ReadByte();
+			OutRecord.Value2	= ReadPacked();
+			break;
+		case EReplayRecord::BombKicked:
+			OutRecord.Seat		= ReadByte();
+			OutRecord.CellIndex = ReadPacked();
+			OutRecord.Value		= ReadByte();
+			break;
+		case EReplayRecord::BombDetonated:
+			OutRecord.CellIndex = ReadPacked();
+			OutRecord.Value		= ReadPacked();
+			break;
+		case EReplayRecord::Keyframe:
+		{
+			const int32 Size   = ReadPacked();
+			const int64 Start  = Reader.Tell();
+			if (Size > Reader.TotalSize() - Start) return false;
+
+			if (OutKeyframe)
+			{
+				SerializeSimState(Reader, *OutKeyframe);
+			}
+			Reader.Seek(Start + Size);
+			break;
+		}
+		case EReplayRecord::End:
+			break;
+		default:
+			// Unknown tag, nothing after it can be trusted
+			return false;
+	}
+
+	return !Reader.IsError();
+}
+
+bool FBombermanReplayPlayer::RestoreKeyframe(int32 KeyframeIndex)
+{
+	const FKeyframeEntry& Keyframe = Keyframes[KeyframeIndex];
+
+	FMemoryReader Reader(Data);
+	Reader.Seek(Keyframe.Offset);
+
+	FSimState State;
+	FReplayRecord Record;
+	if (!ReadRecord(Reader, Record, &State))
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Replay keyframe at tick %lld is corrupt"), Keyframe.Tick);
+		return false;
+	}
+
+	State.Tick = int32(Keyframe.Tick);
+	Sim.Reset(State);
+
+	Cursor	   = Reader.Tell();
+	CursorTick = Keyframe.Tick;
+	Expected.Reset();
+	Unexpected.Reset();
+	Divergences.Reset();
+	return true;
+}
+
+bool FBombermanReplayPlayer::Seek(int64 Tick)
+{
+	if (Keyframes.Num() == 0) return false;
+
+	Tick = FMath::Clamp(Tick, GetStartTick(), EndTick);
+
+	// Playing forward inside the current keyframe interval needs no restore
+	const int32 Index = Algo::UpperBoundBy(Keyframes, Tick, &FKeyframeEntry::Tick) - 1;
+	const bool bAhead = Tick >= GetTick() && Keyframes[Index].Tick <= GetTick();
+	if (!bAhead && !RestoreKeyframe(Index)) return false;
+
+	while (GetTick() < Tick && Step())
+	{
+	}
+	return GetTick() == Tick;
+}
+
+bool FBombermanReplayPlayer::Step()
+{
+	if (IsFinished()) return false;
+
+	const int64 Tick = GetTick();
+	FSimState& State = Sim.GetMutableState();
+
+	Inputs.Reset();
+	Inputs.SetNum(State.Players.Num());
+	Placed.Reset();
+
+	// Movement comes from the recorded cells, the simulation only turns the players
+	FMemoryReader Reader(Data);
+	Reader.Seek(Cursor);
+	FReplayRecord Record;
+	while (CursorTick <= Tick && ReadRecord(Reader, Record, nullptr))
+	{
+		Cursor		= Reader.Tell();
+		Record.Tick = Tick;
+
+		FSimPlayer* Player = State.Players.IsValidIndex(Record.Seat) ? &State.Players[Record.Seat] : nullptr;
+		switch (Record.Type)
+		{
+			case EReplayRecord::Tick:
+				CursorTick += Record.Value;
+				break;
+			case EReplayRecord::Move:
+			{
+				// Handle_Move drives +X with the Y axis and +Y with the X axis
+				const int32 Dir = GridDirectionFromVector(FVector(Record.Value2, Record.Value, 0.0));
+				if (Player && Dir != INDEX_NONE) Player->Facing = Dir;
+				break;
+			}
+			case EReplayRecord::Buttons:
+				if (Player)
+				{
+					Inputs[Record.Seat].bPlaceBomb = EnumHasAnyFlags(EReplayButtons(Record.Value), EReplayButtons::PlaceBomb);
+					Inputs[Record.Seat].bKick	   = EnumHasAnyFlags(EReplayButtons(Record.Value), EReplayButtons::Kick);
+				}
+				break;
+			case EReplayRecord::PlayerCell:
+				if (Player && Player->bAlive && Record.CellIndex < State.Grid.Num())
+				{
+					Player->Cell = State.Grid.ToCell(Record.CellIndex);
+				}
+				break;
+			case EReplayRecord::BombPlaced:
+				Placed.Add(Record);
+				break;
+			case EReplayRecord::BombKicked:
+				// Kicks asked for over the network have no button record, the kick itself is enough
+				if (Player && Record.Value < 4)
+				{
+					Player->Facing				= Record.Value;
+					Inputs[Record.Seat].bKick = true;
+				}
+				break;
+			case EReplayRecord::BombDetonated:
+				Record.Tick += Record.Value;
+				Expected.Add(Record);
+				break;
+			case EReplayRecord::PlayerDied:
+				Expected.Add(Record);
+				break;
+			default:
+				break;
+		}
+	}
+
+	Sim.Step(Inputs);
+
+	for (const FReplayRecord& Placement : Placed)
+	{
+		ApplyPlacement(Placement);
+	}
+	MatchEvents();
+	return true;
+}
+
+void FBombermanReplayPlayer::ApplyPlacement(const FReplayRecord& Record)
+{
+	FSimState& State = Sim.GetMutableState();
+	if (Record.CellIndex >= State.Grid.Num() || !State.Players.IsValidIndex(Record.Seat)) return;
+
+	const FGridCoord Cell = State.Grid.ToCell(Record.CellIndex);
+	int32 BombIndex		  = State.FindBomb(Cell);
+	if (BombIndex == INDEX_NONE)
+	{
+		// The simulation refused the placement (stats or timing drifted), the recording wins
+		if (State.Grid.HasAny(Cell, EGridCellFlags::Wall | EGridCellFlags::Block)) return;
+
+		FSimBomb& Bomb = State.Bombs.AddDefaulted_GetRef();
+		Bomb.Cell	   = Cell;
+		Bomb.Owner	   = Record.Seat;
+		State.Grid.Add(Cell, EGridCellFlags::Bomb);
+		State.Players[Record.Seat].ActiveBombs++;
+		BombIndex = State.Bombs.Num() - 1;
+	}
+
+	// The live bomb counted down once on its first tick, like the simulated one
+	FSimBomb& Bomb = State.Bombs[BombIndex];
+	Bomb.Range	   = FMath::Max(1, Record.Value);
+	Bomb.FuseTicks = FMath::Max(1, Record.Value2 - 1);
+}
+
+void FBombermanReplayPlayer::MatchEvents()
+{
+	const FSimState& State = Sim.GetState();
+	const int64 Tick	   = GetTick() - 1;
+
+	auto IsSameEvent = [](const FReplayRecord& A, const FReplayRecord& B)
+	{
+		if (A.Type != B.Type || FMath::Abs(A.Tick - B.Tick) > MatchWindowTicks) return false;
+		return A.Type == EReplayRecord::BombDetonated ? A.CellIndex == B.CellIndex : A.Seat == B.Seat;
+	};
+
+	for (const FSimEvent& Event : State.Events)
+	{
+		if (Event.Type != ESimEventType::BombDetonated && Event.Type != ESimEventType::PlayerDied) continue;
+
+		FReplayRecord Simulated;
+		Simulated.Type		= Event.Type == ESimEventType::BombDetonated ? EReplayRecord::BombDetonated : EReplayRecord::PlayerDied;
+		Simulated.Tick		= Tick;
+		Simulated.Seat		= Event.Player;
+		Simulated.CellIndex = State.Grid.ToIndex(Event.Cell);
+
+		const int32 Index = Expected.IndexOfByPredicate([&](const FReplayRecord& Recorded) { return IsSameEvent(Recorded, Simulated); });
+		if (Index != INDEX_NONE)
+		{
+			Expected.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+		else
+		{
+			Unexpected.Add(Simulated);
+		}
+	}
+
+	// Recorded events can be read after the simulation already produced them
+	for (int32 Index = Expected.Num() - 1; Index >= 0; Index--)
+	{
+		const int32 Match = Unexpected.IndexOfByPredicate([&](const FReplayRecord& Simulated) { return IsSameEvent(Expected[Index], Simulated); });
+		if (Match != INDEX_NONE)
+		{
+			Unexpected.RemoveAtSwap(Match, 1, EAllowShrinking::No);
+			Expected.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+
+	// Whatever stayed unmatched for the whole window diverged
+	auto Expire = [this, Tick](TArray<FReplayRecord>& Events, bool bRecorded)
+	{
+		for (int32 Index = Events.Num() - 1; Index >= 0; Index--)
+		{
+			if (Events[Index].Tick + MatchWindowTicks >= Tick) continue;
+
+			Divergences.Add({Events[Index], bRecorded});
+			Events.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	};
+	Expire(Expected, true);
+	Expire(Unexpected, false);
+}
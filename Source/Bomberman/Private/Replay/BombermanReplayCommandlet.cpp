@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Replay/BombermanReplayCommandlet.h"
+
+#include "HAL/PlatformTime.h"
+
+#include "Core/BombermanLog.h"
+#include "Replay/BombermanReplay.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BombermanReplayCommandlet)
+
+UBombermanReplayCommandlet::UBombermanReplayCommandlet()
+{
+	IsClient	 = false;
+	IsServer	 = false;
+	IsEditor	 = false;
+	LogToConsole = true;
+}
+
+int32 UBombermanReplayCommandlet::Main(const FString& Params)
+{
+	FString Path;
+	if (!FParse::Value(*Params, TEXT("Replay="), Path))
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Usage: -run=BombermanReplay -Replay=<file> [-From=<seconds>] [-To=<seconds>] [-Strict]"));
+		return 1;
+	}
+
+	FBombermanReplayPlayer Player;
+	if (!Player.Load(Path)) return 1;
+
+	const FReplayHeader& Header = Player.GetHeader();
+	const double TicksPerSecond = Header.TicksPerSecond;
+	UE_LOG(LogBomberman, Display, TEXT("%s: map %s, ticks %lld-%lld (%.1fs), %d keyframes"), *Path, *Header.MapName, Player.GetStartTick(), Player.GetEndTick(),
+		(Player.GetEndTick() - Player.GetStartTick()) / TicksPerSecond, Player.NumKeyframes());
+
+	// Seconds from the start of the recording
+	float FromSeconds = 0.0f;
+	float ToSeconds	  = float((Player.GetEndTick() - Player.GetStartTick()) / TicksPerSecond);
+	FParse::Value(*Params, TEXT("From="), FromSeconds);
+	FParse::Value(*Params, TEXT("To="), ToSeconds);
+	const int64 FromTick = Player.GetStartTick() + FMath::RoundToInt64(FromSeconds * TicksPerSecond);
+	const int64 ToTick	 = FMath::Min(Player.GetEndTick(), Player.GetStartTick() + FMath::RoundToInt64(ToSeconds * TicksPerSecond));
+
+	const double StartTime = FPlatformTime::Seconds();
+	if (!Player.Seek(FromTick))
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Could not seek to tick %lld"), FromTick);
+		return 1;
+	}
+	const double SeekSeconds = FPlatformTime::Seconds() - StartTime;
+
+	while (Player.GetTick() < ToTick && Player.Step())
+	{
+	}
+
+	for (const FReplayDivergence& Divergence : Player.GetDivergences())
+	{
+		const FReplayRecord& Event = Divergence.Event;
+		const TCHAR* What		   = Event.Type == EReplayRecord::BombDetonated ? TEXT("detonation") : TEXT("death");
+		UE_LOG(LogBomberman, Warning, TEXT("Tick %lld: %s (seat %d, cell %d) only %s"), Event.Tick, What, Event.Seat, Event.CellIndex,
+			Divergence.bRecorded ? TEXT("in the recording") : TEXT("in the re-simulation"));
+	}
+
+	const int32 NumDivergences = Player.GetDivergences().Num();
+	UE_LOG(LogBomberman, Display, TEXT("Played ticks %lld-%lld (seek %.1f ms), %d divergences"), FromTick, Player.GetTick(), SeekSeconds * 1000.0, NumDivergences);
+
+	return FParse::Param(*Params, TEXT("Strict")) && NumDivergences > 0 ? 1 : 0;
+}
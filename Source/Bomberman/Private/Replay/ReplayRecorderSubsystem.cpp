@@ -0,0 +1,278 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Replay/ReplayRecorderSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+#include "Core/BombermanClock.h"
+#include "Core/BombermanLog.h"
+#include "Core/BombermanStats.h"
+#include "Player/BombermanCharacter.h"
+#include "World/Bomb.h"
+#include "World/BombUpdateSubsystem.h"
+#include "World/BombermanGridSubsystem.h"
+#include "World/ChainReactionSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ReplayRecorderSubsystem)
+
+static TAutoConsoleVariable<bool> CVarReplayRecord(
+	TEXT("bomberman.Replay.Record"),
+	false,
+	TEXT("Record every match into Saved/Replays.\n")
+	TEXT("Applies to worlds that begin play after the change."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarReplayKeyframeSeconds(
+	TEXT("bomberman.Replay.KeyframeSeconds"),
+	5.0f,
+	TEXT("Seconds between replay keyframes, the longest a seek has to simulate."),
+	ECVF_Default);
+
+namespace
+{
+	int8 QuantizeAxis(double Value)
+	{
+		return int8(FMath::RoundToInt32(FMath::Clamp(Value, -1.0, 1.0) * 127.0));
+	}
+}
+
+UReplayRecorderSubsystem* UReplayRecorderSubsystem::GetActive(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	UReplayRecorderSubsystem* Recorder = World ? World->GetSubsystem<UReplayRecorderSubsystem>() : nullptr;
+	return Recorder && Recorder->IsRecording() ? Recorder : nullptr;
+}
+
+bool UReplayRecorderSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UReplayRecorderSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (CVarReplayRecord.GetValueOnGameThread())
+	{
+		const FString FileName = FString::Printf(TEXT("%s-%s.bmreplay"), *InWorld.GetMapName(), *FDateTime::Now().ToString());
+		StartRecording(FPaths::ProjectSavedDir() / TEXT("Replays") / FileName);
+	}
+}
+
+void UReplayRecorderSubsystem::Deinitialize()
+{
+	StopRecording();
+
+	Super::Deinitialize();
+}
+
+bool UReplayRecorderSubsystem::StartRecording(const FString& Path)
+{
+	StopRecording();
+
+	// Clients only mirror the server's gameplay, there is nothing of theirs to re-drive
+	UWorld* World = GetWorld();
+	if (World->GetNetMode() == NM_Client) return false;
+
+	UBombUpdateSubsystem* Updates		 = World->GetSubsystem<UBombUpdateSubsystem>();
+	UChainReactionSubsystem* ChainReaction = World->GetSubsystem<UChainReactionSubsystem>();
+	if (!Updates || !ChainReaction) return false;
+
+	FReplayHeader Header;
+	Header.TicksPerSecond	= BombermanClock::TicksPerSecond;
+	Header.KeyframeInterval = FMath::Max(1, BombermanClock::SecondsToTicks(CVarReplayKeyframeSeconds.GetValueOnGameThread()));
+	Header.MapName			= World->GetMapName();
+	Header.RecordedAt		= FDateTime::UtcNow();
+
+	Writer = MakeUnique<FBombermanReplayWriter>();
+	if (!Writer->Open(Path, Header))
+	{
+		Writer.Reset();
+		return false;
+	}
+
+	KeyframeTicks  = Header.KeyframeInterval;
+	bNeedsKeyframe = true;
+	Seats.Reset();
+
+	FixedTickHandle		= Updates->OnFixedTickEnd.AddUObject(this, &ThisClass::OnFixedTick);
+	ChainResolvedHandle = ChainReaction->OnChainReactionResolved.AddUObject(this, &ThisClass::OnChainResolved);
+
+	UE_LOG(LogBomberman, Log, TEXT("Recording replay to %s"), *Path);
+	return true;
+}
+
+void UReplayRecorderSubsystem::StopRecording()
+{
+	if (!Writer.IsValid()) return;
+
+	if (UBombUpdateSubsystem* Updates = GetWorld()->GetSubsystem<UBombUpdateSubsystem>())
+	{
+		Updates->OnFixedTickEnd.Remove(FixedTickHandle);
+	}
+	if (UChainReactionSubsystem* ChainReaction = GetWorld()->GetSubsystem<UChainReactionSubsystem>())
+	{
+		ChainReaction->OnChainReactionResolved.Remove(ChainResolvedHandle);
+	}
+
+	const int64 Bytes = Writer->GetBytesWritten();
+	Writer->Close();
+	Writer.Reset();
+
+	UE_LOG(LogBomberman, Log, TEXT("Replay recording stopped, %lld bytes"), Bytes);
+}
+
+UReplayRecorderSubsystem::FSeat* UReplayRecorderSubsystem::FindSeat(const ABombermanCharacter* Player, int32& OutSeat)
+{
+	// Seats are the grid's player slots, the same order keyframes store the players in
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	OutSeat								= Grid ? Grid->GetPlayers().IndexOfByKey(Player) : INDEX_NONE;
+	return OutSeat != INDEX_NONE ? &GetSeat(OutSeat, Player) : nullptr;
+}
+
+UReplayRecorderSubsystem::FSeat& UReplayRecorderSubsystem::GetSeat(int32 SeatIndex, const ABombermanCharacter* Player)
+{
+	if (!Seats.IsValidIndex(SeatIndex))
+	{
+		Seats.SetNum(SeatIndex + 1);
+	}
+
+	// Joins and leaves are not in the stream, the next keyframe carries the new roster
+	FSeat& Seat = Seats[SeatIndex];
+	if (Seat.Player.Get() != Player)
+	{
+		Seat		   = FSeat();
+		Seat.Player	   = Player;
+		bNeedsKeyframe = true;
+	}
+	return Seat;
+}
+
+int32 UReplayRecorderSubsystem::GetCellIndex(const FVector& Location) const
+{
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid) return INDEX_NONE;
+
+	const FBombermanGrid& GridData = Grid->GetGrid();
+	const FGridCoord Cell		   = GridData.WorldToCell(Location);
+	return GridData.Contains(Cell) ? GridData.ToIndex(Cell) : INDEX_NONE;
+}
+
+void UReplayRecorderSubsystem::RecordMove(const ABombermanCharacter* Player, const FVector2D& Axis)
+{
+	int32 SeatIndex;
+	if (FSeat* Seat = FindSeat(Player, SeatIndex))
+	{
+		Seat->AxisX		= QuantizeAxis(Axis.X);
+		Seat->AxisY		= QuantizeAxis(Axis.Y);
+		Seat->AxisFrame = GFrameCounter;
+	}
+}
+
+void UReplayRecorderSubsystem::RecordButtons(const ABombermanCharacter* Player, EReplayButtons Buttons)
+{
+	int32 SeatIndex;
+	if (FSeat* Seat = FindSeat(Player, SeatIndex))
+	{
+		Seat->Buttons |= Buttons;
+	}
+}
+
+void UReplayRecorderSubsystem::RecordBombPlaced(const ABombermanCharacter* Player, const ABomb* Bomb)
+{
+	int32 SeatIndex;
+	const int32 CellIndex = GetCellIndex(Bomb->GetActorLocation());
+	if (!FindSeat(Player, SeatIndex) || CellIndex == INDEX_NONE) return;
+
+	const UBombUpdateSubsystem* Updates = GetWorld()->GetSubsystem<UBombUpdateSubsystem>();
+	const float FuseSeconds				= Updates ? Updates->GetFuseRemaining(Bomb) : 0.0f;
+	Writer->WriteBombPlaced(SeatIndex, CellIndex, Bomb->GetBombPower(), BombermanClock::SecondsToTicks(FuseSeconds));
+}
+
+void UReplayRecorderSubsystem::RecordBombKicked(const ABombermanCharacter* Kicker, const ABomb* Bomb, int32 Dir)
+{
+	int32 SeatIndex;
+	const int32 CellIndex = GetCellIndex(Bomb->GetActorLocation());
+	if (!FindSeat(Kicker, SeatIndex) || CellIndex == INDEX_NONE || Dir == INDEX_NONE) return;
+
+	Writer->WriteBombKicked(SeatIndex, CellIndex, Dir);
+}
+
+void UReplayRecorderSubsystem::RecordPlayerDied(const ABombermanCharacter* Player)
+{
+	int32 SeatIndex;
+	const int32 CellIndex = GetCellIndex(Player->GetActorLocation());
+	if (!FindSeat(Player, SeatIndex) || CellIndex == INDEX_NONE) return;
+
+	Writer->WritePlayerDied(SeatIndex, CellIndex);
+}
+
+void UReplayRecorderSubsystem::OnChainResolved(const FChainReactionResult& Result)
+{
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid) return;
+
+	for (const FChainBomb& ChainBomb : Result.Bombs)
+	{
+		if (Grid->GetGrid().Contains(ChainBomb.Cell))
+		{
+			Writer->WriteBombDetonated(Grid->GetGrid().ToIndex(ChainBomb.Cell), BombermanClock::SecondsToTicks(ChainBomb.Delay));
+		}
+	}
+}
+
+void UReplayRecorderSubsystem::OnFixedTick(int64 Tick)
+{
+	BOMBERMAN_SCOPE(ReplayRecord);
+
+	UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid) return;
+
+	// Inputs and positions that led into this tick
+	const TArray<TWeakObjectPtr<ABombermanCharacter>>& Players = Grid->GetPlayers();
+	for (int32 SeatIndex = 0; SeatIndex < Players.Num(); SeatIndex++)
+	{
+		const ABombermanCharacter* Player = Players[SeatIndex].Get();
+		FSeat& Seat						  = GetSeat(SeatIndex, Player);
+		if (!Player) continue;
+
+		// Handle_Move fires every frame the stick is held, a frame without it means released
+		const bool bHeld = Seat.AxisFrame == GFrameCounter;
+		const int8 AxisX = bHeld ? Seat.AxisX : 0;
+		const int8 AxisY = bHeld ? Seat.AxisY : 0;
+		if (AxisX != Seat.WrittenX || AxisY != Seat.WrittenY)
+		{
+			Writer->WriteMove(SeatIndex, AxisX, AxisY);
+			Seat.WrittenX = AxisX;
+			Seat.WrittenY = AxisY;
+		}
+
+		if (Seat.Buttons != EReplayButtons::None)
+		{
+			Writer->WriteButtons(SeatIndex, Seat.Buttons);
+			Seat.Buttons = EReplayButtons::None;
+		}
+
+		const int32 CellIndex = Player->IsDead() ? INDEX_NONE : GetCellIndex(Player->GetActorLocation());
+		if (CellIndex != Seat.CellIndex)
+		{
+			if (CellIndex != INDEX_NONE) Writer->WritePlayerCell(SeatIndex, CellIndex);
+			Seat.CellIndex = CellIndex;
+		}
+	}
+
+	// Everything from here until the end of the next step belongs to the next tick
+	Writer->SetTick(Tick + 1);
+
+	if (bNeedsKeyframe || (Tick + 1) % KeyframeTicks == 0)
+	{
+		FSimRules Rules;
+		Grid->CaptureSimState(Rules, KeyframeState);
+		KeyframeState.Tick = int32(Tick + 1);
+		Writer->WriteKeyframe(KeyframeState);
+		bNeedsKeyframe = false;
+	}
+}
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Sim/BombermanBatchSimCommandlet.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#include "Core/BombermanLog.h"
+#include "Sim/BombermanSimBatch.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BombermanBatchSimCommandlet)
+
+UBombermanBatchSimCommandlet::UBombermanBatchSimCommandlet()
+{
+	IsClient	 = false;
+	IsServer	 = false;
+	IsEditor	 = false;
+	LogToConsole = true;
+}
+
+int32 UBombermanBatchSimCommandlet::Main(const FString& Params)
+{
+	FSimBatchConfig Config;
+	FParse::Value(*Params, TEXT("Matches="), Config.NumMatches);
+	FParse::Value(*Params, TEXT("Seed="), Config.BaseSeed);
+	FParse::Value(*Params, TEXT("Players="), Config.NumPlayers);
+	FParse::Value(*Params, TEXT("BlockPercent="), Config.BlockPercent);
+
+	int32 MatchSeconds = 0;
+	if (FParse::Value(*Params, TEXT("MatchSeconds="), MatchSeconds))
+	{
+		Config.Rules.MatchTicks = MatchSeconds * Config.Rules.TicksPerSecond;
+	}
+	Config.Rules.bRespawn  = !FParse::Param(*Params, TEXT("NoRespawn"));
+	Config.bSingleThreaded = FParse::Param(*Params, TEXT("SingleThreaded"));
+
+	// Policies per seat
+	FString PolicyList = TEXT("Greedy");
+	FParse::Value(*Params, TEXT("Policies="), PolicyList, false);
+
+	TArray<FString> PolicyNames;
+	PolicyList.ParseIntoArray(PolicyNames, TEXT(","));
+	for (const FString& Name : PolicyNames)
+	{
+		const FSimPolicyFunc Policy = BombermanSimPolicies::Find(Name);
+		if (!Policy)
+		{
+			UE_LOG(LogBomberman, Error, TEXT("Unknown policy: %s"), *Name);
+			return 1;
+		}
+		Config.SeatPolicies.Add(Policy);
+		Config.SeatPolicyNames.Add(Name);
+	}
+
+	// Map layouts, "Classic" generates one from the match seed
+	FString MapList;
+	if (FParse::Value(*Params, TEXT("Maps="), MapList, false))
+	{
+		TArray<FString> MapPaths;
+		MapList.ParseIntoArray(MapPaths, TEXT(","));
+		for (const FString& MapPath : MapPaths)
+		{
+			if (MapPath == TEXT("Classic"))
+			{
+				Config.Maps.Add(FSimMapLayout::Classic(13, 11, Config.BlockPercent, Config.BaseSeed));
+				continue;
+			}
+
+			TArray<FString> Rows;
+			const FSimMapLayout Layout = FFileHelper::LoadFileToStringArray(Rows, *MapPath) ? FSimMapLayout::FromRows(Rows) : FSimMapLayout();
+			if (!Layout.IsValid())
+			{
+				UE_LOG(LogBomberman, Error, TEXT("Could not load map layout: %s"), *MapPath);
+				return 1;
+			}
+			Config.Maps.Add(Layout);
+		}
+	}
+
+	FString OutPath = FPaths::ProjectSavedDir() / TEXT("BatchSim/Results.json");
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+
+	UE_LOG(LogBomberman, Display, TEXT("Running %d matches (%d players, policies %s)"), Config.NumMatches, Config.NumPlayers, *PolicyList);
+
+	const FSimBatchStats Stats = RunSimBatch(Config);
+
+	UE_LOG(LogBomberman, Display, TEXT("%d matches in %.2fs: %.0f matches/s, %.0f ticks/s"), Stats.Matches, Stats.WallSeconds, Stats.GetMatchesPerSecond(), Stats.GetTicksPerSecond());
+	for (int32 Index = 0; Index < Stats.PolicyNames.Num(); Index++)
+	{
+		UE_LOG(LogBomberman, Display, TEXT("  %s: %d wins over %d seats"), *Stats.PolicyNames[Index], Stats.PolicyWins[Index], Stats.PolicySeats[Index]);
+	}
+	UE_LOG(LogBomberman, Display, TEXT("  draws: %d, median length: %d ticks, detonations: %lld"), Stats.Draws, Stats.MedianTicks, Stats.Detonations);
+
+	if (!FFileHelper::SaveStringToFile(Stats.ToJson(), *OutPath))
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Could not write results to %s"), *OutPath);
+		return 1;
+	}
+	UE_LOG(LogBomberman, Display, TEXT("Results written to %s"), *OutPath);
+	return 0;
+}
@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Sim/BombermanGymCommandlet.h"
+
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformProcess.h"
+
+#include "Core/BombermanLog.h"
+#include "Sim/BombermanSimGym.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BombermanGymCommandlet)
+
+namespace
+{
+	constexpr int32 SharedAlignment = 64;
+
+	// Spins this long on a quiet command slot before sleeping between polls
+	constexpr int32 SpinsBeforeSleep = 4096;
+	constexpr float IdleSleepSeconds = 0.0002f;
+
+	int32 AddBlock(int32& Offset, int32 Size)
+	{
+		const int32 Start = Align(Offset, SharedAlignment);
+		Offset			  = Start + Size;
+		return Start;
+	}
+}
+
+UBombermanGymCommandlet::UBombermanGymCommandlet()
+{
+	IsClient	 = false;
+	IsServer	 = false;
+	IsEditor	 = false;
+	LogToConsole = true;
+}
+
+int32 UBombermanGymCommandlet::Main(const FString& Params)
+{
+	FSimGymConfig Config;
+	FParse::Value(*Params, TEXT("Envs="), Config.NumEnvs);
+	FParse::Value(*Params, TEXT("Players="), Config.NumPlayers);
+	FParse::Value(*Params, TEXT("Width="), Config.Width);
+	FParse::Value(*Params, TEXT("Height="), Config.Height);
+	FParse::Value(*Params, TEXT("BlockPercent="), Config.BlockPercent);
+	FParse::Value(*Params, TEXT("Seed="), Config.Seed);
+
+	int32 MatchSeconds = 0;
+	if (FParse::Value(*Params, TEXT("MatchSeconds="), MatchSeconds))
+	{
+		Config.Rules.MatchTicks = MatchSeconds * Config.Rules.TicksPerSecond;
+	}
+	Config.Rules.bRespawn  = !FParse::Param(*Params, TEXT("NoRespawn"));
+	Config.bSingleThreaded = FParse::Param(*Params, TEXT("SingleThreaded"));
+
+	FString Name = TEXT("BombermanGym");
+	FParse::Value(*Params, TEXT("Name="), Name);
+
+	FBombermanSimGym Gym(Config);
+	const FSimGymConfig& GymConfig = Gym.GetConfig();
+
+	// ===== Shared layout =====
+	FSimGymSharedHeader Layout;
+	FMemory::Memzero(Layout);
+	Layout.LayoutVersion  = FSimGymSharedHeader::Version;
+	Layout.NumEnvs		  = GymConfig.NumEnvs;
+	Layout.NumPlayers	  = GymConfig.NumPlayers;
+	Layout.Width		  = GymConfig.Width;
+	Layout.Height		  = GymConfig.Height;
+	Layout.NumPlanes	  = Gym.GetNumPlanes();
+	Layout.NumPlayerStats = SimGymPlayerStats;
+
+	int32 Offset			  = sizeof(FSimGymSharedHeader);
+	Layout.ActionsOffset	  = AddBlock(Offset, Gym.GetRewardsSize() * sizeof(int8));
+	Layout.RewardsOffset	  = AddBlock(Offset, Gym.GetRewardsSize() * sizeof(float));
+	Layout.DonesOffset		  = AddBlock(Offset, Gym.GetDonesSize());
+	Layout.PlayerStatsOffset  = AddBlock(Offset, Gym.GetPlayerStatsSize());
+	Layout.ObservationsOffset = AddBlock(Offset, Gym.GetObservationSize());
+	Layout.TotalSize		  = Align(Offset, SharedAlignment);
+
+	FPlatformMemory::FSharedMemoryRegion* Region = FPlatformMemory::MapNamedSharedMemoryRegion(
+		Name, true, FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write, Layout.TotalSize);
+	if (!Region)
+	{
+		UE_LOG(LogBomberman, Error, TEXT("Could not create shared memory region %s (%d bytes)"), *Name, Layout.TotalSize);
+		return 1;
+	}
+
+	uint8* Base					 = static_cast<uint8*>(Region->GetAddress());
+	FSimGymSharedHeader* Header = reinterpret_cast<FSimGymSharedHeader*>(Base);
+	FMemory::Memzero(Base, Layout.TotalSize);
+	FMemory::Memcpy(Header, &Layout, sizeof(Layout));
+
+	const TConstArrayView<int8> Actions(reinterpret_cast<const int8*>(Base + Layout.ActionsOffset), Gym.GetRewardsSize());
+	FSimGymBuffers Buffers;
+	Buffers.Observations = TArrayView<uint8>(Base + Layout.ObservationsOffset, Gym.GetObservationSize());
+	Buffers.PlayerStats	 = TArrayView<uint8>(Base + Layout.PlayerStatsOffset, Gym.GetPlayerStatsSize());
+	Buffers.Rewards		 = TArrayView<float>(reinterpret_cast<float*>(Base + Layout.RewardsOffset), Gym.GetRewardsSize());
+	Buffers.Dones		 = TArrayView<uint8>(Base + Layout.DonesOffset, Gym.GetDonesSize());
+
+	Gym.Reset(Buffers);
+
+	// Magic last, a trainer that sees it can trust the rest of the header
+	FPlatformMisc::MemoryBarrier();
+	Header->Magic = FSimGymSharedHeader::MagicValue;
+
+	UE_LOG(LogBomberman, Display, TEXT("Serving %d environments (%d players, %dx%d) on shared memory %s, %d bytes"),
+		GymConfig.NumEnvs, GymConfig.NumPlayers, GymConfig.Width, GymConfig.Height, *Name, Layout.TotalSize);
+
+	// ===== Command loop =====
+	int32 LastSeq		= 0;
+	int32 IdleSpins		= 0;
+	int64 Steps			= 0;
+	double ReportTime	= FPlatformTime::Seconds();
+	int64 ReportedSteps = 0;
+	while (!IsEngineExitRequested())
+	{
+		const int32 Seq = FPlatformAtomics::AtomicRead(&Header->CommandSeq);
+		if (Seq == LastSeq)
+		{
+			// Stay hot while the trainer is stepping, back off once it is busy elsewhere
+			if (++IdleSpins < SpinsBeforeSleep)
+			{
+				FPlatformProcess::YieldThread();
+			}
+			else
+			{
+				FPlatformProcess::Sleep(IdleSleepSeconds);
+			}
+			continue;
+		}
+		IdleSpins = 0;
+		LastSeq	  = Seq;
+
+		const ESimGymCommand Command = ESimGymCommand(FPlatformAtomics::AtomicRead(&Header->Command));
+		if (Command == ESimGymCommand::Close)
+		{
+			FPlatformAtomics::AtomicStore(&Header->DoneSeq, Seq);
+			break;
+		}
+		if (Command == ESimGymCommand::Reset)
+		{
+			Gym.Reset(Buffers);
+		}
+		else if (Command == ESimGymCommand::Step)
+		{
+			Gym.Step(Actions, Buffers);
+			Steps++;
+		}
+		else
+		{
+			UE_LOG(LogBomberman, Warning, TEXT("Unknown gym command %d"), int32(Command));
+		}
+		FPlatformAtomics::AtomicStore(&Header->DoneSeq, Seq);
+
+		const double Now = FPlatformTime::Seconds();
+		if (Now - ReportTime >= 10.0)
+		{
+			UE_LOG(LogBomberman, Display, TEXT("%.0f steps/s, %.0f env steps/s"), (Steps - ReportedSteps) / (Now - ReportTime), (Steps - ReportedSteps) * GymConfig.NumEnvs / (Now - ReportTime));
+			ReportTime	  = Now;
+			ReportedSteps = Steps;
+		}
+	}
+
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(Region);
+	UE_LOG(LogBomberman, Display, TEXT("Gym closed after %lld steps"), Steps);
+	return 0;
+}
@@ -0,0 +1,502 @@
+#include "Sim/BombermanSim.h"
+
+// ===== Map layouts =====
+
+FSimMapLayout FSimMapLayout::FromRows(TConstArrayView<FString> Rows)
+{
+	FSimMapLayout Layout;
+	Layout.Height = Rows.Num();
+	for (const FString& Row : Rows)
+	{
+		Layout.Width = FMath::Max(Layout.Width, Row.Len());
+	}
+	Layout.Cells.Init(EGridCellFlags::None, Layout.Width * Layout.Height);
+
+	TArray<TPair<TCHAR, FGridCoord>> Spawns;
+	for (int32 Y = 0; Y < Layout.Height; Y++)
+	{
+		for (int32 X = 0; X < Layout.Width; X++)
+		{
+			const TCHAR Char		= X < Rows[Y].Len() ? Rows[Y][X] : TEXT('#');
+			EGridCellFlags& Cell = Layout.Cells[Y * Layout.Width + X];
+
+			if (Char == TEXT('#')) Cell = EGridCellFlags::Wall;
+			else if (Char == TEXT('+')) Cell = EGridCellFlags::Block;
+			else if (Char >= TEXT('1') && Char <= TEXT('9')) Spawns.Add({Char, FGridCoord(X, Y)});
+		}
+	}
+
+	Spawns.Sort([](const TPair<TCHAR, FGridCoord>& A, const TPair<TCHAR, FGridCoord>& B) { return A.Key < B.Key; });
+	for (const TPair<TCHAR, FGridCoord>& Spawn : Spawns)
+	{
+		Layout.SpawnCells.Add(Spawn.Value);
+	}
+	return Layout;
+}
+
+FSimMapLayout FSimMapLayout::Classic(int32 Width, int32 Height, int32 BlockPercent, int32 Seed)
+{
+	FSimMapLayout Layout;
+	Layout.Width  = Width;
+	Layout.Height = Height;
+	Layout.Cells.Init(EGridCellFlags::None, Width * Height);
+	Layout.SpawnCells = {FGridCoord(1, 1), FGridCoord(Width - 2, Height - 2), FGridCoord(Width - 2, 1), FGridCoord(1, Height - 2)};
+
+	FRandomStream Random(Seed);
+	for (int32 Y = 0; Y < Height; Y++)
+	{
+		for (int32 X = 0; X < Width; X++)
+		{
+			EGridCellFlags& Cell = Layout.Cells[Y * Width + X];
+
+			const bool bBorder = X == 0 || Y == 0 || X == Width - 1 || Y == Height - 1;
+			if (bBorder || (X % 2 == 0 && Y % 2 == 0))
+			{
+				Cell = EGridCellFlags::Wall;
+				continue;
+			}
+
+			// Keep the spawn and its two neighbours free so nobody starts boxed in
+			bool bNearSpawn = false;
+			for (const FGridCoord& Spawn : Layout.SpawnCells)
+			{
+				bNearSpawn |= FMath::Abs(Spawn.X - X) + FMath::Abs(Spawn.Y - Y) <= 1;
+			}
+
+			if (!bNearSpawn && Random.RandRange(0, 99) < BlockPercent)
+			{
+				Cell = EGridCellFlags::Block;
+			}
+		}
+	}
+	return Layout;
+}
+
+// ===== State =====
+
+int32 FSimState::FindBomb(FGridCoord Cell) const
+{
+	return Bombs.IndexOfByPredicate([Cell](const FSimBomb& Bomb) { return Bomb.Cell == Cell; });
+}
+
+int32 FSimState::NumAlivePlayers() const
+{
+	int32 Count = 0;
+	for (const FSimPlayer& Player : Players)
+	{
+		Count += Player.bAlive ? 1 : 0;
+	}
+	return Count;
+}
+
+// ===== Simulation =====
+
+FBombermanSim::FBombermanSim(const FSimRules& InRules)
+	: Rules(InRules)
+{
+	// A chained bomb always goes off on a later tick than the bomb that reached it
+	Rules.ChainDelayTicks = FMath::Max(1, Rules.ChainDelayTicks);
+}
+
+void FBombermanSim::Reset(const FSimMapLayout& Layout, int32 NumPlayers, int32 Seed)
+{
+	State = FSimState();
+	State.Grid.Init(FGridCoord(), Layout.Width, Layout.Height, float(Rules.CellSize));
+	State.Grid.Cells = Layout.Cells;
+	State.Powerups.Init(ESimPowerup::None, State.Grid.Num());
+	State.BurnTicks.Init(0, State.Grid.Num());
+	State.BurnOwners.Init(INDEX_NONE, State.Grid.Num());
+	State.Random.Initialize(Seed);
+
+	const int32 Count = FMath::Min(NumPlayers, Layout.SpawnCells.Num());
+	for (int32 Index = 0; Index < Count; Index++)
+	{
+		FSimPlayer& Player = State.Players.AddDefaulted_GetRef();
+		Player.Cell		   = Layout.SpawnCells[Index];
+		Player.SpawnCell   = Layout.SpawnCells[Index];
+		Player.MoveSpeed   = Rules.BaseMoveSpeed;
+	}
+	SyncPlayerFlags();
+}
+
+void FBombermanSim::Reset(const FSimState& InState)
+{
+	State = InState;
+	SyncPlayerFlags();
+}
+
+void FBombermanSim::Step(TConstArrayView<FSimInput> Inputs)
+{
+	State.Events.Reset();
+
+	for (int32 Index = 0; Index < State.Players.Num(); Index++)
+	{
+		if (State.Players[Index].bAlive && Inputs.IsValidIndex(Index))
+		{
+			ApplyInput(Index, Inputs[Index]);
+		}
+	}
+	SyncPlayerFlags();
+
+	UpdateKicks();
+	UpdateFuses();
+	Detonate();
+	ApplyDamage();
+	UpdatePlayers();
+
+	State.Tick++;
+}
+
+bool FBombermanSim::IsFinished() const
+{
+	if (State.Tick >= Rules.MatchTicks) return true;
+
+	return !Rules.bRespawn && State.Players.Num() > 1 && State.NumAlivePlayers() <= 1;
+}
+
+FSimMatchResult FBombermanSim::GetResult() const
+{
+	FSimMatchResult Result;
+	Result.Ticks = State.Tick;
+
+	if (!Rules.bRespawn)
+	{
+		// Last player standing
+		if (State.NumAlivePlayers() == 1)
+		{
+			Result.Winner = State.Players.IndexOfByPredicate([](const FSimPlayer& Player) { return Player.bAlive; });
+		}
+		return Result;
+	}
+
+	// Best kills minus deaths, a tie is a draw
+	int32 BestScore = TNumericLimits<int32>::Lowest();
+	for (int32 Index = 0; Index < State.Players.Num(); Index++)
+	{
+		const int32 Score = State.Players[Index].Kills - State.Players[Index].Deaths;
+		if (Score > BestScore)
+		{
+			BestScore	  = Score;
+			Result.Winner = Index;
+		}
+		else if (Score == BestScore)
+		{
+			Result.Winner = INDEX_NONE;
+		}
+	}
+	return Result;
+}
+
+// ===== Input =====
+
+void FBombermanSim::ApplyInput(int32 PlayerIndex, const FSimInput& Input)
+{
+	FSimPlayer& Player = State.Players[PlayerIndex];
+
+	// Actions use the cell the player stands on before this tick's move
+	if (Input.bPlaceBomb)
+	{
+		PlaceBomb(PlayerIndex);
+	}
+	if (Input.bKick)
+	{
+		KickBomb(Player, PlayerIndex);
+	}
+	if (Input.MoveDir >= 0 && Input.MoveDir < 4)
+	{
+		MovePlayer(Player, PlayerIndex, Input.MoveDir);
+	}
+}
+
+void FBombermanSim::MovePlayer(FSimPlayer& Player, int32 PlayerIndex, int32 Dir)
+{
+	Player.Facing = Dir;
+	if (Player.MoveCooldown > 0) return;
+
+	const FGridCoord Target = Player.Cell + GridDirections[Dir];
+	if (State.Grid.HasAny(Target, EGridCellFlags::Wall | EGridCellFlags::Block | EGridCellFlags::Bomb)) return;
+
+	Player.Cell			= Target;
+	Player.MoveCooldown = Rules.GetMoveTicksPerCell(Player.MoveSpeed);
+
+	const int32 Index = State.Grid.ToIndex(Target);
+	if (State.Powerups[Index] != ESimPowerup::None)
+	{
+		PickupPowerup(Player, PlayerIndex, Target);
+	}
+}
+
+void FBombermanSim::PickupPowerup(FSimPlayer& Player, int32 PlayerIndex, FGridCoord Cell)
+{
+	const int32 Index		 = State.Grid.ToIndex(Cell);
+	const ESimPowerup Type = State.Powerups[Index];
+
+	switch (Type)
+	{
+		case ESimPowerup::BombCount: Player.MaxBombCount = FMath::Min(Player.MaxBombCount + 1, Rules.MaxBombCount); break;
+		case ESimPowerup::BombPower: Player.BombPower = FMath::Min(Player.BombPower + 1, Rules.MaxBombPower); break;
+		case ESimPowerup::Speed: Player.MoveSpeed = FMath::Min(Player.MoveSpeed + Rules.MoveSpeedStep, Rules.MaxMoveSpeed); break;
+		case ESimPowerup::KickBomb: Player.bCanKickBombs = true; break;
+		default: break;
+	}
+
+	State.Powerups[Index] = ESimPowerup::None;
+	State.Grid.Remove(Cell, EGridCellFlags::Powerup);
+	AddEvent(ESimEventType::PowerupTaken, Cell, PlayerIndex, int32(Type));
+}
+
+void FBombermanSim::PlaceBomb(int32 PlayerIndex)
+{
+	FSimPlayer& Player = State.Players[PlayerIndex];
+	if (Player.ActiveBombs >= Player.MaxBombCount) return;
+	if (State.Grid.HasAny(Player.Cell, EGridCellFlags::PlaceStop)) return;
+
+	FSimBomb& Bomb = State.Bombs.AddDefaulted_GetRef();
+	Bomb.Cell	   = Player.Cell;
+	Bomb.Owner	   = PlayerIndex;
+	Bomb.Range	   = Player.BombPower;
+	Bomb.FuseTicks = Rules.FuseTicks;
+
+	State.Grid.Add(Player.Cell, EGridCellFlags::Bomb);
+	Player.ActiveBombs++;
+
+	AddEvent(ESimEventType::BombPlaced, Player.Cell, PlayerIndex);
+}
+
+void FBombermanSim::KickBomb(FSimPlayer& Player, int32 PlayerIndex)
+{
+	if (!Player.bCanKickBombs) return;
+
+	// Same lookup as ABombermanCharacter::FindNearbyBomb: the facing cell, then the own cell
+	int32 BombIndex = State.FindBomb(Player.Cell + GridDirections[Player.Facing]);
+	if (BombIndex == INDEX_NONE) BombIndex = State.FindBomb(Player.Cell);
+	if (BombIndex == INDEX_NONE) return;
+
+	FSimBomb& Bomb = State.Bombs[BombIndex];
+	if (Bomb.KickDir != INDEX_NONE || Bomb.FuseTicks <= Rules.ChainDelayTicks) return;
+
+	Bomb.KickDir	   = Player.Facing;
+	Bomb.KickCellsLeft = Rules.KickMaxCells;
+	Bomb.KickTicks	   = Rules.GetKickTicksPerCell();
+
+	AddEvent(ESimEventType::BombKicked, Bomb.Cell, PlayerIndex, Player.Facing);
+}
+
+// ===== Bombs =====
+
+void FBombermanSim::UpdateKicks()
+{
+	for (FSimBomb& Bomb : State.Bombs)
+	{
+		if (Bomb.KickDir == INDEX_NONE || --Bomb.KickTicks > 0) continue;
+
+		const FGridCoord Next = Bomb.Cell + GridDirections[Bomb.KickDir];
+		if (State.Grid.HasAny(Next, EGridCellFlags::KickStop))
+		{
+			Bomb.KickDir = INDEX_NONE;
+			continue;
+		}
+
+		State.Grid.Remove(Bomb.Cell, EGridCellFlags::Bomb);
+		State.Grid.Add(Next, EGridCellFlags::Bomb);
+		Bomb.Cell = Next;
+
+		if (--Bomb.KickCellsLeft <= 0)
+		{
+			Bomb.KickDir = INDEX_NONE;
+			continue;
+		}
+		Bomb.KickTicks = Rules.GetKickTicksPerCell();
+	}
+}
+
+void FBombermanSim::UpdateFuses()
+{
+	for (uint16& Burn : State.BurnTicks)
+	{
+		if (Burn > 0) Burn--;
+	}
+
+	for (FSimBomb& Bomb : State.Bombs)
+	{
+		Bomb.FuseTicks--;
+
+		// Bombs placed or kicked into a burning cell chain like AExplosion's overlap did
+		if (State.BurnTicks[State.Grid.ToIndex(Bomb.Cell)] > 0 && Bomb.FuseTicks > Rules.ChainDelayTicks)
+		{
+			Bomb.FuseTicks = Rules.ChainDelayTicks;
+			Bomb.KickDir   = INDEX_NONE;
+		}
+	}
+}
+
+void FBombermanSim::Detonate()
+{
+	Detonating.Reset();
+	for (int32 Index = 0; Index < State.Bombs.Num(); Index++)
+	{
+		if (State.Bombs[Index].FuseTicks <= 0) Detonating.Add(Index);
+	}
+	if (Detonating.Num() == 0) return;
+
+	// All blasts of this tick read the grid as it was before any of them, like the batched chain resolve
+	BlocksToClear.Reset();
+	for (const int32 BombIndex : Detonating)
+	{
+		const FSimBomb& Bomb = State.Bombs[BombIndex];
+
+		State.Grid.ForEachBlastCell(Bomb.Cell, Bomb.Range, [&](FGridCoord Cell, int32 Distance, bool bIsEnd, EGridCellFlags Flags)
+		{
+			if (!State.Grid.Contains(Cell)) return;
+
+			const int32 Index		 = State.Grid.ToIndex(Cell);
+			State.BurnTicks[Index]	 = uint16(Rules.ExplosionTicks);
+			State.BurnOwners[Index] = int8(Bomb.Owner);
+
+			if (EnumHasAnyFlags(Flags, EGridCellFlags::Block))
+			{
+				BlocksToClear.AddUnique(Cell);
+			}
+
+			// Chain into the bomb sitting on this cell, frozen until it goes off
+			if (Distance > 0 && EnumHasAnyFlags(Flags, EGridCellFlags::Bomb))
+			{
+				const int32 ChainedIndex = State.FindBomb(Cell);
+				if (ChainedIndex != INDEX_NONE && State.Bombs[ChainedIndex].FuseTicks > 0)
+				{
+					FSimBomb& Chained  = State.Bombs[ChainedIndex];
+					Chained.FuseTicks  = FMath::Min(Chained.FuseTicks, Rules.ChainDelayTicks);
+					Chained.ChainDepth = FMath::Max(Chained.ChainDepth, Bomb.ChainDepth + 1);
+					Chained.KickDir	   = INDEX_NONE;
+				}
+			}
+		});
+
+		AddEvent(ESimEventType::BombDetonated, Bomb.Cell, Bomb.Owner, Bomb.ChainDepth);
+
+		if (Bomb.bCountsForOwner && State.Players.IsValidIndex(Bomb.Owner))
+		{
+			FSimPlayer& Owner = State.Players[Bomb.Owner];
+			Owner.ActiveBombs = FMath::Max(0, Owner.ActiveBombs - 1);
+		}
+	}
+
+	// Back to front so the remaining indices stay valid and bombs keep their placement order
+	for (int32 Index = Detonating.Num() - 1; Index >= 0; Index--)
+	{
+		State.Grid.Remove(State.Bombs[Detonating[Index]].Cell, EGridCellFlags::Bomb);
+		State.Bombs.RemoveAt(Detonating[Index], 1, EAllowShrinking::No);
+	}
+
+	for (const FGridCoord& Cell : BlocksToClear)
+	{
+		State.Grid.Remove(Cell, EGridCellFlags::Block);
+		AddEvent(ESimEventType::BlockDestroyed, Cell, INDEX_NONE);
+		SpawnPowerup(Cell);
+	}
+}
+
+void FBombermanSim::SpawnPowerup(FGridCoord Cell)
+{
+	if (State.Random.RandRange(0, 99) >= Rules.PowerupChance) return;
+
+	const ESimPowerup Type = ESimPowerup(State.Random.RandRange(int32(ESimPowerup::BombCount), int32(ESimPowerup::Num) - 1));
+	State.Powerups[State.Grid.ToIndex(Cell)] = Type;
+	State.Grid.Add(Cell, EGridCellFlags::Powerup);
+}
+
+// ===== Players =====
+
+void FBombermanSim::ApplyDamage()
+{
+	for (int32 Index = 0; Index < State.Players.Num(); Index++)
+	{
+		const FSimPlayer& Player = State.Players[Index];
+		if (!Player.bAlive || Player.InvincibleTicks > 0) continue;
+
+		const int32 CellIndex = State.Grid.ToIndex(Player.Cell);
+		if (State.BurnTicks[CellIndex] == 0) continue;
+
+		const int32 Killer = State.BurnOwners[CellIndex];
+		if (Killer == Index && !Rules.bSelfDamage) continue;
+
+		KillPlayer(Index, Killer);
+	}
+}
+
+void FBombermanSim::KillPlayer(int32 PlayerIndex, int32 Killer)
+{
+	FSimPlayer& Player = State.Players[PlayerIndex];
+	Player.bAlive	   = false;
+	Player.Deaths++;
+	Player.RespawnTicks = Rules.RespawnTicks;
+
+	if (Killer != PlayerIndex && State.Players.IsValidIndex(Killer))
+	{
+		State.Players[Killer].Kills++;
+	}
+
+	// ABombermanCharacter::Die: every placed bomb goes off and the count starts over
+	for (FSimBomb& Bomb : State.Bombs)
+	{
+		if (Bomb.Owner != PlayerIndex) continue;
+
+		Bomb.FuseTicks		 = FMath::Min(Bomb.FuseTicks, 1);
+		Bomb.bCountsForOwner = false;
+	}
+	Player.ActiveBombs = 0;
+
+	AddEvent(ESimEventType::PlayerDied, Player.Cell, PlayerIndex, Killer);
+}
+
+void FBombermanSim::RespawnPlayer(int32 PlayerIndex)
+{
+	// ABombermanCharacter::Respawn resets every ability
+	FSimPlayer& Player	  = State.Players[PlayerIndex];
+	Player.bAlive		  = true;
+	Player.Cell			  = Player.SpawnCell;
+	Player.MaxBombCount	  = 1;
+	Player.BombPower	  = 1;
+	Player.MoveSpeed	  = Rules.BaseMoveSpeed;
+	Player.bCanKickBombs  = false;
+	Player.ActiveBombs	  = 0;
+	Player.MoveCooldown	  = 0;
+	Player.InvincibleTicks = Rules.InvincibleTicks;
+
+	AddEvent(ESimEventType::PlayerRespawned, Player.Cell, PlayerIndex);
+}
+
+void FBombermanSim::UpdatePlayers()
+{
+	for (int32 Index = 0; Index < State.Players.Num(); Index++)
+	{
+		FSimPlayer& Player = State.Players[Index];
+
+		if (Player.MoveCooldown > 0) Player.MoveCooldown--;
+		if (Player.InvincibleTicks > 0) Player.InvincibleTicks--;
+
+		if (!Player.bAlive && Rules.bRespawn && --Player.RespawnTicks <= 0)
+		{
+			RespawnPlayer(Index);
+		}
+	}
+	SyncPlayerFlags();
+}
+
+void FBombermanSim::SyncPlayerFlags()
+{
+	// Players can share a cell, so clear all of them before setting the new ones
+	for (EGridCellFlags& Cell : State.Grid.Cells)
+	{
+		Cell &= ~EGridCellFlags::Player;
+	}
+	for (const FSimPlayer& Player : State.Players)
+	{
+		if (Player.bAlive) State.Grid.Add(Player.Cell, EGridCellFlags::Player);
+	}
+}
+
+void FBombermanSim::AddEvent(ESimEventType Type, FGridCoord Cell, int32 Player, int32 Value)
+{
+	State.Events.Add({Type, Cell, int16(Player), int16(Value)});
+}
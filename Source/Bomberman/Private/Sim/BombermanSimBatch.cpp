@@ -0,0 +1,174 @@
+#include "Sim/BombermanSimBatch.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+	struct FSimMatchRecord
+	{
+		FSimMatchResult Result;
+		int32 Detonations	  = 0;
+		int32 BlocksDestroyed = 0;
+		int32 Deaths		  = 0;
+		int32 ChainDepths[SimMaxChainDepthBucket + 1] = {};
+	};
+
+	void RunMatch(const FSimBatchConfig& Config, int32 MatchIndex, FSimMatchRecord& OutRecord)
+	{
+		const int32 Seed = Config.BaseSeed + MatchIndex;
+
+		FBombermanSim Sim(Config.Rules);
+		if (Config.Maps.Num() > 0)
+		{
+			Sim.Reset(Config.Maps[MatchIndex % Config.Maps.Num()], Config.NumPlayers, Seed);
+		}
+		else
+		{
+			Sim.Reset(FSimMapLayout::Classic(13, 11, Config.BlockPercent, Seed), Config.NumPlayers, Seed);
+		}
+
+		const int32 NumPlayers = Sim.GetState().Players.Num();
+		const FRandomStream PolicyRandom(Seed ^ 0x2545F491);
+
+		TArray<FSimInput> Inputs;
+		Inputs.SetNum(NumPlayers);
+		TArray<FSimPolicyScratch> Scratches;
+		Scratches.SetNum(NumPlayers);
+
+		while (!Sim.IsFinished())
+		{
+			for (int32 Seat = 0; Seat < NumPlayers; Seat++)
+			{
+				const FSimPolicyFunc Policy = Config.SeatPolicies[Seat % Config.SeatPolicies.Num()];
+				Policy(Sim.GetState(), Seat, PolicyRandom, Scratches[Seat], Inputs[Seat]);
+			}
+			Sim.Step(Inputs);
+
+			for (const FSimEvent& Event : Sim.GetState().Events)
+			{
+				switch (Event.Type)
+				{
+					case ESimEventType::BombDetonated:
+						OutRecord.Detonations++;
+						OutRecord.ChainDepths[FMath::Min(int32(Event.Value), SimMaxChainDepthBucket)]++;
+						break;
+					case ESimEventType::BlockDestroyed: OutRecord.BlocksDestroyed++; break;
+					case ESimEventType::PlayerDied: OutRecord.Deaths++; break;
+					default: break;
+				}
+			}
+		}
+
+		OutRecord.Result = Sim.GetResult();
+	}
+}
+
+FSimBatchStats RunSimBatch(const FSimBatchConfig& Config)
+{
+	FSimBatchStats Stats;
+	if (Config.NumMatches <= 0 || Config.SeatPolicies.Num() == 0) return Stats;
+
+	TArray<FSimMatchRecord> Records;
+	Records.SetNum(Config.NumMatches);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Match lengths vary a lot, let idle workers steal the remaining matches
+	const EParallelForFlags Flags = Config.bSingleThreaded ? EParallelForFlags::ForceSingleThread : EParallelForFlags::Unbalanced;
+	ParallelFor(Config.NumMatches, [&Config, &Records](int32 MatchIndex)
+	{
+		RunMatch(Config, MatchIndex, Records[MatchIndex]);
+	}, Flags);
+
+	Stats.WallSeconds = FPlatformTime::Seconds() - StartTime;
+
+	// ===== Aggregate =====
+	const int32 NumSeats = Config.NumPlayers;
+	Stats.Matches		 = Config.NumMatches;
+	Stats.WinsBySeat.Init(0, NumSeats);
+	Stats.ChainDepthHistogram.Init(0, SimMaxChainDepthBucket + 1);
+
+	TArray<int32> SeatPolicyIndex;
+	for (int32 Seat = 0; Seat < NumSeats; Seat++)
+	{
+		const int32 Slot   = Seat % Config.SeatPolicies.Num();
+		const FString Name = Config.SeatPolicyNames.IsValidIndex(Slot) ? Config.SeatPolicyNames[Slot] : FString::Printf(TEXT("Policy%d"), Slot);
+
+		int32 PolicyIndex = Stats.PolicyNames.Find(Name);
+		if (PolicyIndex == INDEX_NONE)
+		{
+			PolicyIndex = Stats.PolicyNames.Add(Name);
+			Stats.PolicySeats.Add(0);
+			Stats.PolicyWins.Add(0);
+		}
+		Stats.PolicySeats[PolicyIndex] += Config.NumMatches;
+		SeatPolicyIndex.Add(PolicyIndex);
+	}
+
+	TArray<int32> Lengths;
+	Lengths.Reserve(Records.Num());
+	for (const FSimMatchRecord& Record : Records)
+	{
+		const int32 Winner = Record.Result.Winner;
+		if (Stats.WinsBySeat.IsValidIndex(Winner))
+		{
+			Stats.WinsBySeat[Winner]++;
+			Stats.PolicyWins[SeatPolicyIndex[Winner]]++;
+		}
+		else
+		{
+			Stats.Draws++;
+		}
+
+		Stats.TotalTicks += Record.Result.Ticks;
+		Lengths.Add(Record.Result.Ticks);
+
+		Stats.Detonations += Record.Detonations;
+		Stats.BlocksDestroyed += Record.BlocksDestroyed;
+		Stats.Deaths += Record.Deaths;
+		for (int32 Depth = 0; Depth <= SimMaxChainDepthBucket; Depth++)
+		{
+			Stats.ChainDepthHistogram[Depth] += Record.ChainDepths[Depth];
+		}
+	}
+
+	Lengths.Sort();
+	Stats.MinTicks	  = Lengths[0];
+	Stats.MaxTicks	  = Lengths.Last();
+	Stats.MedianTicks = Lengths[Lengths.Num() / 2];
+	Stats.P95Ticks	  = Lengths[FMath::Min(Lengths.Num() - 1, Lengths.Num() * 95 / 100)];
+
+	return Stats;
+}
+
+FString FSimBatchStats::ToJson() const
+{
+	FString Json = TEXT("{\n");
+	Json += FString::Printf(TEXT("\t\"matches\": %d,\n\t\"draws\": %d,\n"), Matches, Draws);
+	Json += FString::Printf(TEXT("\t\"wallSeconds\": %.3f,\n\t\"matchesPerSecond\": %.1f,\n\t\"ticksPerSecond\": %.1f,\n"), WallSeconds, GetMatchesPerSecond(), GetTicksPerSecond());
+
+	Json += TEXT("\t\"winsBySeat\": [");
+	for (int32 Seat = 0; Seat < WinsBySeat.Num(); Seat++)
+	{
+		Json += FString::Printf(TEXT("%s%d"), Seat > 0 ? TEXT(", ") : TEXT(""), WinsBySeat[Seat]);
+	}
+	Json += TEXT("],\n\t\"policies\": [");
+	for (int32 Index = 0; Index < PolicyNames.Num(); Index++)
+	{
+		const double WinRate = PolicySeats[Index] > 0 ? double(PolicyWins[Index]) / PolicySeats[Index] : 0.0;
+		Json += FString::Printf(TEXT("%s{\"name\": \"%s\", \"seats\": %d, \"wins\": %d, \"winRate\": %.4f}"), Index > 0 ? TEXT(", ") : TEXT(""), *PolicyNames[Index], PolicySeats[Index], PolicyWins[Index], WinRate);
+	}
+
+	const double AverageTicks = Matches > 0 ? double(TotalTicks) / Matches : 0.0;
+	Json += FString::Printf(TEXT("],\n\t\"matchTicks\": {\"average\": %.1f, \"min\": %d, \"median\": %d, \"p95\": %d, \"max\": %d},\n"), AverageTicks, MinTicks, MedianTicks, P95Ticks, MaxTicks);
+	Json += FString::Printf(TEXT("\t\"detonations\": %lld,\n\t\"blocksDestroyed\": %lld,\n\t\"deaths\": %lld,\n"), Detonations, BlocksDestroyed, Deaths);
+
+	Json += TEXT("\t\"chainDepthHistogram\": [");
+	for (int32 Depth = 0; Depth < ChainDepthHistogram.Num(); Depth++)
+	{
+		Json += FString::Printf(TEXT("%s%lld"), Depth > 0 ? TEXT(", ") : TEXT(""), ChainDepthHistogram[Depth]);
+	}
+	Json += TEXT("]\n}\n");
+	return Json;
+}
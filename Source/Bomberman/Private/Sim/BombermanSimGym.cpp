@@ -0,0 +1,154 @@
+#include "Sim/BombermanSimGym.h"
+
+#include "Async/ParallelFor.h"
+
+#include "Sim/BombermanSimMcts.h"
+
+namespace
+{
+	// Fuse ticks left on the 1..255 scale of the Bombs and Danger planes, sooner is brighter
+	uint8 FuseToByte(int32 FuseTicks, int32 MaxFuseTicks)
+	{
+		const int32 Clamped = FMath::Clamp(FuseTicks, 0, MaxFuseTicks);
+		return uint8(255 - Clamped * 254 / FMath::Max(1, MaxFuseTicks));
+	}
+}
+
+FBombermanSimGym::FBombermanSimGym(const FSimGymConfig& InConfig)
+	: Config(InConfig)
+{
+	Config.NumEnvs	  = FMath::Max(1, Config.NumEnvs);
+	Config.NumPlayers = FMath::Clamp(Config.NumPlayers, 1, 4);
+
+	Envs.Reserve(Config.NumEnvs);
+	for (int32 EnvIndex = 0; EnvIndex < Config.NumEnvs; EnvIndex++)
+	{
+		FEnv& Env = Envs.Emplace_GetRef(Config.Rules);
+		Env.Inputs.SetNum(Config.NumPlayers);
+	}
+}
+
+void FBombermanSimGym::Reset(const FSimGymBuffers& Buffers)
+{
+	check(Buffers.Observations.Num() >= GetObservationSize() && Buffers.PlayerStats.Num() >= GetPlayerStatsSize());
+	check(Buffers.Rewards.Num() >= GetRewardsSize() && Buffers.Dones.Num() >= GetDonesSize());
+
+	ParallelFor(Envs.Num(), [this, &Buffers](int32 EnvIndex)
+	{
+		ResetEnv(EnvIndex);
+		WriteObservation(EnvIndex, Buffers);
+
+		FMemory::Memzero(&Buffers.Rewards[EnvIndex * Config.NumPlayers], Config.NumPlayers * sizeof(float));
+		Buffers.Dones[EnvIndex] = 0;
+	}, Config.bSingleThreaded ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
+void FBombermanSimGym::Step(TConstArrayView<int8> Actions, const FSimGymBuffers& Buffers)
+{
+	check(Buffers.Observations.Num() >= GetObservationSize() && Buffers.PlayerStats.Num() >= GetPlayerStatsSize());
+	check(Buffers.Rewards.Num() >= GetRewardsSize() && Buffers.Dones.Num() >= GetDonesSize());
+
+	// Every environment costs about the same tick, plain chunks are enough
+	ParallelFor(Envs.Num(), [this, Actions, &Buffers](int32 EnvIndex)
+	{
+		StepEnv(EnvIndex, Actions, Buffers);
+	}, Config.bSingleThreaded ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
+void FBombermanSimGym::ResetEnv(int32 EnvIndex)
+{
+	FEnv& Env		 = Envs[EnvIndex];
+	const int32 Seed = int32(HashCombine(uint32(Config.Seed), HashCombine(uint32(EnvIndex), uint32(Env.Episode++))));
+	Env.Sim.Reset(FSimMapLayout::Classic(Config.Width, Config.Height, Config.BlockPercent, Seed), Config.NumPlayers, Seed);
+}
+
+void FBombermanSimGym::StepEnv(int32 EnvIndex, TConstArrayView<int8> Actions, const FSimGymBuffers& Buffers)
+{
+	FEnv& Env			 = Envs[EnvIndex];
+	const int32 FirstSeat = EnvIndex * Config.NumPlayers;
+
+	for (int32 Seat = 0; Seat < Config.NumPlayers; Seat++)
+	{
+		const int32 Action = Actions.IsValidIndex(FirstSeat + Seat) ? Actions[FirstSeat + Seat] : INDEX_NONE;
+		Env.Inputs[Seat]   = Action >= 0 && Action < int32(ESimMctsAction::Num) ? FBombermanSimMcts::ToInput(ESimMctsAction(Action)) : FSimInput();
+	}
+
+	// Rewards from the scores, so respawns and chained kills need no event bookkeeping
+	const TArray<FSimPlayer>& Players = Env.Sim.GetState().Players;
+	for (int32 Seat = 0; Seat < Config.NumPlayers; Seat++)
+	{
+		const bool bSeated					= Players.IsValidIndex(Seat);
+		Buffers.Rewards[FirstSeat + Seat] = bSeated ? -float(Players[Seat].Kills - Players[Seat].Deaths) : 0.0f;
+	}
+
+	Env.Sim.Step(Env.Inputs);
+
+	for (int32 Seat = 0; Seat < Config.NumPlayers; Seat++)
+	{
+		if (Players.IsValidIndex(Seat)) Buffers.Rewards[FirstSeat + Seat] += float(Players[Seat].Kills - Players[Seat].Deaths);
+	}
+
+	// Auto-reset: the observation of a finished environment is already the next episode's first
+	const bool bDone		= Env.Sim.IsFinished();
+	Buffers.Dones[EnvIndex] = bDone ? 1 : 0;
+	if (bDone) ResetEnv(EnvIndex);
+
+	WriteObservation(EnvIndex, Buffers);
+}
+
+void FBombermanSimGym::WriteObservation(int32 EnvIndex, const FSimGymBuffers& Buffers) const
+{
+	const FSimState& State	   = Envs[EnvIndex].Sim.GetState();
+	const FBombermanGrid& Grid = State.Grid;
+	const int32 PlaneSize	   = GetPlaneSize();
+	const int32 MaxFuseTicks   = Config.Rules.FuseTicks;
+
+	uint8* Planes = &Buffers.Observations[EnvIndex * GetNumPlanes() * PlaneSize];
+	FMemory::Memzero(Planes, GetNumPlanes() * PlaneSize);
+
+	auto Plane = [Planes, PlaneSize](ESimGymPlane Type, int32 Offset = 0) { return Planes + (int32(Type) + Offset) * PlaneSize; };
+	uint8* Walls	= Plane(ESimGymPlane::Walls);
+	uint8* Blocks	= Plane(ESimGymPlane::Blocks);
+	uint8* Bombs	= Plane(ESimGymPlane::Bombs);
+	uint8* Danger	= Plane(ESimGymPlane::Danger);
+	uint8* Powerups = Plane(ESimGymPlane::Powerups);
+
+	// Layouts are generated at the configured size, so grid and plane indices match
+	for (int32 Index = 0; Index < FMath::Min(Grid.Num(), PlaneSize); Index++)
+	{
+		const EGridCellFlags Flags = Grid.Cells[Index];
+		Walls[Index]			   = EnumHasAnyFlags(Flags, EGridCellFlags::Wall) ? 255 : 0;
+		Blocks[Index]			   = EnumHasAnyFlags(Flags, EGridCellFlags::Block) ? 255 : 0;
+		Danger[Index]			   = State.BurnTicks[Index] > 0 ? 255 : 0;
+		Powerups[Index]			   = uint8(State.Powerups[Index]);
+	}
+
+	for (const FSimBomb& Bomb : State.Bombs)
+	{
+		const uint8 Fuse = FuseToByte(Bomb.FuseTicks, MaxFuseTicks);
+		if (Grid.Contains(Bomb.Cell)) Bombs[Grid.ToIndex(Bomb.Cell)] = Fuse;
+
+		Grid.ForEachBlastCell(Bomb.Cell, Bomb.Range, [&Grid, Danger, Fuse](FGridCoord Cell, int32, bool, EGridCellFlags)
+		{
+			if (Grid.Contains(Cell)) Danger[Grid.ToIndex(Cell)] = FMath::Max(Danger[Grid.ToIndex(Cell)], Fuse);
+		});
+	}
+
+	uint8* Stats = &Buffers.PlayerStats[EnvIndex * Config.NumPlayers * SimGymPlayerStats];
+	FMemory::Memzero(Stats, Config.NumPlayers * SimGymPlayerStats);
+	for (int32 Seat = 0; Seat < FMath::Min(Config.NumPlayers, State.Players.Num()); Seat++)
+	{
+		const FSimPlayer& Player = State.Players[Seat];
+		if (Player.bAlive && Grid.Contains(Player.Cell))
+		{
+			Plane(ESimGymPlane::FirstPlayer, Seat)[Grid.ToIndex(Player.Cell)] = 255;
+		}
+
+		uint8* PlayerStats = Stats + Seat * SimGymPlayerStats;
+		PlayerStats[0]	   = uint8(Player.MaxBombCount);
+		PlayerStats[1]	   = uint8(Player.BombPower);
+		PlayerStats[2]	   = uint8((Player.MoveSpeed - Config.Rules.BaseMoveSpeed) / FMath::Max(1, Config.Rules.MoveSpeedStep));
+		PlayerStats[3]	   = Player.bCanKickBombs ? 1 : 0;
+		PlayerStats[4]	   = Player.bAlive ? 1 : 0;
+	}
+}
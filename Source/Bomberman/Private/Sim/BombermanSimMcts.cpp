@@ -0,0 +1,297 @@
+#include "Sim/BombermanSimMcts.h"
+
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+
+namespace
+{
+	constexpr int32 NumActions = int32(ESimMctsAction::Num);
+
+	// Kills count most, then powerups, then digging, each saturating so survival stays on top
+	constexpr float SurviveValue = 0.4f;
+	constexpr float KillValue	 = 0.3f;
+	constexpr float AbilityValue = 0.15f;
+	constexpr float BlockValue	 = 0.15f;
+}
+
+FBombermanSimMcts::FBombermanSimMcts(const FSimRules& InRules)
+	: Rules(InRules)
+{
+}
+
+FSimInput FBombermanSimMcts::ToInput(ESimMctsAction Action)
+{
+	FSimInput Input;
+	switch (Action)
+	{
+		case ESimMctsAction::PlaceBomb: Input.bPlaceBomb = true; break;
+		case ESimMctsAction::Kick: Input.bKick = true; break;
+		case ESimMctsAction::Wait: break;
+		default: Input.MoveDir = int8(Action); break;
+	}
+	return Input;
+}
+
+FSimMctsResult FBombermanSimMcts::Search(const FSimState& Root, int32 PlayerIndex, const FSimMctsConfig& Config)
+{
+	FSimMctsResult Result;
+	if (!Root.Players.IsValidIndex(PlayerIndex) || !Root.Players[PlayerIndex].bAlive) return Result;
+
+	const double StartTime = FPlatformTime::Seconds();
+	const double Deadline  = StartTime + FMath::Max(0.0, Config.BudgetSeconds);
+
+	const int32 NumTrees = Config.NumTrees > 0 ? Config.NumTrees : (FApp::ShouldUseThreadingForPerformance() ? FTaskGraphInterface::Get().GetNumWorkerThreads() + 1 : 1);
+	while (Trees.Num() < NumTrees)
+	{
+		Trees.Add(MakeUnique<FTree>(Rules));
+	}
+
+	const FRootStats RootStats = GetStats(Root, PlayerIndex);
+	ParallelFor(NumTrees, [this, &Root, &RootStats, PlayerIndex, &Config, Deadline](int32 TreeIndex)
+	{
+		FTree& Tree = *Trees[TreeIndex];
+		Tree.Random.Initialize(int32(HashCombine(uint32(Config.Seed), uint32(TreeIndex))));
+		RunTree(Tree, Root, RootStats, PlayerIndex, Config, Deadline);
+	}, NumTrees > 1 ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+
+	// Merge the trees by how often each first action was visited, the most robust pick
+	int32 Visits[NumActions]	 = {};
+	float ValueSums[NumActions] = {};
+	for (int32 TreeIndex = 0; TreeIndex < NumTrees; TreeIndex++)
+	{
+		const FTree& Tree = *Trees[TreeIndex];
+		Result.Iterations += Tree.Iterations;
+		if (Tree.Nodes.Num() == 0) continue;
+
+		const FNode& RootNode = Tree.Nodes[0];
+		for (int32 Child = RootNode.FirstChild; Child != INDEX_NONE && Child < RootNode.FirstChild + RootNode.NumChildren; Child++)
+		{
+			Visits[int32(Tree.Nodes[Child].Action)] += Tree.Nodes[Child].Visits;
+			ValueSums[int32(Tree.Nodes[Child].Action)] += Tree.Nodes[Child].ValueSum;
+		}
+	}
+
+	int32 BestAction = INDEX_NONE;
+	for (int32 Action = 0; Action < NumActions; Action++)
+	{
+		if (Visits[Action] > 0 && (BestAction == INDEX_NONE || Visits[Action] > Visits[BestAction]))
+		{
+			BestAction = Action;
+		}
+	}
+
+	if (BestAction != INDEX_NONE)
+	{
+		Result.Action = ESimMctsAction(BestAction);
+		Result.Value  = ValueSums[BestAction] / Visits[BestAction];
+		Result.Input  = ToInput(Result.Action);
+	}
+	else
+	{
+		// Out of time before a single rollout finished
+		Config.OpponentPolicy(Root, PlayerIndex, Trees[0]->Random, Trees[0]->PolicyScratch, Result.Input);
+	}
+	Result.Trees   = NumTrees;
+	Result.Seconds = FPlatformTime::Seconds() - StartTime;
+	return Result;
+}
+
+void FBombermanSimMcts::RunTree(FTree& Tree, const FSimState& Root, const FRootStats& RootStats, int32 PlayerIndex, const FSimMctsConfig& Config, double Deadline) const
+{
+	Tree.Nodes.Reset();
+	Tree.Iterations = 0;
+
+	FNode& RootNode		= Tree.Nodes.AddDefaulted_GetRef();
+	RootNode.Untried	= GetLegalActions(Root, PlayerIndex);
+	RootNode.bExpanded	= true;
+	const int32 MaxDepth = FMath::Max(1, Config.MaxDepth);
+
+	while (FPlatformTime::Seconds() < Deadline && (Config.MaxIterations <= 0 || Tree.Iterations < Config.MaxIterations))
+	{
+		Tree.Sim.Reset(Root);
+		Tree.Path.Reset();
+		Tree.Path.Add(0);
+
+		int32 Node		  = 0;
+		bool bOutOfTime	  = false;
+		auto IsPlayerDown = [&Tree, PlayerIndex]() { return !Tree.Sim.GetState().Players[PlayerIndex].bAlive || Tree.Sim.IsFinished(); };
+
+		// Selection: follow UCT through nodes that tried all their actions
+		while (Tree.Path.Num() <= MaxDepth && Tree.Nodes[Node].Untried == 0 && Tree.Nodes[Node].NumChildren > 0 && !IsPlayerDown())
+		{
+			const FNode& Parent		= Tree.Nodes[Node];
+			const float LogVisits	= FMath::Loge(float(FMath::Max(1, Parent.Visits)));
+			int32 BestChild			= Parent.FirstChild;
+			float BestScore			= -MAX_flt;
+			for (int32 Child = Parent.FirstChild; Child < Parent.FirstChild + Parent.NumChildren; Child++)
+			{
+				const FNode& Candidate = Tree.Nodes[Child];
+				const float Score	   = Candidate.Visits == 0
+					? MAX_flt
+					: Candidate.ValueSum / Candidate.Visits + Config.Exploration * FMath::Sqrt(LogVisits / Candidate.Visits);
+				if (Score > BestScore)
+				{
+					BestScore = Score;
+					BestChild = Child;
+				}
+			}
+
+			Node = BestChild;
+			Tree.Path.Add(Node);
+			if (!StepAction(Tree, PlayerIndex, Tree.Nodes[Node].Action, Config, Deadline))
+			{
+				bOutOfTime = true;
+				break;
+			}
+		}
+
+		// Expansion: children of a node are added together once it is first left through,
+		// then handed out one untried action at a time
+		if (!bOutOfTime && Tree.Path.Num() <= MaxDepth && Tree.Nodes[Node].Untried != 0 && !IsPlayerDown())
+		{
+			if (Tree.Nodes[Node].NumChildren == 0)
+			{
+				const uint8 Legal				= Tree.Nodes[Node].Untried;
+				Tree.Nodes[Node].FirstChild		= Tree.Nodes.Num();
+				for (int32 Action = 0; Action < NumActions; Action++)
+				{
+					if (!(Legal & (1 << Action))) continue;
+
+					FNode& Child = Tree.Nodes.AddDefaulted_GetRef();
+					Child.Parent = Node;
+					Child.Action = ESimMctsAction(Action);
+					Tree.Nodes[Node].NumChildren++;
+				}
+			}
+
+			// Pick a random untried action, its child is the slot with the same rank among the legal ones
+			FNode& Parent		= Tree.Nodes[Node];
+			const int32 Untried = FMath::CountBits(Parent.Untried);
+			int32 Pick			= Tree.Random.RandRange(0, Untried - 1);
+			int32 Child			= Parent.FirstChild;
+			for (; Child < Parent.FirstChild + Parent.NumChildren; Child++)
+			{
+				if ((Parent.Untried & (1 << int32(Tree.Nodes[Child].Action))) && Pick-- == 0) break;
+			}
+			Parent.Untried &= ~(1 << int32(Tree.Nodes[Child].Action));
+
+			Node = Child;
+			Tree.Path.Add(Node);
+			bOutOfTime = !StepAction(Tree, PlayerIndex, Tree.Nodes[Node].Action, Config, Deadline);
+
+			// Legal actions of the new node, from the first state that reached it
+			if (!bOutOfTime && !Tree.Nodes[Node].bExpanded)
+			{
+				Tree.Nodes[Node].Untried   = Tree.Path.Num() <= MaxDepth ? GetLegalActions(Tree.Sim.GetState(), PlayerIndex) : 0;
+				Tree.Nodes[Node].bExpanded = true;
+			}
+		}
+
+		// Rollout: everyone on the rollout policy
+		for (int32 Tick = 0; !bOutOfTime && Tick < Config.RolloutTicks && !IsPlayerDown(); Tick++)
+		{
+			const FSimState& State = Tree.Sim.GetState();
+			Tree.Inputs.SetNum(State.Players.Num(), EAllowShrinking::No);
+			for (int32 Index = 0; Index < State.Players.Num(); Index++)
+			{
+				Config.RolloutPolicy(State, Index, Tree.Random, Tree.PolicyScratch, Tree.Inputs[Index]);
+			}
+			Tree.Sim.Step(Tree.Inputs);
+			bOutOfTime = FPlatformTime::Seconds() >= Deadline;
+		}
+
+		// A rollout cut short by the deadline says nothing, drop it
+		if (bOutOfTime) break;
+
+		const float Value = Evaluate(Tree.Sim.GetState(), PlayerIndex, RootStats);
+		for (int32 PathNode : Tree.Path)
+		{
+			Tree.Nodes[PathNode].Visits++;
+			Tree.Nodes[PathNode].ValueSum += Value;
+		}
+		Tree.Iterations++;
+	}
+}
+
+bool FBombermanSimMcts::StepAction(FTree& Tree, int32 PlayerIndex, ESimMctsAction Action, const FSimMctsConfig& Config, double Deadline) const
+{
+	const FSimInput First = ToInput(Action);
+
+	// Moves last until the player arrived, everything else as long as one step would take
+	const int32 HoldTicks = Rules.GetMoveTicksPerCell(Tree.Sim.GetState().Players[PlayerIndex].MoveSpeed);
+	for (int32 Tick = 0; Tick < HoldTicks; Tick++)
+	{
+		const FSimState& State = Tree.Sim.GetState();
+		Tree.Inputs.SetNum(State.Players.Num(), EAllowShrinking::No);
+		for (int32 Index = 0; Index < State.Players.Num(); Index++)
+		{
+			if (Index != PlayerIndex) Config.OpponentPolicy(State, Index, Tree.Random, Tree.PolicyScratch, Tree.Inputs[Index]);
+		}
+		Tree.Inputs[PlayerIndex]		  = Tick == 0 ? First : FSimInput();
+		Tree.Inputs[PlayerIndex].MoveDir = First.MoveDir;
+		Tree.Sim.Step(Tree.Inputs);
+
+		if (FPlatformTime::Seconds() >= Deadline) return false;
+
+		const FSimPlayer& Player = Tree.Sim.GetState().Players[PlayerIndex];
+		if (!Player.bAlive || (First.MoveDir != INDEX_NONE && Tick > 0 && Player.MoveCooldown == 0)) break;
+	}
+	return true;
+}
+
+uint8 FBombermanSimMcts::GetLegalActions(const FSimState& State, int32 PlayerIndex)
+{
+	const FSimPlayer& Player = State.Players[PlayerIndex];
+	uint8 Legal				 = 1 << int32(ESimMctsAction::Wait);
+
+	for (int32 Dir = 0; Dir < 4; Dir++)
+	{
+		const FGridCoord Target = Player.Cell + GridDirections[Dir];
+		if (!State.Grid.HasAny(Target, EGridCellFlags::Wall | EGridCellFlags::Block))
+		{
+			// Walking into a bomb only turns the player, which is how a kick is lined up
+			if (!State.Grid.HasAny(Target, EGridCellFlags::Bomb) || (Player.bCanKickBombs && Player.Facing != Dir))
+			{
+				Legal |= 1 << Dir;
+			}
+		}
+	}
+
+	if (Player.ActiveBombs < Player.MaxBombCount && !State.Grid.HasAny(Player.Cell, EGridCellFlags::PlaceStop))
+	{
+		Legal |= 1 << int32(ESimMctsAction::PlaceBomb);
+	}
+	if (Player.bCanKickBombs && State.FindBomb(Player.Cell + GridDirections[Player.Facing]) != INDEX_NONE)
+	{
+		Legal |= 1 << int32(ESimMctsAction::Kick);
+	}
+	return Legal;
+}
+
+FBombermanSimMcts::FRootStats FBombermanSimMcts::GetStats(const FSimState& State, int32 PlayerIndex) const
+{
+	const FSimPlayer& Player = State.Players[PlayerIndex];
+
+	FRootStats Stats;
+	Stats.Kills		= Player.Kills;
+	Stats.Deaths	= Player.Deaths;
+	Stats.Abilities = Player.MaxBombCount + Player.BombPower + Player.MoveSpeed / FMath::Max(1, Rules.MoveSpeedStep) + (Player.bCanKickBombs ? 1 : 0);
+	for (const EGridCellFlags Cell : State.Grid.Cells)
+	{
+		Stats.Blocks += EnumHasAnyFlags(Cell, EGridCellFlags::Block) ? 1 : 0;
+	}
+	return Stats;
+}
+
+float FBombermanSimMcts::Evaluate(const FSimState& State, int32 PlayerIndex, const FRootStats& RootStats) const
+{
+	const FRootStats Stats = GetStats(State, PlayerIndex);
+	if (!State.Players[PlayerIndex].bAlive || Stats.Deaths > RootStats.Deaths) return 0.0f;
+
+	return SurviveValue
+		+ KillValue * FMath::Min(Stats.Kills - RootStats.Kills, 2) / 2.0f
+		+ AbilityValue * FMath::Min(Stats.Abilities - RootStats.Abilities, 3) / 3.0f
+		+ BlockValue * FMath::Min(RootStats.Blocks - Stats.Blocks, 4) / 4.0f;
+}
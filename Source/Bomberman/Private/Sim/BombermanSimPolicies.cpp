@@ -0,0 +1,226 @@
+#include "Sim/BombermanSimPolicies.h"
+
+#include "Sim/BombermanSim.h"
+#include "Sim/BombermanSimMcts.h"
+
+namespace
+{
+	// Cells a player can walk into
+	bool IsWalkable(const FSimState& State, FGridCoord Cell)
+	{
+		return !State.Grid.HasAny(Cell, EGridCellFlags::Wall | EGridCellFlags::Block | EGridCellFlags::Bomb);
+	}
+
+	// Marks every cell that is burning or will burn when the current bombs go off
+	void ComputeDanger(const FSimState& State, TArray<uint8>& OutDanger)
+	{
+		const FBombermanGrid& Grid = State.Grid;
+		OutDanger.SetNumUninitialized(Grid.Num(), EAllowShrinking::No);
+
+		for (int32 Index = 0; Index < Grid.Num(); Index++)
+		{
+			OutDanger[Index] = State.BurnTicks[Index] > 0 ? 1 : 0;
+		}
+		for (const FSimBomb& Bomb : State.Bombs)
+		{
+			Grid.ForEachBlastCell(Bomb.Cell, Bomb.Range, [&](FGridCoord Cell, int32, bool, EGridCellFlags)
+			{
+				if (Grid.Contains(Cell)) OutDanger[Grid.ToIndex(Cell)] = 1;
+			});
+		}
+	}
+
+	/**
+	 * Breadth-first search from From over walkable cells, skipping cells marked in Avoid.
+	 * OutDir is the first step towards the closest goal, INDEX_NONE when From is a goal.
+	 */
+	template <typename FIsGoal>
+	bool FindFirstStep(const FSimState& State, FGridCoord From, const TArray<uint8>& Avoid, int32 MaxDepth, FSimPolicyScratch& Scratch, FIsGoal&& IsGoal, int32& OutDir)
+	{
+		const FBombermanGrid& Grid = State.Grid;
+		OutDir					   = INDEX_NONE;
+		if (!Grid.Contains(From)) return false;
+		if (IsGoal(From)) return true;
+
+		// Depth tracked per ring
+		TArray<TPair<int32, int32>>& Frontier = Scratch.Frontier;
+		TArray<TPair<int32, int32>>& Next	  = Scratch.Next;
+		TArray<uint8>& Visited				  = Scratch.Visited;
+		Visited.SetNumUninitialized(Grid.Num(), EAllowShrinking::No);
+		FMemory::Memzero(Visited.GetData(), Visited.Num());
+		Visited[Grid.ToIndex(From)] = 1;
+		Frontier.Reset();
+		Frontier.Add({Grid.ToIndex(From), INDEX_NONE});
+
+		for (int32 Depth = 1; Depth <= MaxDepth && Frontier.Num() > 0; Depth++)
+		{
+			Next.Reset();
+			for (const TPair<int32, int32>& Entry : Frontier)
+			{
+				const FGridCoord Cell = Grid.ToCell(Entry.Key);
+				for (int32 Dir = 0; Dir < 4; Dir++)
+				{
+					const FGridCoord Neighbour = Cell + GridDirections[Dir];
+					if (!Grid.Contains(Neighbour) || !IsWalkable(State, Neighbour)) continue;
+
+					const int32 Index = Grid.ToIndex(Neighbour);
+					if (Visited[Index] || Avoid[Index]) continue;
+					Visited[Index] = 1;
+
+					const int32 FirstDir = Entry.Value == INDEX_NONE ? Dir : Entry.Value;
+					if (IsGoal(Neighbour))
+					{
+						OutDir = FirstDir;
+						return true;
+					}
+					Next.Add({Index, FirstDir});
+				}
+			}
+			Swap(Frontier, Next);
+		}
+		return false;
+	}
+
+	bool IsEnemyInBlast(const FSimState& State, int32 PlayerIndex, FGridCoord Origin, int32 Range)
+	{
+		bool bFound = false;
+		State.Grid.ForEachBlastCell(Origin, Range, [&](FGridCoord Cell, int32 Distance, bool, EGridCellFlags Flags)
+		{
+			if (Distance == 0 || !EnumHasAnyFlags(Flags, EGridCellFlags::Player)) return;
+
+			for (int32 Other = 0; Other < State.Players.Num(); Other++)
+			{
+				bFound |= Other != PlayerIndex && State.Players[Other].bAlive && State.Players[Other].Cell == Cell;
+			}
+		});
+		return bFound;
+	}
+
+	bool IsNextToBlock(const FSimState& State, FGridCoord Cell)
+	{
+		for (int32 Dir = 0; Dir < 4; Dir++)
+		{
+			if (State.Grid.HasAny(Cell + GridDirections[Dir], EGridCellFlags::Block)) return true;
+		}
+		return false;
+	}
+}
+
+FSimPolicyScratch::FSimPolicyScratch() = default;
+FSimPolicyScratch::~FSimPolicyScratch() = default;
+
+namespace BombermanSimPolicies
+{
+	void Idle(const FSimState& State, int32 PlayerIndex, const FRandomStream& Random, FSimPolicyScratch& Scratch, FSimInput& OutInput)
+	{
+		OutInput = FSimInput();
+	}
+
+	void RandomWalk(const FSimState& State, int32 PlayerIndex, const FRandomStream& Random, FSimPolicyScratch& Scratch, FSimInput& OutInput)
+	{
+		OutInput			= FSimInput();
+		OutInput.MoveDir	= int8(Random.RandRange(-1, 3));
+		OutInput.bPlaceBomb = Random.RandRange(0, 29) == 0;
+		OutInput.bKick		= Random.RandRange(0, 9) == 0;
+	}
+
+	void Greedy(const FSimState& State, int32 PlayerIndex, const FRandomStream& Random, FSimPolicyScratch& Scratch, FSimInput& OutInput)
+	{
+		OutInput				 = FSimInput();
+		const FSimPlayer& Player = State.Players[PlayerIndex];
+		// Decisions only matter where the player can take its next step
+		if (!Player.bAlive || Player.MoveCooldown > 0) return;
+
+		const FBombermanGrid& Grid = State.Grid;
+		TArray<uint8>& Danger	   = Scratch.Danger;
+		ComputeDanger(State, Danger);
+
+		TArray<uint8>& Burning = Scratch.Burning;
+		Burning.SetNumUninitialized(Grid.Num(), EAllowShrinking::No);
+		for (int32 Index = 0; Index < Grid.Num(); Index++)
+		{
+			Burning[Index] = State.BurnTicks[Index] > 0 ? 1 : 0;
+		}
+
+		int32 Dir = INDEX_NONE;
+		const auto IsSafe = [&](FGridCoord Cell) { return !Danger[Grid.ToIndex(Cell)]; };
+
+		// Get out of every blast first
+		if (Danger[Grid.ToIndex(Player.Cell)])
+		{
+			if (FindFirstStep(State, Player.Cell, Burning, 10, Scratch, IsSafe, Dir))
+			{
+				OutInput.MoveDir = int8(Dir);
+			}
+			return;
+		}
+
+		// Bomb when it hits something and there is still a way out of the own blast
+		const bool bCanPlace = Player.ActiveBombs < Player.MaxBombCount && !Grid.HasAny(Player.Cell, EGridCellFlags::PlaceStop);
+		if (bCanPlace && (IsNextToBlock(State, Player.Cell) || IsEnemyInBlast(State, PlayerIndex, Player.Cell, Player.BombPower)))
+		{
+			TArray<uint8>& DangerAfter = Scratch.DangerAfter;
+			DangerAfter.Reset();
+			DangerAfter.Append(Danger);
+			Grid.ForEachBlastCell(Player.Cell, Player.BombPower, [&](FGridCoord Cell, int32, bool, EGridCellFlags)
+			{
+				if (Grid.Contains(Cell)) DangerAfter[Grid.ToIndex(Cell)] = 1;
+			});
+
+			int32 EscapeDir = INDEX_NONE;
+			const auto IsSafeAfter = [&](FGridCoord Cell) { return !DangerAfter[Grid.ToIndex(Cell)]; };
+			if (FindFirstStep(State, Player.Cell, Danger, 6, Scratch, IsSafeAfter, EscapeDir) && EscapeDir != INDEX_NONE)
+			{
+				OutInput.bPlaceBomb = true;
+				OutInput.MoveDir	= int8(EscapeDir);
+				return;
+			}
+		}
+
+		// Walk to the closest powerup, block or enemy without entering any blast
+		const auto IsTarget = [&](FGridCoord Cell)
+		{
+			if (Grid.HasAny(Cell, EGridCellFlags::Powerup) || IsNextToBlock(State, Cell)) return true;
+			return Player.ActiveBombs < Player.MaxBombCount && IsEnemyInBlast(State, PlayerIndex, Cell, Player.BombPower);
+		};
+		if (FindFirstStep(State, Player.Cell, Danger, 32, Scratch, IsTarget, Dir) && Dir != INDEX_NONE)
+		{
+			OutInput.MoveDir = int8(Dir);
+			return;
+		}
+
+		// Nothing to do, wander through safe cells
+		const int32 WanderDir	= Random.RandRange(0, 3);
+		const FGridCoord Wander = Player.Cell + GridDirections[WanderDir];
+		if (Grid.Contains(Wander) && !Danger[Grid.ToIndex(Wander)])
+		{
+			OutInput.MoveDir = int8(WanderDir);
+		}
+	}
+
+	void Mcts(const FSimState& State, int32 PlayerIndex, const FRandomStream& Random, FSimPolicyScratch& Scratch, FSimInput& OutInput)
+	{
+		OutInput				 = FSimInput();
+		const FSimPlayer& Player = State.Players[PlayerIndex];
+		if (!Player.bAlive || Player.MoveCooldown > 0) return;
+
+		// One tree and a fixed count keep batch matches reproducible, the batch already fills the workers
+		FSimMctsConfig Config;
+		Config.NumTrees		 = 1;
+		Config.MaxIterations = 32;
+		Config.BudgetSeconds = 1.0;
+		Config.Seed			 = Random.RandRange(0, MAX_int32 - 1);
+
+		if (!Scratch.Planner.IsValid()) Scratch.Planner = MakeUnique<FBombermanSimMcts>();
+		OutInput = Scratch.Planner->Search(State, PlayerIndex, Config).Input;
+	}
+
+	FSimPolicyFunc Find(const FString& Name)
+	{
+		if (Name == TEXT("Idle")) return &Idle;
+		if (Name == TEXT("Random")) return &RandomWalk;
+		if (Name == TEXT("Greedy")) return &Greedy;
+		if (Name == TEXT("Mcts")) return &Mcts;
+		return nullptr;
+	}
+}
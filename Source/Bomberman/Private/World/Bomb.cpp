@@ -8,11 +8,24 @@
 #include "Player/BombermanCharacter.h"
 #include "World/Explosion.h"
 #include "World/DestructibleBlock.h"
+#include "World/BombermanGridSubsystem.h"
+#include "World/ChainReactionSubsystem.h"
+#include "World/BombUpdateSubsystem.h"
+#include "World/InstancedMeshRenderSubsystem.h"
+#include "Net/BombermanGridStateComponent.h"
+#include "Replay/ReplayRecorderSubsystem.h"
+#include "Core/ActorPoolSubsystem.h"
 #include "Core/BombermanTypes.h"
+#include "Core/BombermanLog.h"
+#include "Core/BombermanStats.h"
 
 ABomb::ABomb()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// Fuse, kick and pulse are updated by UBombUpdateSubsystem
+	PrimaryActorTick.bCanEverTick = false;
+
+	// Replicated as grid events by UBombermanGridStateComponent, clients spawn their own
+	bReplicates = false;
 
 	// Collision Box settings
 	CollisionBox  = CreateDefaultSubobject<UBoxComponent>(TEXT("CollisionBox"));
@@ -46,7 +59,28 @@ void ABomb::BeginPlay()
 	Super::BeginPlay();
 
 	InitialScale = BombMesh->GetRelativeScale3D();
-	UE_LOG(LogTemp, Log, TEXT("Bomb InitialScale: %s"), *InitialScale.ToString());
+	UE_LOG(LogBomberman, Verbose, TEXT("Bomb InitialScale: %s"), *InitialScale.ToString());
+
+	// Pre-warmed instances wait in the pool
+	if (bInPool) return;
+
+	ActivateBomb();
+}
+
+void ABomb::ActivateBomb()
+{
+	// Occupy the grid cell
+	if (UBombermanGridSubsystem* Grid = GetGridSubsystem())
+	{
+		GridCell		  = Grid->RegisterBomb(this);
+		bRegisteredOnGrid = true;
+	}
+
+	if (UBombUpdateSubsystem* Updates = GetUpdateSubsystem())
+	{
+		Updates->Register(this);
+	}
+	AddRenderInstance();
 
 	// Timer starts
 	StartTimer(DefaultExplosionTime);
@@ -58,27 +92,73 @@ void ABomb::BeginPlay()
 	// Blueprint event call
 	OnBombPlaced();
 
-	UE_LOG(LogTemp, Log, TEXT("Bomb placed at: %s : Owner : %s"), *GetActorLocation().ToString(), *GetOwner()->GetName());
+	UE_LOG(LogBomberman, Verbose, TEXT("Bomb placed at: %s : Owner : %s"), *GetActorLocation().ToString(), GetOwner() ? *GetOwner()->GetName() : TEXT("None"));
 }
 
-void ABomb::Tick(float DeltaTime)
+void ABomb::OnAcquiredFromPool()
 {
-	Super::Tick(DeltaTime);
+	bInPool = false;
 
-	if (bOwnerCanPass)
-	{
-		UpdateOwnerCanPass();
-	}
+	// Reset the state left over from the previous life
+	bIsExploding   = false;
+	bIsBeingKicked = false;
+	NetId		   = 0;
+	BombMesh->SetRelativeScale3D(InitialScale);
+
+	// Owner pass and kick change the responses, start again from the class defaults
+	const ABomb* BombCDO = GetClass()->GetDefaultObject<ABomb>();
+	CollisionBox->SetCollisionResponseToChannels(BombCDO->CollisionBox->GetCollisionResponseToChannels());
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	ActivateBomb();
+}
+
+void ABomb::OnReturnedToPool()
+{
+	bInPool = true;
+
+	GetWorldTimerManager().ClearTimer(OwnerIgnoreTimerHandle);
+	UnregisterFromUpdates();
+	UnregisterFromGrid();
+	RemoveRenderInstance();
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	// Delegate bindings stay so the same owner can reuse this bomb without rebinding
+}
 
-	if (bIsBeingKicked)
+void ABomb::SetBombPower(int32 NewPower)
+{
+	ExplosionRange = NewPower;
+
+	// Pooled bombs are on the grid before their power is set
+	UBombermanGridSubsystem* Grid = GetGridSubsystem();
+	if (Grid && bRegisteredOnGrid)
 	{
-		UpdateKickMovement(DeltaTime);
+		Grid->SetBombRange(this, NewPower);
 	}
+}
 
-	if (!bIsExploding)
+void ABomb::SetBombOwner(ABombermanCharacter* NewOwner)
+{
+	// Only drop the binding when the bomb changes hands
+	if (BombOwner && BombOwner != NewOwner)
 	{
-		UpdateTimerEffects(DeltaTime);
+		OnBombExploded.RemoveAll(BombOwner);
 	}
+	BombOwner = NewOwner;
+}
+
+void ABomb::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterFromUpdates();
+	UnregisterFromGrid();
+	RemoveRenderInstance();
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ABomb::StartTimer(float ExplosionTime)
@@ -87,26 +167,58 @@ void ABomb::StartTimer(float ExplosionTime)
 
 	ExplosionTimer = ExplosionTime;
 
-	GetWorldTimerManager().SetTimer(ExplosionTimerHandle, this, &ThisClass::Explode, ExplosionTime, false);
+	if (UBombUpdateSubsystem* Updates = GetUpdateSubsystem())
+	{
+		Updates->SetFuse(this, ExplosionTime);
+	}
 
 	OnTimerStarted(ExplosionTime);
 
-	UE_LOG(LogTemp, Log, TEXT("Bomb timer started: %f seconds"), ExplosionTime);
+	UE_LOG(LogBomberman, Verbose, TEXT("Bomb timer started: %f seconds"), ExplosionTime);
 }
 
 void ABomb::Explode()
 {
 	if (bIsExploding) return;
 
+	// Clients only detonate when the server's blast arrives
+	if (GetNetMode() == NM_Client) return;
+
+	// Detonations are resolved once per tick together with everything they chain into
+	if (UChainReactionSubsystem* ChainReaction = GetWorld()->GetSubsystem<UChainReactionSubsystem>())
+	{
+		ChainReaction->QueueDetonation(this);
+	}
+}
+
+void ABomb::ForceExplode()
+{
+	Explode();
+}
+
+void ABomb::BeginDetonation()
+{
 	bIsExploding = true;
 
-	UE_LOG(LogTemp, Log, TEXT("Bomb exploding at: %s with power: %d"), *GetActorLocation().ToString(), ExplosionRange);
+	// Frozen in place until its chain delay has passed
+	StopKick();
+	UnregisterFromUpdates();
+
+	// Clear timer
+	if (OwnerIgnoreTimerHandle.IsValid()) GetWorldTimerManager().ClearTimer(OwnerIgnoreTimerHandle);
+}
+
+void ABomb::Detonate(TConstArrayView<FBlastCell> Cells)
+{
+	UE_LOG(LogBomberman, Verbose, TEXT("Bomb exploding at: %s with power: %d"), *GetActorLocation().ToString(), ExplosionRange);
 
 	// Blueprint event call
 	OnBombExploding();
 
+	UnregisterFromGrid();
+
 	// Spawn Explosion
-	CreateExplosion();
+	CreateExplosion(Cells);
 
 	// Notify the owner
 	if (Owner)
@@ -114,99 +226,66 @@ void ABomb::Explode()
 		OnBombExploded.Broadcast(this);
 	}
 
-	// Clear timer
-	if (ExplosionTimerHandle.IsValid()) GetWorldTimerManager().ClearTimer(ExplosionTimerHandle);
-	if (OwnerIgnoreTimerHandle.IsValid()) GetWorldTimerManager().ClearTimer(OwnerIgnoreTimerHandle);
-
 	// Remove bombs
+	if (UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>())
+	{
+		Pool->Release(this);
+		return;
+	}
 	Destroy();
 }
 
-void ABomb::ForceExplode()
+void ABomb::CreateExplosion(TConstArrayView<FBlastCell> Cells)
 {
-	GetWorldTimerManager().ClearTimer(ExplosionTimerHandle);
-	Explode();
-}
+	BOMBERMAN_SCOPE(CreateExplosion);
 
-void ABomb::CreateExplosion()
-{
 	if (!ExplosionClass)
 	{
-		UE_LOG(LogTemp, Error, TEXT("ExplosionClass not set!"));
+		UE_LOG(LogBomberman, Error, TEXT("ExplosionClass not set!"));
 		return;
 	}
 
-	FVector BombLocation = GetActorLocation();
+	UBombermanGridSubsystem* Grid = GetGridSubsystem();
+	if (!Grid) return;
 
-	// Explosion in the center
-	SpawnExplosion(BombLocation, EExplosionType::Center);
-
-	// Explosion in four directions
-	TArray<FVector> Directions = {FVector(1, 0, 0),
-								  FVector(-1, 0, 0),
-								  FVector(0, 1, 0),
-								  FVector(0, -1, 0)};
-	for (const FVector& Direction : Directions)
-	{
-		CheckExplosionDirection(Direction, ExplosionRange);
-	}
-}
-
-void ABomb::CheckExplosionDirection(FVector Direction, int32 Range)
-{
-	const FVector CurrentPosition = GetActorLocation();
-
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
-	if (Owner)
-	{
-		QueryParams.AddIgnoredActor(Owner);
-	}
+	const float ExplosionZ = GetActorLocation().Z;
 
-	for (int32 i = 1; i <= Range; i++)
+	for (const FBlastCell& BlastCell : Cells)
 	{
-		const FVector ExplosionPosition = CurrentPosition + (Direction * GridSize * i);
-		const FVector StartPosition		= CurrentPosition + (Direction * GridSize * (i - 0.5f));
-		// Obstacle check
-		FHitResult HitResult;
-		bool bHit = GetWorld()->LineTraceSingleByChannel(HitResult, StartPosition, ExplosionPosition, ECC_WorldStatic, QueryParams);
+		AExplosion* Explosion = SpawnExplosion(Grid->CellToWorld(BlastCell.Cell, ExplosionZ), BlastCell.Type);
 
-		if (bHit)
+		// Destructible block handling
+		if (EnumHasAnyFlags(BlastCell.Flags, EGridCellFlags::Block))
 		{
-			// Destructible block handling
-			if (ADestructibleBlock* Block = Cast<ADestructibleBlock>(HitResult.GetActor()))
+			if (ADestructibleBlock* Block = Grid->GetBlockAt(BlastCell.Cell))
 			{
-				// Explosions at block location
-				SpawnExplosion(HitResult.Location, i == Range ? EExplosionType::End : EExplosionType::Middle);
+				if (Explosion) Explosion->NotifyBlockBurned(Block);
 				Block->DestroyBlock();
-				break;
-			}
-			else
-			{
-				// Indestructible obstacles
-				break;
 			}
 		}
-		else
+
+		// Bombs reached by the blast were chained when the reaction was resolved
+		if (Explosion && BlastCell.Type != EExplosionType::Center && EnumHasAnyFlags(BlastCell.Flags, EGridCellFlags::Bomb))
 		{
-			// Determine the explosion type
-			EExplosionType ExplosionType = (i == Range) ? EExplosionType::End : EExplosionType::Middle;
-			SpawnExplosion(ExplosionPosition, ExplosionType);
+			if (ABomb* ChainBomb = Grid->GetBombAt(BlastCell.Cell))
+			{
+				Explosion->NotifyBombChained(ChainBomb);
+			}
 		}
 	}
 }
 
-void ABomb::SpawnExplosion(FVector Position, EExplosionType Type)
+AExplosion* ABomb::SpawnExplosion(FVector Position, EExplosionType Type)
 {
-	FActorSpawnParameters SpawnParams;
-	SpawnParams.Owner						   = BombOwner;
-	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>();
+	if (!Pool) return nullptr;
 
-	AExplosion* NewExplosion = GetWorld()->SpawnActor<AExplosion>(ExplosionClass, Position, FRotator::ZeroRotator, SpawnParams);
+	AExplosion* NewExplosion = Pool->Acquire<AExplosion>(ExplosionClass, FTransform(Position), BombOwner);
 	if (NewExplosion)
 	{
 		NewExplosion->InitializeExplosion(Type, BombOwner, this);
 	}
+	return NewExplosion;
 }
 
 bool ABomb::CanBeKicked() const
@@ -218,74 +297,100 @@ void ABomb::StartKick(FVector Direction, ABombermanCharacter* Kicker)
 {
 	if (!CanBeKicked()) return;
 
-	bIsBeingKicked	 = true;
-	_KickDirection	 = Direction.GetSafeNormal2D();
-	CurrentKickSpeed = KickSpeed;
+	// Kicks run along the grid so the fixed-step integration lands on the same cell everywhere
+	const int32 Dir = GridDirectionFromVector(Direction);
+	if (Dir == INDEX_NONE) return;
+
+	UBombUpdateSubsystem* Updates = GetUpdateSubsystem();
+	if (!Updates) return;
+
+	// The stop cell is planned through the grid up front, a kick straight into an obstacle never starts
+	if (Updates->StartKick(this, Dir, KickSpeed) == 0)
+	{
+		OnKickCollision();
+		return;
+	}
+
+	const FVector KickDirection(GridDirections[Dir].X, GridDirections[Dir].Y, 0.0);
+	bIsBeingKicked = true;
 
 	// Collision settings
 	CollisionBox->SetCollisionResponseToChannel(ECC_Pawn, ECR_Block);
 
-	OnKickStarted(_KickDirection);
+	OnKickStarted(KickDirection);
 
-	UE_LOG(LogTemp, Log, TEXT("Bomb kicked by %s in direction: %s"), Kicker ? *Kicker->GetName() : TEXT("Unknown"), *_KickDirection.ToString());
+	if (UBombermanGridStateComponent* GridState = UBombermanGridStateComponent::Get(this))
+	{
+		GridState->RecordBombKicked(this, Dir);
+	}
+	if (UReplayRecorderSubsystem* Replay = UReplayRecorderSubsystem::GetActive(this))
+	{
+		Replay->RecordBombKicked(Kicker, this, Dir);
+	}
+
+	UE_LOG(LogBomberman, Verbose, TEXT("Bomb kicked by %s in direction: %s"), Kicker ? *Kicker->GetName() : TEXT("Unknown"), *KickDirection.ToString());
 }
 
-void ABomb::UpdateKickMovement(float DeltaTime)
+void ABomb::EnterKickCell(FGridCoord Cell)
 {
 	if (!bIsBeingKicked) return;
 
-	// Deceleration
-	CurrentKickSpeed = FMath::Max(0.f, CurrentKickSpeed - (KickDeceleration * DeltaTime));
-
-	if (CurrentKickSpeed <= 0.f)
+	UBombermanGridSubsystem* Grid = GetGridSubsystem();
+	if (Grid && bRegisteredOnGrid)
 	{
-		StopKick();
-		return;
+		Grid->MoveBomb(this, GridCell, Cell);
 	}
+	GridCell = Cell;
+}
 
-	// Movement process
-	FVector NewLocation = GetActorLocation() + (_KickDirection * CurrentKickSpeed * DeltaTime);
-	// Adjust to the grid
-	FVector GridPosition = GetGridPosition(NewLocation);
-	// Collision check
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(this);
-	QueryParams.AddIgnoredActor(BombOwner);
-
-	FHitResult HitResult;
-	bool bHit = GetWorld()->SweepSingleByChannel(HitResult, GetActorLocation(), GridPosition, FQuat::Identity, ECC_WorldStatic, FCollisionShape::MakeBox(FVector(40.f, 40.f, 40.f)), QueryParams);
-	if (bHit)
-	{
-		// Collision handling
-		OnKickCollision();
-		StopKick();
-	}
-	else
-	{
-		SetActorLocation(GridPosition);
-	}
+void ABomb::SetKickLocation(const FVector& Location)
+{
+	SetActorLocation(Location);
+	SyncRenderInstance();
 }
 
 void ABomb::StopKick()
 {
 	if (!bIsBeingKicked) return;
 
-	bIsBeingKicked	 = false;
-	CurrentKickSpeed = 0.f;
+	bIsBeingKicked = false;
+	if (UBombUpdateSubsystem* Updates = GetUpdateSubsystem())
+	{
+		Updates->StopKick(this);
+	}
 
-	// Align the position with the grid
-	FVector GridPosition = GetGridPosition(GetActorLocation());
-	SetActorLocation(GridPosition);
+	// Align the position with the cell the grid has the bomb on
+	SetActorLocation(GridCell.ToWorld(GridSize, GetActorLocation().Z));
+	SyncRenderInstance();
 
 	OnKickStopped();
 
-	UE_LOG(LogTemp, Log, TEXT("Bomb kick stopped at: %s"), *GetActorLocation().ToString());
+	if (UBombermanGridStateComponent* GridState = UBombermanGridStateComponent::Get(this))
+	{
+		GridState->RecordBombStopped(this);
+	}
+
+	UE_LOG(LogBomberman, Verbose, TEXT("Bomb kick stopped at: %s"), *GetActorLocation().ToString());
+}
+
+void ABomb::SnapToCell(FGridCoord Cell)
+{
+	UBombermanGridSubsystem* Grid = GetGridSubsystem();
+	if (!Grid) return;
+
+	if (Cell != GridCell && bRegisteredOnGrid)
+	{
+		Grid->MoveBomb(this, GridCell, Cell);
+	}
+	GridCell = Cell;
+	SetActorLocation(Grid->CellToWorld(Cell, GetActorLocation().Z));
+	SyncRenderInstance();
 }
 
 void ABomb::OnKickCollision()
 {
 	// Special handling in case of collision (if necessary)
-	UE_LOG(LogTemp, Log, TEXT("Bomb kick collision detected"));
+	UE_LOG(LogBomberman, Verbose, TEXT("Bomb kick collision detected"));
 }
 
 void ABomb::EnableOwnerCollision()
@@ -305,39 +410,104 @@ void ABomb::DisableOwnerCollision()
 	}
 }
 
-void ABomb::UpdateTimerEffects(float DeltaTIme)
+void ABomb::ApplyPulseScale(float Scale)
+{
+	// Scale is computed for all bombs at once by UBombUpdateSubsystem
+	PulseScale = Scale;
+	if (RenderHandle.IsValid())
+	{
+		// The hidden mesh component is left alone, only the instance transform moves
+		SyncRenderInstance();
+		return;
+	}
+	BombMesh->SetWorldScale3D(InitialScale * Scale);
+}
+
+UBombermanGridSubsystem* ABomb::GetGridSubsystem() const
+{
+	return GetWorld() ? GetWorld()->GetSubsystem<UBombermanGridSubsystem>() : nullptr;
+}
+
+void ABomb::UnregisterFromGrid()
+{
+	if (!bRegisteredOnGrid) return;
+
+	bRegisteredOnGrid = false;
+	if (UBombermanGridSubsystem* Grid = GetGridSubsystem())
+	{
+		Grid->UnregisterBomb(this, GridCell);
+	}
+}
+
+void ABomb::AddRenderInstance()
 {
-	const float Time = GetWorld()->GetTimeSeconds();
-	// Sine cure value (between -1.0 and 1.0)
-	const float SineValue = FMath::Sin(Time * ScaleAnimationSpeed);
-	// Calculate scale using this sine value (interpolation between MinScale and MaxScale)
-	const float NormalizedSine = (SineValue + 1.0f) * 0.5f; // -1.0~1.0 normalize to 0.0~1.0
+	if (!UInstancedMeshRenderSubsystem::IsEnabled()) return;
+
+	UInstancedMeshRenderSubsystem* Render = GetWorld()->GetSubsystem<UInstancedMeshRenderSubsystem>();
+	if (!Render) return;
+
+	BombMesh->SetRelativeScale3D(InitialScale);
+	PulseScale = 1.0f;
 
-	// Calculated scale value
-	const float CurrentScale = FMath::Lerp(MinAnimScale, MaxAnimScale, NormalizedSine);
+	float CustomData[BombermanInstanceData::NumFloats];
+	CustomData[BombermanInstanceData::BombPulseStartTime] = GetWorld()->GetTimeSeconds();
+	CustomData[BombermanInstanceData::BombPulseSpeed]	  = ScaleAnimationSpeed;
+	CustomData[BombermanInstanceData::BombPulseMinScale]  = MinAnimScale;
+	CustomData[BombermanInstanceData::BombPulseMaxScale]  = MaxAnimScale;
 
-	const FVector NewScale = InitialScale * CurrentScale;
-	BombMesh->SetWorldScale3D(NewScale);
+	RenderHandle = Render->AddInstance(BombMesh, CustomData);
 }
 
-FVector ABomb::GetGridPosition(FVector WorldPosition) const
+void ABomb::SyncRenderInstance()
 {
-	float X = FMath::RoundToFloat(WorldPosition.X / GridSize) * GridSize;
-	float Y = FMath::RoundToFloat(WorldPosition.Y / GridSize) * GridSize;
-	float Z = WorldPosition.Z;
+	if (!RenderHandle.IsValid()) return;
 
-	return FVector(X, Y, Z);
+	if (UInstancedMeshRenderSubsystem* Render = GetWorld()->GetSubsystem<UInstancedMeshRenderSubsystem>())
+	{
+		FTransform Transform = BombMesh->GetComponentTransform();
+		Transform.SetScale3D(InitialScale * PulseScale);
+		Render->UpdateTransform(RenderHandle, Transform);
+	}
+}
+
+void ABomb::RemoveRenderInstance()
+{
+	if (!RenderHandle.IsValid()) return;
+
+	if (UInstancedMeshRenderSubsystem* Render = GetWorld() ? GetWorld()->GetSubsystem<UInstancedMeshRenderSubsystem>() : nullptr)
+	{
+		Render->RemoveInstance(RenderHandle, BombMesh);
+	}
+	RenderHandle.Reset();
+}
+
+UBombUpdateSubsystem* ABomb::GetUpdateSubsystem() const
+{
+	return GetWorld() ? GetWorld()->GetSubsystem<UBombUpdateSubsystem>() : nullptr;
+}
+
+void ABomb::UnregisterFromUpdates()
+{
+	if (UpdateSlot == INDEX_NONE) return;
+
+	if (UBombUpdateSubsystem* Updates = GetUpdateSubsystem())
+	{
+		Updates->Unregister(this);
+	}
+	UpdateSlot = INDEX_NONE;
 }
 
-void ABomb::UpdateOwnerCanPass()
+bool ABomb::UpdateOwnerCanPass()
 {
 	if (BombOwner)
 	{
-		if (FVector::Dist2D(BombOwner->GetActorLocation(), GetActorLocation()) > GridSize)
+		// Solid for the owner once they have left the bomb's cell
+		if (FGridCoord::FromWorld(BombOwner->GetActorLocation(), GridSize) != GridCell)
 		{
 			bOwnerCanPass = false;
 			EnableOwnerCollision();
-			UE_LOG(LogTemp, Log, TEXT("EnableOwnerCollision : %s"), *GetName());
+			UE_LOG(LogBomberman, Verbose, TEXT("EnableOwnerCollision : %s"), *GetName());
 		}
 	}
+	return bOwnerCanPass;
 }
\ No newline at end of file
@@ -0,0 +1,362 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "World/BombUpdateSubsystem.h"
+
+#include "Engine/World.h"
+
+#include "Core/BombermanClock.h"
+#include "Core/BombermanGrid.h"
+#include "Core/BombermanStats.h"
+#include "World/Bomb.h"
+#include "World/BombermanGridSubsystem.h"
+#include "World/ChainReactionSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BombUpdateSubsystem)
+
+void UBombUpdateSubsystem::Deinitialize()
+{
+	for (ABomb* Bomb : Bombs)
+	{
+		if (Bomb) Bomb->UpdateSlot = INDEX_NONE;
+	}
+	Bombs.Empty();
+	FuseEndTicks.Empty();
+	RegisterOrders.Empty();
+	KickDirs.Empty();
+	KickOrigins.Empty();
+	KickTravels.Empty();
+	KickTargets.Empty();
+	KickSpeeds.Empty();
+	KickDecelerations.Empty();
+	OwnerCanPass.Empty();
+	PulseSpeeds.Empty();
+	PulseMinScales.Empty();
+	PulseMaxScales.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UBombUpdateSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBombUpdateSubsystem, STATGROUP_Bomberman);
+}
+
+void UBombUpdateSubsystem::Register(ABomb* Bomb)
+{
+	if (!Bomb || Bomb->UpdateSlot != INDEX_NONE) return;
+
+	Bomb->UpdateSlot = Bombs.Add(Bomb);
+	FuseEndTicks.Add(TNumericLimits<int64>::Max());
+	RegisterOrders.Add(NextRegisterOrder++);
+	KickDirs.Add(INDEX_NONE);
+	KickOrigins.Add(FVector::ZeroVector);
+	KickTravels.Add(0);
+	KickTargets.Add(0);
+	KickSpeeds.Add(0);
+	KickDecelerations.Add(BombermanClock::AccelerationToFixed(Bomb->KickDeceleration));
+	OwnerCanPass.Add(1);
+	PulseSpeeds.Add(Bomb->ScaleAnimationSpeed);
+	PulseMinScales.Add(Bomb->MinAnimScale);
+	PulseMaxScales.Add(Bomb->MaxAnimScale);
+}
+
+void UBombUpdateSubsystem::Unregister(ABomb* Bomb)
+{
+	if (!Bomb || !Bombs.IsValidIndex(Bomb->UpdateSlot) || Bombs[Bomb->UpdateSlot] != Bomb) return;
+
+	// Swap the last slot into the hole
+	const int32 Slot = Bomb->UpdateSlot;
+	Bombs.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	FuseEndTicks.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	RegisterOrders.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	KickDirs.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	KickOrigins.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	KickTravels.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	KickTargets.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	KickSpeeds.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	KickDecelerations.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	OwnerCanPass.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	PulseSpeeds.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	PulseMinScales.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	PulseMaxScales.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+
+	if (Bombs.IsValidIndex(Slot))
+	{
+		Bombs[Slot]->UpdateSlot = Slot;
+	}
+	Bomb->UpdateSlot = INDEX_NONE;
+}
+
+void UBombUpdateSubsystem::SetFuse(const ABomb* Bomb, float Seconds)
+{
+	if (!Bombs.IsValidIndex(Bomb->UpdateSlot)) return;
+
+	FuseEndTicks[Bomb->UpdateSlot] = CurrentTick + BombermanClock::SecondsToTicks(Seconds);
+	if (UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>())
+	{
+		Grid->SetBombFuseTick(Bomb, FuseEndTicks[Bomb->UpdateSlot]);
+	}
+}
+
+int64 UBombUpdateSubsystem::GetFuseEndTick(const ABomb* Bomb) const
+{
+	return Bombs.IsValidIndex(Bomb->UpdateSlot) ? FuseEndTicks[Bomb->UpdateSlot] : TNumericLimits<int64>::Max();
+}
+
+float UBombUpdateSubsystem::GetFuseRemaining(const ABomb* Bomb) const
+{
+	if (!Bombs.IsValidIndex(Bomb->UpdateSlot)) return 0.0f;
+
+	const int64 FuseEnd = FuseEndTicks[Bomb->UpdateSlot];
+	return FuseEnd == TNumericLimits<int64>::Max() ? 0.0f : BombermanClock::TicksToSeconds(FMath::Max<int64>(0, FuseEnd - CurrentTick));
+}
+
+namespace
+{
+	// Fixed point travel from one cell center to the next, even so the half way mark is exact
+	int32 GetCellTravel(const UBombermanGridSubsystem& Grid)
+	{
+		return FMath::Max(2, FMath::RoundToInt32(Grid.GetCellSize() * BombermanClock::FixedOne) & ~1);
+	}
+}
+
+int32 UBombUpdateSubsystem::StartKick(const ABomb* Bomb, int32 Dir, float Speed)
+{
+	const int32 Slot				   = Bomb->UpdateSlot;
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Bombs.IsValidIndex(Slot) || !Grid || Dir < 0 || Dir >= 4) return 0;
+
+	// Distance friction allows, summed the same way StepKickSlot integrates it
+	const int32 StartSpeed	 = BombermanClock::SpeedToFixed(Speed);
+	const int32 Deceleration = FMath::Max(1, KickDecelerations[Slot]);
+	int64 FrictionTravel	 = 0;
+	for (int32 TickSpeed = StartSpeed - Deceleration; TickSpeed > 0; TickSpeed -= Deceleration)
+	{
+		FrictionTravel += TickSpeed;
+	}
+
+	// Whole cells only, up to the first one already taken
+	const int32 CellTravel = GetCellTravel(*Grid);
+	const int32 MaxCells   = int32(FMath::Min<int64>(FrictionTravel / CellTravel, MAX_int32 / CellTravel));
+	const FGridCoord Start = Bomb->GetGridCell();
+	int32 Cells			   = 0;
+	while (Cells < MaxCells && !Grid->HasAny(Start + GridDirections[Dir] * (Cells + 1), EGridCellFlags::KickStop))
+	{
+		Cells++;
+	}
+	if (Cells == 0) return 0;
+
+	KickDirs[Slot]	  = int8(Dir);
+	KickOrigins[Slot] = Grid->CellToWorld(Start, Bomb->GetActorLocation().Z);
+	KickTravels[Slot] = 0;
+	KickTargets[Slot] = Cells * CellTravel;
+	KickSpeeds[Slot]  = StartSpeed;
+	return Cells;
+}
+
+void UBombUpdateSubsystem::StopKick(const ABomb* Bomb)
+{
+	if (Bombs.IsValidIndex(Bomb->UpdateSlot))
+	{
+		KickSpeeds[Bomb->UpdateSlot] = 0;
+	}
+}
+
+void UBombUpdateSubsystem::AdvanceKick(const ABomb* Bomb, float Seconds)
+{
+	const int32 Slot = Bomb->UpdateSlot;
+	if (!Bombs.IsValidIndex(Slot)) return;
+
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid) return;
+
+	const int32 Ticks = BombermanClock::SecondsToTicks(Seconds);
+	for (int32 Tick = 0; Tick < Ticks && KickSpeeds[Slot] > 0; Tick++)
+	{
+		StepKickSlot(Slot, *Grid);
+	}
+}
+
+void UBombUpdateSubsystem::SetOwnerCanPass(const ABomb* Bomb, bool bCanPass)
+{
+	if (Bombs.IsValidIndex(Bomb->UpdateSlot))
+	{
+		OwnerCanPass[Bomb->UpdateSlot] = bCanPass ? 1 : 0;
+	}
+}
+
+void UBombUpdateSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	BombermanStats::ReportGauges(Bombs.Num());
+
+	// Gameplay advances in whole ticks, the remainder carries over to the next frame
+	TickAccumulator += DeltaTime;
+	int32 Steps = 0;
+	while (TickAccumulator >= BombermanClock::SecondsPerTick && Steps < BombermanClock::MaxStepsPerFrame)
+	{
+		TickAccumulator -= BombermanClock::SecondsPerTick;
+		StepFixed();
+		Steps++;
+	}
+	TickAccumulator = FMath::Min(TickAccumulator, BombermanClock::SecondsPerTick);
+
+	if (Bombs.Num() == 0) return;
+
+	// Presentation only, follows the frame
+	UpdateOwnerPass();
+	UpdatePulse(GetWorld()->GetTimeSeconds());
+}
+
+void UBombUpdateSubsystem::StepFixed()
+{
+	CurrentTick++;
+
+	if (Bombs.Num() > 0)
+	{
+		UpdateKicks();
+		UpdateFuses();
+	}
+
+	// Same step, so the order of the subsystem ticks cannot move a detonation by a frame
+	if (UChainReactionSubsystem* ChainReaction = GetWorld()->GetSubsystem<UChainReactionSubsystem>())
+	{
+		ChainReaction->StepFixed(CurrentTick);
+	}
+
+	OnFixedTickEnd.Broadcast(CurrentTick);
+}
+
+void UBombUpdateSubsystem::UpdateFuses()
+{
+	ExpiredSlots.Reset();
+
+	const int32 Count		 = Bombs.Num();
+	int64* RESTRICT FuseEnds = FuseEndTicks.GetData();
+	for (int32 Slot = 0; Slot < Count; Slot++)
+	{
+		if (FuseEnds[Slot] <= CurrentTick)
+		{
+			FuseEnds[Slot] = TNumericLimits<int64>::Max();
+			ExpiredSlots.Add(Slot);
+		}
+	}
+
+	if (ExpiredSlots.Num() == 0) return;
+
+	// Slots are reshuffled by removals, registration order is the same on every machine
+	ExpiredSlots.Sort([this](int32 A, int32 B) { return RegisterOrders[A] < RegisterOrders[B]; });
+
+	ExpiredBombs.Reset();
+	for (int32 Slot : ExpiredSlots)
+	{
+		ExpiredBombs.Add(Bombs[Slot]);
+	}
+
+	// Explode only queues the bomb, slots stay stable until the chain is resolved
+	for (ABomb* Bomb : ExpiredBombs)
+	{
+		Bomb->Explode();
+	}
+}
+
+void UBombUpdateSubsystem::UpdateKicks()
+{
+	BOMBERMAN_SCOPE(KickSweep);
+
+	const UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>();
+	if (!Grid) return;
+
+	for (int32 Slot = 0; Slot < Bombs.Num(); Slot++)
+	{
+		if (KickSpeeds[Slot] > 0)
+		{
+			StepKickSlot(Slot, *Grid);
+		}
+	}
+}
+
+void UBombUpdateSubsystem::StepKickSlot(int32 Slot, const UBombermanGridSubsystem& Grid)
+{
+	ABomb* Bomb			   = Bombs[Slot];
+	const FGridCoord Dir   = GridDirections[KickDirs[Slot]];
+	const int32 CellTravel = GetCellTravel(Grid);
+	const int32 HalfCell   = CellTravel / 2;
+
+	// Deceleration, the planned stop cell is always reached before friction would stop the bomb
+	KickSpeeds[Slot] = FMath::Max(1, KickSpeeds[Slot] - KickDecelerations[Slot]);
+
+	const int32 From = KickTravels[Slot];
+	int32 To		 = FMath::Min(From + KickSpeeds[Slot], KickTargets[Slot]);
+	bool bBlocked	 = false;
+
+	// The way ahead is checked on the grid when the bomb leaves a cell center and again half way,
+	// where it moves over to the next cell. Something in the way stops it on its current center
+	for (int32 Mark = (From / HalfCell + 1) * HalfCell; Mark <= To && Mark < KickTargets[Slot]; Mark += HalfCell)
+	{
+		const FGridCoord Next = Bomb->GetGridCell() + Dir;
+		const bool bHalfWay	  = Mark % CellTravel != 0;
+		if (Grid.HasAny(Next, EGridCellFlags::KickStop))
+		{
+			KickTargets[Slot] = bHalfWay ? Mark - HalfCell : Mark;
+			To				  = KickTargets[Slot];
+			bBlocked		  = true;
+			break;
+		}
+		if (bHalfWay)
+		{
+			Bomb->EnterKickCell(Next);
+		}
+	}
+
+	// Whole units from the kick origin, so the position only ever holds integers
+	KickTravels[Slot]	 = To;
+	const int32 Distance = To >> BombermanClock::FixedShift;
+	Bomb->SetKickLocation(KickOrigins[Slot] + FVector(Dir.X * Distance, Dir.Y * Distance, 0.0));
+
+	if (To >= KickTargets[Slot])
+	{
+		if (bBlocked)
+		{
+			Bomb->OnKickCollision();
+		}
+		Bomb->StopKick();
+	}
+}
+
+void UBombUpdateSubsystem::UpdateOwnerPass()
+{
+	for (int32 Slot = 0; Slot < Bombs.Num(); Slot++)
+	{
+		if (OwnerCanPass[Slot] && !Bombs[Slot]->UpdateOwnerCanPass())
+		{
+			OwnerCanPass[Slot] = 0;
+		}
+	}
+}
+
+void UBombUpdateSubsystem::UpdatePulse(double Time)
+{
+	const int32 Count = Bombs.Num();
+	PulseScales.SetNumUninitialized(Count, EAllowShrinking::No);
+
+	// Plain float arrays without branches so the compiler can vectorize the pulse
+	const float T					= float(Time);
+	const float* RESTRICT Speeds	= PulseSpeeds.GetData();
+	const float* RESTRICT MinScales = PulseMinScales.GetData();
+	const float* RESTRICT MaxScales = PulseMaxScales.GetData();
+	float* RESTRICT Scales			= PulseScales.GetData();
+
+	for (int32 Slot = 0; Slot < Count; Slot++)
+	{
+		// Sine curve value (between -1.0 and 1.0) normalized to 0.0~1.0
+		const float NormalizedSine = (FMath::Sin(T * Speeds[Slot]) + 1.0f) * 0.5f;
+		Scales[Slot]			   = MinScales[Slot] + (MaxScales[Slot] - MinScales[Slot]) * NormalizedSine;
+	}
+
+	for (int32 Slot = 0; Slot < Count; Slot++)
+	{
+		Bombs[Slot]->ApplyPulseScale(Scales[Slot]);
+	}
+}
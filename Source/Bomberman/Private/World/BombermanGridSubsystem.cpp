@@ -0,0 +1,524 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "World/BombermanGridSubsystem.h"
+
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "Engine/OverlapResult.h"
+#include "GameFramework/PlayerStart.h"
+
+#include "Core/BombermanClock.h"
+#include "Core/BombermanLog.h"
+#include "Core/BombermanStats.h"
+#include "Player/BombermanCharacter.h"
+#include "Sim/BombermanSim.h"
+#include "World/Bomb.h"
+#include "World/BombUpdateSubsystem.h"
+#include "World/DestructibleBlock.h"
+#include "World/Explosion.h"
+#include "World/Powerup.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(BombermanGridSubsystem)
+
+void UBombermanGridSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	RebuildFromWorld();
+}
+
+void UBombermanGridSubsystem::Deinitialize()
+{
+	Bombs.Empty();
+	Players.Empty();
+	PlayerCellIndices.Empty();
+	BlockCells.Empty();
+	BombCells.Empty();
+	ExplosionCells.Empty();
+	PowerupCounts.Empty();
+	Grid = FBombermanGrid();
+	DangerMap.Reset(Grid);
+
+	Super::Deinitialize();
+}
+
+TStatId UBombermanGridSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBombermanGridSubsystem, STATGROUP_Bomberman);
+}
+
+void UBombermanGridSubsystem::RebuildFromWorld()
+{
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	// Arena bounds from the player starts and destructible blocks
+	FBox Bounds(ForceInit);
+	float ProbeZ	= 0.0f;
+	bool bHasProbeZ = false;
+
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		Bounds += It->GetActorLocation();
+		ProbeZ	   = bHasProbeZ ? FMath::Min(ProbeZ, It->GetActorLocation().Z) : It->GetActorLocation().Z;
+		bHasProbeZ = true;
+	}
+	for (TActorIterator<ADestructibleBlock> It(World); It; ++It)
+	{
+		Bounds += It->GetActorLocation();
+		if (!bHasProbeZ)
+		{
+			ProbeZ	   = It->GetActorLocation().Z;
+			bHasProbeZ = true;
+		}
+	}
+
+	FGridCoord MinCell;
+	FGridCoord MaxCell;
+	if (Bounds.IsValid)
+	{
+		Grid.CellSize = CellSize;
+		MinCell		  = Grid.WorldToCell(Bounds.Min) - FGridCoord(BoundsPadding, BoundsPadding);
+		MaxCell		  = Grid.WorldToCell(Bounds.Max) + FGridCoord(BoundsPadding, BoundsPadding);
+	}
+	else
+	{
+		MinCell = FGridCoord(-FallbackHalfExtentCells, -FallbackHalfExtentCells);
+		MaxCell = FGridCoord(FallbackHalfExtentCells, FallbackHalfExtentCells);
+	}
+
+	Grid.Init(MinCell, MaxCell.X - MinCell.X + 1, MaxCell.Y - MinCell.Y + 1, CellSize);
+	BlockCells.Reset();
+	BlockCells.SetNum(Grid.Num());
+	BombCells.Reset();
+	BombCells.SetNum(Grid.Num());
+	ExplosionCells.Reset();
+	ExplosionCells.SetNum(Grid.Num());
+	PowerupCounts.Init(0, Grid.Num());
+	PlayerCellIndices.Init(INDEX_NONE, Players.Num());
+	DangerMap.Reset(Grid);
+	LayoutVersion++;
+
+	ProbeWalls(ProbeZ);
+
+	// Re-apply everything that registered before the rebuild
+	for (TActorIterator<ADestructibleBlock> It(World); It; ++It)
+	{
+		if (It->HasActorBegunPlay()) RegisterBlock(*It);
+	}
+	for (const TWeakObjectPtr<ABomb>& Bomb : Bombs)
+	{
+		if (!Bomb.IsValid() || !Grid.Contains(Bomb->GetGridCell())) continue;
+
+		Grid.Add(Bomb->GetGridCell(), EGridCellFlags::Bomb);
+		BombCells[Grid.ToIndex(Bomb->GetGridCell())] = Bomb;
+		AddBombDanger(Bomb.Get(), Bomb->GetGridCell());
+	}
+	for (TActorIterator<APowerup> It(World); It; ++It)
+	{
+		if (It->HasActorBegunPlay()) RegisterPowerup(*It);
+	}
+	UpdatePlayerCells();
+
+	UE_LOG(LogBomberman, Log, TEXT("Grid built: %d x %d cells, origin cell %s"), Grid.Width, Grid.Height, *Grid.MinCell.ToString());
+}
+
+void UBombermanGridSubsystem::ProbeWalls(float ProbeZ)
+{
+	// One overlap per cell at startup replaces the per-explosion line traces
+	const FVector ProbeExtent(CellSize * 0.4f, CellSize * 0.4f, WallProbeHalfHeight);
+	const FCollisionShape ProbeShape = FCollisionShape::MakeBox(ProbeExtent);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(BombermanGridProbe), false);
+
+	TArray<FOverlapResult> Overlaps;
+	for (int32 Index = 0; Index < Grid.Num(); Index++)
+	{
+		const FVector Center = Grid.CellToWorld(Grid.ToCell(Index), ProbeZ);
+
+		Overlaps.Reset();
+		GetWorld()->OverlapMultiByChannel(Overlaps, Center, FQuat::Identity, ECC_WorldStatic, ProbeShape, QueryParams);
+
+		for (const FOverlapResult& Overlap : Overlaps)
+		{
+			const AActor* Actor = Overlap.GetActor();
+			if (!Actor || !Overlap.bBlockingHit) continue;
+
+			// Dynamic occupants register themselves
+			if (Actor->IsA<ADestructibleBlock>() || Actor->IsA<ABomb>() || Actor->IsA<APowerup>() || Actor->IsA<APawn>()) continue;
+
+			Grid.Cells[Index] |= EGridCellFlags::Wall;
+			break;
+		}
+	}
+}
+
+// ===== Bombs =====
+
+FGridCoord UBombermanGridSubsystem::RegisterBomb(ABomb* Bomb)
+{
+	const FGridCoord Cell = Grid.WorldToCell(Bomb->GetActorLocation());
+	Grid.Add(Cell, EGridCellFlags::Bomb);
+	if (Grid.Contains(Cell)) BombCells[Grid.ToIndex(Cell)] = Bomb;
+	Bombs.AddUnique(Bomb);
+	LayoutVersion++;
+	AddBombDanger(Bomb, Cell);
+	return Cell;
+}
+
+void UBombermanGridSubsystem::UnregisterBomb(ABomb* Bomb, FGridCoord Cell)
+{
+	Bombs.RemoveSwap(Bomb);
+	if (!Grid.Contains(Cell)) return;
+
+	// A recycled bomb may already sit on another cell under the same pointer
+	const int32 Index = Grid.ToIndex(Cell);
+	if (BombCells[Index] == Bomb)
+	{
+		BombCells[Index] = nullptr;
+		Grid.Remove(Cell, EGridCellFlags::Bomb);
+		DangerMap.RemoveBomb(Grid, Cell);
+		LayoutVersion++;
+	}
+}
+
+void UBombermanGridSubsystem::MoveBomb(ABomb* Bomb, FGridCoord From, FGridCoord To)
+{
+	const bool bLeftFrom = Grid.Contains(From) && BombCells[Grid.ToIndex(From)] == Bomb;
+	if (bLeftFrom)
+	{
+		BombCells[Grid.ToIndex(From)] = nullptr;
+		Grid.Remove(From, EGridCellFlags::Bomb);
+	}
+	if (Grid.Contains(To))
+	{
+		BombCells[Grid.ToIndex(To)] = Bomb;
+		Grid.Add(To, EGridCellFlags::Bomb);
+	}
+
+	LayoutVersion++;
+
+	if (bLeftFrom)
+	{
+		DangerMap.MoveBomb(Grid, From, To);
+	}
+	else
+	{
+		AddBombDanger(Bomb, To);
+	}
+}
+
+void UBombermanGridSubsystem::AddBombDanger(const ABomb* Bomb, FGridCoord Cell)
+{
+	const AExplosion* ExplosionCDO		= Bomb->GetExplosionClass() ? Bomb->GetExplosionClass()->GetDefaultObject<AExplosion>() : nullptr;
+	const int32 ChainDelayTicks			= ExplosionCDO ? BombermanClock::SecondsToTicks(ExplosionCDO->GetChainExplosionDelay()) : 0;
+	const UBombUpdateSubsystem* Updates = GetWorld()->GetSubsystem<UBombUpdateSubsystem>();
+
+	// Placed bombs register before their fuse is set, SetBombFuseTick follows
+	DangerMap.AddBomb(Grid, Cell, Bomb->GetBombPower(), Updates ? Updates->GetFuseEndTick(Bomb) : FBombermanDangerMap::Never, ChainDelayTicks);
+}
+
+void UBombermanGridSubsystem::SetBombFuseTick(const ABomb* Bomb, int64 Tick)
+{
+	if (GetBombAt(Bomb->GetGridCell()) == Bomb)
+	{
+		DangerMap.SetBombFuseTick(Grid, Bomb->GetGridCell(), Tick);
+	}
+}
+
+void UBombermanGridSubsystem::SetBombRange(const ABomb* Bomb, int32 Range)
+{
+	if (GetBombAt(Bomb->GetGridCell()) == Bomb)
+	{
+		DangerMap.SetBombRange(Grid, Bomb->GetGridCell(), Range);
+	}
+}
+
+int64 UBombermanGridSubsystem::GetBurnTick(FGridCoord Cell) const
+{
+	if (!Grid.Contains(Cell)) return FBombermanDangerMap::Never;
+
+	const int32 Index = Grid.ToIndex(Cell);
+	return EnumHasAnyFlags(Grid.Cells[Index], EGridCellFlags::Burning) ? 0 : DangerMap.GetBurnTick(Index);
+}
+
+float UBombermanGridSubsystem::GetSecondsUntilBurn(const FVector& WorldLocation) const
+{
+	const int64 BurnTick = GetBurnTick(Grid.WorldToCell(WorldLocation));
+	if (BurnTick == FBombermanDangerMap::Never) return -1.0f;
+
+	const UBombUpdateSubsystem* Updates = GetWorld()->GetSubsystem<UBombUpdateSubsystem>();
+	return BombermanClock::TicksToSeconds(FMath::Max<int64>(0, BurnTick - (Updates ? Updates->GetCurrentTick() : 0)));
+}
+
+ABomb* UBombermanGridSubsystem::GetBombAt(FGridCoord Cell) const
+{
+	return Grid.Contains(Cell) ? BombCells[Grid.ToIndex(Cell)].Get() : nullptr;
+}
+
+ABomb* UBombermanGridSubsystem::GetAdjacentBomb(FGridCoord Cell, int32 Dir) const
+{
+	if (Dir < 0 || Dir >= 4) return nullptr;
+
+	return GetBombAt(Cell + GridDirections[Dir]);
+}
+
+// ===== Blocks =====
+
+void UBombermanGridSubsystem::RegisterBlock(ADestructibleBlock* Block)
+{
+	const FGridCoord Cell = Grid.WorldToCell(Block->GetActorLocation());
+	if (!Grid.Contains(Cell)) return;
+
+	Grid.Add(Cell, EGridCellFlags::Block);
+	BlockCells[Grid.ToIndex(Cell)] = Block;
+	DangerMap.CellChanged(Grid, Cell);
+	LayoutVersion++;
+}
+
+void UBombermanGridSubsystem::UnregisterBlock(ADestructibleBlock* Block)
+{
+	const FGridCoord Cell = Grid.WorldToCell(Block->GetActorLocation());
+	if (!Grid.Contains(Cell)) return;
+
+	const int32 Index = Grid.ToIndex(Cell);
+	if (BlockCells[Index] == Block)
+	{
+		BlockCells[Index] = nullptr;
+		Grid.Remove(Cell, EGridCellFlags::Block);
+		DangerMap.CellChanged(Grid, Cell);
+		LayoutVersion++;
+	}
+}
+
+ADestructibleBlock* UBombermanGridSubsystem::GetBlockAt(FGridCoord Cell) const
+{
+	return Grid.Contains(Cell) ? BlockCells[Grid.ToIndex(Cell)].Get() : nullptr;
+}
+
+// ===== Explosions =====
+
+void UBombermanGridSubsystem::RegisterExplosion(AExplosion* Explosion, FGridCoord Cell)
+{
+	if (!Grid.Contains(Cell)) return;
+
+	ExplosionCells[Grid.ToIndex(Cell)].AddUnique(Explosion);
+	Grid.Add(Cell, EGridCellFlags::Burning);
+}
+
+void UBombermanGridSubsystem::UnregisterExplosion(AExplosion* Explosion, FGridCoord Cell)
+{
+	if (!Grid.Contains(Cell)) return;
+
+	// The cell keeps burning while another blast is still on it
+	TArray<TWeakObjectPtr<AExplosion>, TInlineAllocator<2>>& Explosions = ExplosionCells[Grid.ToIndex(Cell)];
+	Explosions.RemoveAll([Explosion](const TWeakObjectPtr<AExplosion>& Burning) { return !Burning.IsValid() || Burning == Explosion; });
+	if (Explosions.Num() == 0)
+	{
+		Grid.Remove(Cell, EGridCellFlags::Burning);
+	}
+}
+
+AExplosion* UBombermanGridSubsystem::GetExplosionAt(FGridCoord Cell) const
+{
+	if (!Grid.Contains(Cell)) return nullptr;
+
+	const TArray<TWeakObjectPtr<AExplosion>, TInlineAllocator<2>>& Explosions = ExplosionCells[Grid.ToIndex(Cell)];
+	for (int32 Index = Explosions.Num() - 1; Index >= 0; Index--)
+	{
+		if (AExplosion* Explosion = Explosions[Index].Get()) return Explosion;
+	}
+	return nullptr;
+}
+
+// ===== Powerups =====
+
+void UBombermanGridSubsystem::RegisterPowerup(APowerup* Powerup)
+{
+	const FGridCoord Cell = Grid.WorldToCell(Powerup->GetActorLocation());
+	if (!Grid.Contains(Cell)) return;
+
+	PowerupCounts[Grid.ToIndex(Cell)]++;
+	Grid.Add(Cell, EGridCellFlags::Powerup);
+}
+
+void UBombermanGridSubsystem::UnregisterPowerup(APowerup* Powerup)
+{
+	const FGridCoord Cell = Grid.WorldToCell(Powerup->GetActorLocation());
+	if (!Grid.Contains(Cell)) return;
+
+	// The flag stays while another powerup still lies on the cell
+	uint8& Count = PowerupCounts[Grid.ToIndex(Cell)];
+	if (Count > 0 && --Count == 0)
+	{
+		Grid.Remove(Cell, EGridCellFlags::Powerup);
+	}
+}
+
+// ===== Simulation =====
+
+void UBombermanGridSubsystem::CaptureSimState(const FSimRules& Rules, FSimState& OutState) const
+{
+	OutState = FSimState();
+	OutState.Grid = Grid;
+	OutState.Powerups.Init(ESimPowerup::None, Grid.Num());
+	OutState.BurnTicks.Init(0, Grid.Num());
+	OutState.BurnOwners.Init(INDEX_NONE, Grid.Num());
+	const UBombUpdateSubsystem* Updates = GetWorld()->GetSubsystem<UBombUpdateSubsystem>();
+	OutState.Tick = Updates ? int32(Updates->GetCurrentTick()) : 0;
+	OutState.Random.Initialize(OutState.Tick);
+
+	// Powerup actors carry no type yet, the simulation treats their cells as empty
+	for (EGridCellFlags& Cell : OutState.Grid.Cells)
+	{
+		Cell &= ~(EGridCellFlags::Powerup | EGridCellFlags::Burning);
+	}
+
+	for (const TWeakObjectPtr<ABombermanCharacter>& WeakPlayer : Players)
+	{
+		const ABombermanCharacter* Player = WeakPlayer.Get();
+		FSimPlayer& SimPlayer			  = OutState.Players.AddDefaulted_GetRef();
+		if (!Player)
+		{
+			SimPlayer.bAlive = false;
+			continue;
+		}
+
+		SimPlayer.Cell			= Grid.WorldToCell(Player->GetActorLocation());
+		SimPlayer.SpawnCell		= SimPlayer.Cell;
+		SimPlayer.Facing		= FMath::Max(0, GridDirectionFromVector(Player->GetActorForwardVector()));
+		SimPlayer.MaxBombCount	= Player->GetMaxBombCount();
+		SimPlayer.BombPower		= Player->GetBombPower();
+		SimPlayer.MoveSpeed		= FMath::RoundToInt32(Player->GetMoveSpeed());
+		SimPlayer.bCanKickBombs = Player->CanKickBombs();
+		SimPlayer.ActiveBombs	= Player->GetBombCount();
+		SimPlayer.bAlive		= !Player->IsDead();
+		SimPlayer.RespawnTicks	= SimPlayer.bAlive ? 0 : Rules.RespawnTicks;
+	}
+
+	for (const TWeakObjectPtr<ABomb>& WeakBomb : Bombs)
+	{
+		const ABomb* Bomb = WeakBomb.Get();
+		if (!Bomb) continue;
+
+		FSimBomb& SimBomb = OutState.Bombs.AddDefaulted_GetRef();
+		SimBomb.Cell	  = Bomb->GetGridCell();
+		SimBomb.Owner	  = Players.IndexOfByKey(Bomb->GetBombOwner());
+		SimBomb.Range	  = Bomb->GetBombPower();
+
+		// Bombs already in a resolved chain go off as soon as possible
+		const float FuseSeconds = Bomb->IsExploding() || !Updates ? 0.0f : Updates->GetFuseRemaining(Bomb);
+		SimBomb.FuseTicks		= FMath::Max(1, FMath::CeilToInt32(FuseSeconds * Rules.TicksPerSecond));
+	}
+
+	// The sim keeps one burn per cell: the longest one and its owner
+	for (int32 Index = 0; Index < Grid.Num(); Index++)
+	{
+		for (const TWeakObjectPtr<AExplosion>& WeakExplosion : ExplosionCells[Index])
+		{
+			const AExplosion* Explosion = WeakExplosion.Get();
+			if (!Explosion) continue;
+
+			const uint16 BurnTicks = uint16(FMath::Max(1, FMath::CeilToInt32(Explosion->GetRemainingLifeTime() * Rules.TicksPerSecond)));
+			if (BurnTicks < OutState.BurnTicks[Index]) continue;
+
+			OutState.BurnTicks[Index]  = BurnTicks;
+			OutState.BurnOwners[Index] = int8(Players.IndexOfByKey(Explosion->GetExplosionOwner()));
+		}
+	}
+}
+
+// ===== Players =====
+
+void UBombermanGridSubsystem::RegisterPlayer(ABombermanCharacter* Player)
+{
+	if (Players.Contains(Player)) return;
+
+	// A newcomer takes over the first seat left behind, the other seats keep their index
+	const int32 Slot = Players.IndexOfByPredicate([](const TWeakObjectPtr<ABombermanCharacter>& Seated) { return !Seated.IsValid(); });
+	if (Slot == INDEX_NONE)
+	{
+		Players.Add(Player);
+		PlayerCellIndices.Add(INDEX_NONE);
+	}
+	else
+	{
+		Players[Slot] = Player;
+	}
+	UpdatePlayerCells();
+}
+
+void UBombermanGridSubsystem::UnregisterPlayer(ABombermanCharacter* Player)
+{
+	const int32 Slot = Players.IndexOfByKey(Player);
+	if (Slot == INDEX_NONE) return;
+
+	if (PlayerCellIndices[Slot] != INDEX_NONE) Grid.Cells[PlayerCellIndices[Slot]] &= ~EGridCellFlags::Player;
+
+	// Slots are seats (sim states, replays, bots), leave the slot empty instead of shifting the later ones
+	Players[Slot].Reset();
+	PlayerCellIndices[Slot] = INDEX_NONE;
+	UpdatePlayerCells();
+}
+
+void UBombermanGridSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UpdatePlayerCells();
+
+	// Damage is server-authoritative, client grids only mirror the burning cells
+	if (GetWorld()->GetNetMode() != NM_Client)
+	{
+		ApplyBlastDamage();
+	}
+}
+
+void UBombermanGridSubsystem::UpdatePlayerCells()
+{
+	if (!Grid.IsValid()) return;
+
+	// Players can share a cell, so clear all of them before setting the new ones
+	for (int32& CellIndex : PlayerCellIndices)
+	{
+		if (CellIndex != INDEX_NONE) Grid.Cells[CellIndex] &= ~EGridCellFlags::Player;
+		CellIndex = INDEX_NONE;
+	}
+
+	for (int32 Slot = 0; Slot < Players.Num(); Slot++)
+	{
+		const ABombermanCharacter* Player = Players[Slot].Get();
+		if (!Player || Player->IsDead()) continue;
+
+		const FGridCoord Cell = Grid.WorldToCell(Player->GetActorLocation());
+		if (!Grid.Contains(Cell)) continue;
+
+		PlayerCellIndices[Slot] = Grid.ToIndex(Cell);
+		Grid.Cells[PlayerCellIndices[Slot]] |= EGridCellFlags::Player;
+	}
+}
+
+void UBombermanGridSubsystem::ApplyBlastDamage()
+{
+	BOMBERMAN_SCOPE(BlastDamage);
+
+	// One pass over the occupied player cells against the burning ones
+	for (int32 Slot = 0; Slot < Players.Num(); Slot++)
+	{
+		const int32 CellIndex = PlayerCellIndices[Slot];
+		if (CellIndex == INDEX_NONE || !EnumHasAnyFlags(Grid.Cells[CellIndex], EGridCellFlags::Burning)) continue;
+
+		ABombermanCharacter* Player = Players[Slot].Get();
+		if (!Player) continue;
+
+		// Every blast on the cell gets its say, each one spares only its own owner.
+		// By index, a hit runs gameplay code that may register or end blasts.
+		for (int32 Index = 0; Index < ExplosionCells[CellIndex].Num(); Index++)
+		{
+			if (AExplosion* Explosion = ExplosionCells[CellIndex][Index].Get())
+			{
+				Explosion->DamagePlayer(Player);
+			}
+		}
+	}
+}
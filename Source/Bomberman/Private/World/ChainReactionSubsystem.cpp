@@ -0,0 +1,258 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "World/ChainReactionSubsystem.h"
+
+#include "Engine/World.h"
+
+#include "Core/BombermanClock.h"
+#include "Core/BombermanLog.h"
+#include "Core/BombermanStats.h"
+#include "World/Bomb.h"
+#include "World/BombermanGridSubsystem.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(ChainReactionSubsystem)
+
+void UChainReactionSubsystem::Deinitialize()
+{
+	Queue.Empty();
+	LiveExplosions.Empty();
+	Pending.Empty();
+	PendingCells.Empty();
+	Result.Reset();
+
+	Super::Deinitialize();
+}
+
+TStatId UChainReactionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UChainReactionSubsystem, STATGROUP_Bomberman);
+}
+
+void UChainReactionSubsystem::QueueDetonation(ABomb* Bomb, float Delay)
+{
+	if (!Bomb || Bomb->IsExploding()) return;
+
+	for (const FQueuedDetonation& Queued : Queue)
+	{
+		if (Queued.Bomb == Bomb) return;
+	}
+	Queue.Add({Bomb, Delay});
+}
+
+void UChainReactionSubsystem::TrackExplosion(AExplosion* Explosion)
+{
+	LiveExplosions.Add(Explosion);
+}
+
+void UChainReactionSubsystem::UntrackExplosion(AExplosion* Explosion)
+{
+	LiveExplosions.RemoveSingleSwap(Explosion, EAllowShrinking::No);
+}
+
+void UChainReactionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Detonations queued outside the fixed step (deaths, forced explosions) go off right away
+	ResolveQueued();
+
+	if (Pending.Num() > 0)
+	{
+		DetonatePending(CurrentTick);
+	}
+}
+
+void UChainReactionSubsystem::StepFixed(int64 Tick)
+{
+	CurrentTick = Tick;
+
+	// Before the new detonations, so a cell re-ignited this tick is not cleared by the old explosion
+	if (LiveExplosions.Num() > 0)
+	{
+		ExpireExplosions(Tick);
+	}
+
+	ResolveQueued();
+
+	if (Pending.Num() > 0)
+	{
+		DetonatePending(Tick);
+	}
+}
+
+void UChainReactionSubsystem::ResolveQueued()
+{
+	if (Queue.Num() == 0) return;
+
+	if (UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>())
+	{
+		Resolve(*Grid);
+	}
+	Queue.Reset();
+}
+
+void UChainReactionSubsystem::Resolve(UBombermanGridSubsystem& Grid)
+{
+	BOMBERMAN_SCOPE(ChainResolve);
+
+	const FBombermanGrid& GridData = Grid.GetGrid();
+
+	// Scratch is reused across resolves: sized for the whole grid once, then only cleared
+	Result.Reset();
+	if (BurnedCells.Num() != GridData.Num())
+	{
+		BurnedCells.Init(false, GridData.Num());
+		Result.Cells.Reserve(GridData.Num());
+		PendingCells.Reserve(GridData.Num());
+	}
+	else
+	{
+		BurnedCells.SetRange(0, BurnedCells.Num(), false);
+	}
+
+	// Seeds: everything that detonates this tick
+	for (const FQueuedDetonation& Queued : Queue)
+	{
+		ABomb* Bomb = Queued.Bomb.Get();
+		if (!Bomb || Bomb->IsExploding()) continue;
+
+		Bomb->BeginDetonation();
+
+		FChainBomb& ChainBomb = Result.Bombs.AddDefaulted_GetRef();
+		ChainBomb.Bomb		  = Bomb;
+		ChainBomb.Cell		  = Bomb->GetGridCell();
+		ChainBomb.Delay		  = Queued.Delay;
+	}
+	// Keep the breadth-first order by time so a cell always belongs to the earliest blast
+	Result.Bombs.StableSort([](const FChainBomb& A, const FChainBomb& B) { return A.Delay < B.Delay; });
+
+	for (int32 Head = 0; Head < Result.Bombs.Num(); Head++)
+	{
+		ABomb* Bomb				= Result.Bombs[Head].Bomb.Get();
+		const FGridCoord Origin = Result.Bombs[Head].Cell;
+		const float Delay		= Result.Bombs[Head].Delay;
+		const int32 FirstCell	= Result.Cells.Num();
+
+		const AExplosion* ExplosionCDO = Bomb && Bomb->GetExplosionClass() ? Bomb->GetExplosionClass()->GetDefaultObject<AExplosion>() : nullptr;
+		const float ChainDelay		   = ExplosionCDO ? ExplosionCDO->GetChainExplosionDelay() : 0.0f;
+
+		GridData.ForEachBlastCell(Origin, Bomb ? Bomb->GetBombPower() : 0, [&](FGridCoord Cell, int32 Distance, bool bIsEnd, EGridCellFlags Flags)
+		{
+			if (!GridData.Contains(Cell)) return;
+
+			// A chained bomb's own cell was burned by its parent's arm, it still shows its own center
+			// piece when it goes off, which takes the cell over from the parent's explosion
+			const int32 Index = GridData.ToIndex(Cell);
+			if (Distance == 0)
+			{
+				BurnedCells[Index] = true;
+				Result.Cells.Add({Cell, EExplosionType::Center, Flags});
+			}
+			else if (!BurnedCells[Index])
+			{
+				BurnedCells[Index] = true;
+				Result.Cells.Add({Cell, bIsEnd ? EExplosionType::End : EExplosionType::Middle, Flags});
+
+				if (EnumHasAnyFlags(Flags, EGridCellFlags::Block))
+				{
+					Result.Blocks.Add(Grid.GetBlockAt(Cell));
+				}
+			}
+
+			// Chain into the bomb sitting on this cell
+			if (Distance > 0 && EnumHasAnyFlags(Flags, EGridCellFlags::Bomb))
+			{
+				// Bombs already in the chain are exploding and skipped
+				ABomb* ChainedBomb = Grid.GetBombAt(Cell);
+				if (ChainedBomb && !ChainedBomb->IsExploding())
+				{
+					ChainedBomb->BeginDetonation();
+
+					FChainBomb& ChainBomb = Result.Bombs.AddDefaulted_GetRef();
+					ChainBomb.Bomb		  = ChainedBomb;
+					ChainBomb.Cell		  = Cell;
+					ChainBomb.Delay		  = Delay + ChainDelay;
+				}
+			}
+		});
+
+		Result.Bombs[Head].FirstCell = FirstCell;
+		Result.Bombs[Head].NumCells	 = Result.Cells.Num() - FirstCell;
+	}
+
+	UE_LOG(LogBomberman, Verbose, TEXT("Chain resolved: %d bombs, %d cells, %d blocks"), Result.Bombs.Num(), Result.Cells.Num(), Result.Blocks.Num());
+
+	OnChainReactionResolved.Broadcast(Result);
+
+	// Schedule the detonations, each bomb burns its cells when its delay has passed
+	for (const FChainBomb& ChainBomb : Result.Bombs)
+	{
+		const int64 DetonateTick = CurrentTick + BombermanClock::SecondsToTicks(ChainBomb.Delay);
+		Pending.Add({ChainBomb.Bomb, DetonateTick, PendingCells.Num(), ChainBomb.NumCells});
+		PendingCells.Append(Result.Cells.GetData() + ChainBomb.FirstCell, ChainBomb.NumCells);
+
+		// The danger map holds the exact tick from now on
+		if (const ABomb* Bomb = ChainBomb.Bomb.Get())
+		{
+			Grid.SetBombFuseTick(Bomb, DetonateTick);
+		}
+	}
+}
+
+void UChainReactionSubsystem::DetonatePending(int64 Tick)
+{
+	BOMBERMAN_SCOPE(ChainDetonate);
+
+	const int32 NumPending = Pending.Num();
+	for (int32 Index = 0; Index < Pending.Num(); Index++)
+	{
+		if (Pending[Index].DetonateTick > Tick) continue;
+
+		const FPendingDetonation Detonation = Pending[Index];
+		Pending.RemoveAt(Index--, 1, EAllowShrinking::No);
+
+		if (ABomb* Bomb = Detonation.Bomb.Get())
+		{
+			Bomb->Detonate(MakeArrayView(PendingCells.GetData() + Detonation.FirstCell, Detonation.NumCells));
+		}
+	}
+
+	if (Pending.Num() != NumPending)
+	{
+		CompactPendingCells();
+	}
+}
+
+void UChainReactionSubsystem::CompactPendingCells()
+{
+	// Some detonation is nearly always waiting, so shift the live ranges down instead of waiting for
+	// an empty queue. Pending keeps the order it was added in, every range moves to a lower index.
+	int32 NumCells = 0;
+	for (FPendingDetonation& Detonation : Pending)
+	{
+		if (Detonation.FirstCell != NumCells)
+		{
+			FMemory::Memmove(PendingCells.GetData() + NumCells, PendingCells.GetData() + Detonation.FirstCell, Detonation.NumCells * sizeof(FBlastCell));
+			Detonation.FirstCell = NumCells;
+		}
+		NumCells += Detonation.NumCells;
+	}
+	PendingCells.SetNum(NumCells, EAllowShrinking::No);
+}
+
+void UChainReactionSubsystem::ExpireExplosions(int64 Tick)
+{
+	for (int32 Index = LiveExplosions.Num() - 1; Index >= 0; Index--)
+	{
+		AExplosion* Explosion = LiveExplosions[Index].Get();
+		if (Explosion && Explosion->ExpireTick > Tick) continue;
+
+		LiveExplosions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		if (Explosion)
+		{
+			// Already out of the list, skip the lookup in UntrackExplosion
+			Explosion->bLifeTracked = false;
+			Explosion->DestroyExplosion();
+		}
+	}
+}
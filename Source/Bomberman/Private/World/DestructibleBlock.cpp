@@ -1,12 +1,33 @@
 #include "World/DestructibleBlock.h"
 
 #include "World/Powerup.h"
+#include "World/BombermanGridSubsystem.h"
 
 
 ADestructibleBlock::ADestructibleBlock()
 {
 }
 
+void ADestructibleBlock::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>())
+	{
+		Grid->RegisterBlock(this);
+	}
+}
+
+void ADestructibleBlock::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>())
+	{
+		Grid->UnregisterBlock(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ADestructibleBlock::DestroyBlock()
 {
 }
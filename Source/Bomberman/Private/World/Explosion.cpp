@@ -10,20 +10,26 @@
 #include "World/Bomb.h"
 #include "World/Powerup.h"
 #include "World/DestructibleBlock.h"
+#include "World/BombermanGridSubsystem.h"
+#include "World/ChainReactionSubsystem.h"
+#include "World/InstancedMeshRenderSubsystem.h"
+#include "Core/ActorPoolSubsystem.h"
+#include "Core/BombermanClock.h"
+#include "Core/BombermanLog.h"
+#include "Core/BombermanStats.h"
 
 AExplosion::AExplosion()
 {
 	PrimaryActorTick.bCanEverTick = false;
 
-	// Damage Collision
+	// Clients rebuild explosions from the replicated grid events
+	bReplicates = false;
+
+	// Cell bounds only, damage is resolved on the grid instead of by overlaps
 	DamageCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("DamageCollision"));
 	RootComponent	= DamageCollision;
 	DamageCollision->SetBoxExtent(FVector(45.0f, 45.0f, 45.0f));
-	DamageCollision->SetCollisionObjectType(ECC_WorldDynamic);
-	DamageCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	DamageCollision->SetCollisionResponseToAllChannels(ECR_Ignore);
-	DamageCollision->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
-	DamageCollision->SetCollisionResponseToChannel(ECC_WorldDynamic, ECR_Overlap);
+	DamageCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
 	// Explosive mesh
 	ExplosionMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ExplosionMesh"));
@@ -35,123 +41,174 @@ void AExplosion::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Survival timer
-	GetWorldTimerManager().SetTimer(LifeTimerHandle, this, &ThisClass::DestroyExplosion, LifeTime, false);
+	// Pre-warmed instances wait in the pool
+	if (bInPool) return;
 
-	UE_LOG(LogTemp, Log, TEXT("Explosion created at: %s"), *GetActorLocation().ToString());
+	StartLifeTimer();
 }
 
-void AExplosion::InitializeExplosion(EExplosionType Type, ABombermanCharacter* InOwner, ABomb* Source)
+void AExplosion::StartLifeTimer()
 {
-	ExplosionType  = Type;
-	ExplosionOwner = InOwner;
-	SourceBomb	   = Source;
-
-	// Adjust mesh and size according to type
-	switch (Type)
+	if (!bCountedLive)
 	{
-		case EExplosionType::Center:
-			DamageCollision->SetBoxExtent(FVector(45.0f, 45.0f, 45.0f));
-			break;
-		case EExplosionType::Middle:
-			DamageCollision->SetBoxExtent(FVector(45.0f, 45.0f, 45.0f));
-			break;
-		case EExplosionType::End:
-			DamageCollision->SetBoxExtent(FVector(45.0f, 45.0f, 45.0f));
-			break;
+		bCountedLive = true;
+		BombermanStats::LiveExplosionCells++;
 	}
 
-	OnExplosionCreated(Type);
+	// Timers cost a heap allocation per explosion, the chain subsystem expires them in a flat array instead
+	UChainReactionSubsystem* Chain = GetWorld()->GetSubsystem<UChainReactionSubsystem>();
+	ExpireTick = (Chain ? Chain->GetCurrentTick() : 0) + BombermanClock::SecondsToTicks(LifeTime);
+	if (Chain && !bLifeTracked)
+	{
+		bLifeTracked = true;
+		Chain->TrackExplosion(this);
+	}
 
-	UE_LOG(LogTemp, Log, TEXT("Explosion initialized: Type=%d, Owner=%s"), (int32)Type, Owner ? *Owner->GetName() : TEXT("None"));
+	BOMBERMAN_LOG_SAMPLED(32, Verbose, TEXT("Explosion created at: %s"), *GetActorLocation().ToString());
 }
 
-void AExplosion::NotifyActorBeginOverlap(AActor* OtherActor)
+void AExplosion::OnAcquiredFromPool()
 {
-	Super::NotifyActorBeginOverlap(OtherActor);
+	bInPool = false;
 
-	if (!OtherActor)
-		return;
+	SetActorHiddenInGame(false);
+	StartLifeTimer();
 
-	// Prevent duplicate damage
-	if (DamagedActors.Contains(OtherActor))
-		return;
+	// Starts burning its cell in InitializeExplosion, once owner and source are known
+}
+
+void AExplosion::OnReturnedToPool()
+{
+	bInPool = true;
+
+	StopLifeTracking();
+	UncountLive();
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	UnregisterFromGrid();
+	RemoveRenderInstance();
 
-	DamagedActors.Add(OtherActor);
-	DealDamageToActor(OtherActor);
+	ExplosionOwner = nullptr;
+	SourceBomb	   = nullptr;
 }
 
-void AExplosion::DealDamageToActor(AActor* Actor)
+void AExplosion::InitializeExplosion(EExplosionType Type, ABombermanCharacter* InOwner, ABomb* Source)
 {
-	if (!Actor)
-		return;
+	ExplosionType  = Type;
+	ExplosionOwner = InOwner;
+	SourceBomb	   = Source;
 
-	// Handling of player characters
-	if (ABombermanCharacter* Player = Cast<ABombermanCharacter>(Actor))
+	// Burn the cell, players on it are damaged by the grid's per-tick pass
+	if (!bRegisteredOnGrid)
 	{
-		// Don't die in your own explosion (optional)
-		if (Player != ExplosionOwner)
+		if (UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>())
 		{
-			Player->TakeBombDamage(DamageAmount, this);
-			OnPlayerHit(Player);
-			UE_LOG(LogTemp, Warning, TEXT("Player %s hit by explosion"), *Player->GetName());
+			GridCell		  = Grid->WorldToCell(GetActorLocation());
+			bRegisteredOnGrid = true;
+			Grid->RegisterExplosion(this, GridCell);
 		}
-		return;
 	}
 
-	// Destructible block handling
-	if (ADestructibleBlock* Block = Cast<ADestructibleBlock>(Actor))
 	{
-		// Block->DestroyBlock();
-		OnBlockDestroyed(Block);
-		UE_LOG(LogTemp, Log, TEXT("Block destroyed by explosion"));
-		return;
+		BOMBERMAN_SCOPE(ExplosionEvents);
+		OnExplosionCreated(Type);
 	}
 
-	// Dealing with other bombs
-	if (ABomb* Bomb = Cast<ABomb>(Actor))
+	// Drawn by the shared instanced mesh after the Blueprint styled the cell for its type,
+	// so the mesh, materials and transform it set carry over to the instance
+	if (!RenderHandle.IsValid() && UInstancedMeshRenderSubsystem::IsEnabled())
 	{
-		if (Bomb != SourceBomb) // You've generated bombs excluded
+		if (UInstancedMeshRenderSubsystem* Render = GetWorld()->GetSubsystem<UInstancedMeshRenderSubsystem>())
 		{
-			// Delayed and induced
-			FTimerHandle ChainTimerHandle;
-			GetWorldTimerManager().SetTimer(
-				ChainTimerHandle,
-				[this, Bomb]() { TriggerChainExplosion(Bomb); },
-				ChainExplosionDelay,
-				false);
+			float CustomData[BombermanInstanceData::NumFloats] = {};
+			CustomData[BombermanInstanceData::ExplosionType]	  = float(Type);
+			CustomData[BombermanInstanceData::ExplosionStartTime] = GetWorld()->GetTimeSeconds();
+			CustomData[BombermanInstanceData::ExplosionLifeTime]  = LifeTime;
+
+			RenderHandle = Render->AddInstance(ExplosionMesh, CustomData);
 		}
-		return;
 	}
 
-	// Power-up processing
-	if (APowerup* Powerup = Cast<APowerup>(Actor))
+	BOMBERMAN_LOG_SAMPLED(32, Verbose, TEXT("Explosion initialized: Type=%d, Owner=%s"), (int32)Type, ExplosionOwner ? *ExplosionOwner->GetName() : TEXT("None"));
+}
+
+void AExplosion::DamagePlayer(ABombermanCharacter* Player)
+{
+	// Don't die in your own explosion, nothing to report while the player cannot be hurt
+	if (!Player || Player == ExplosionOwner || Player->IsDead() || Player->IsInvincible()) return;
+
+	Player->TakeBombDamage(DamageAmount, this);
+	OnPlayerHit(Player);
+	UE_LOG(LogBomberman, Log, TEXT("Player %s hit by explosion"), *Player->GetName());
+}
+
+float AExplosion::GetRemainingLifeTime() const
+{
+	const UChainReactionSubsystem* Chain = GetWorld()->GetSubsystem<UChainReactionSubsystem>();
+	if (!bLifeTracked || !Chain) return 0.0f;
+
+	return BombermanClock::TicksToSeconds(FMath::Max<int64>(0, ExpireTick - Chain->GetCurrentTick()));
+}
+
+void AExplosion::DestroyExplosion()
+{
+	StopLifeTracking();
+	UncountLive();
+
+	if (UActorPoolSubsystem* Pool = GetWorld()->GetSubsystem<UActorPoolSubsystem>())
 	{
-		// Powerup->Destroy();
-		UE_LOG(LogTemp, Log, TEXT("Powerup destroyed by explosion"));
+		Pool->Release(this);
 		return;
 	}
+	Destroy();
 }
 
-void AExplosion::TriggerChainExplosion(ABomb* NearbyBomb)
+void AExplosion::StopLifeTracking()
 {
-	if (!NearbyBomb)
-		return;
+	if (!bLifeTracked) return;
 
-	OnBombChainExploded(NearbyBomb);
-	NearbyBomb->ForceExplode();
+	bLifeTracked = false;
+	if (UChainReactionSubsystem* Chain = GetWorld() ? GetWorld()->GetSubsystem<UChainReactionSubsystem>() : nullptr)
+	{
+		Chain->UntrackExplosion(this);
+	}
+}
 
-	UE_LOG(LogTemp, Log, TEXT("Chain explosion triggered on bomb at: %s"), *NearbyBomb->GetActorLocation().ToString());
+void AExplosion::UncountLive()
+{
+	if (!bCountedLive) return;
+
+	bCountedLive = false;
+	BombermanStats::LiveExplosionCells--;
 }
 
-void AExplosion::DestroyExplosion()
+void AExplosion::UnregisterFromGrid()
 {
-	GetWorldTimerManager().ClearTimer(LifeTimerHandle);
-	Destroy();
+	if (!bRegisteredOnGrid) return;
+
+	bRegisteredOnGrid = false;
+	if (UBombermanGridSubsystem* Grid = GetWorld() ? GetWorld()->GetSubsystem<UBombermanGridSubsystem>() : nullptr)
+	{
+		Grid->UnregisterExplosion(this, GridCell);
+	}
+}
+
+void AExplosion::RemoveRenderInstance()
+{
+	if (!RenderHandle.IsValid()) return;
+
+	if (UInstancedMeshRenderSubsystem* Render = GetWorld() ? GetWorld()->GetSubsystem<UInstancedMeshRenderSubsystem>() : nullptr)
+	{
+		Render->RemoveInstance(RenderHandle, ExplosionMesh);
+	}
+	RenderHandle.Reset();
 }
 
 void AExplosion::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	GetWorldTimerManager().ClearTimer(LifeTimerHandle);
+	StopLifeTracking();
+	UncountLive();
+	UnregisterFromGrid();
+	RemoveRenderInstance();
 	Super::EndPlay(EndPlayReason);
 }
\ No newline at end of file
@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "World/InstancedMeshRenderSubsystem.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#include "Core/BombermanLog.h"
+#include "Core/BombermanStats.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(InstancedMeshRenderSubsystem)
+
+static TAutoConsoleVariable<bool> CVarInstancedRendering(
+	TEXT("bomberman.InstancedRendering"),
+	false,
+	TEXT("Render bombs and explosion cells through shared instanced static meshes.\n")
+	TEXT("Applies to bombs and explosions activated after the change."),
+	ECVF_Default);
+
+bool UInstancedMeshRenderSubsystem::IsEnabled()
+{
+	return CVarInstancedRendering.GetValueOnGameThread();
+}
+
+void UInstancedMeshRenderSubsystem::Deinitialize()
+{
+	// The render actor is owned by the level and goes away with the world
+	RenderActor = nullptr;
+	Batches.Empty();
+	BatchByKey.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UInstancedMeshRenderSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInstancedMeshRenderSubsystem, STATGROUP_Bomberman);
+}
+
+void UInstancedMeshRenderSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// One render state update per batch and frame, however many instances changed
+	for (FInstancedMeshBatch& Batch : Batches)
+	{
+		if (Batch.bDirty && Batch.Component)
+		{
+			Batch.Component->MarkRenderStateDirty();
+			Batch.bDirty = false;
+		}
+	}
+}
+
+int32 UInstancedMeshRenderSubsystem::FindOrAddBatch(const UStaticMeshComponent* Source)
+{
+	UStaticMesh* Mesh = Source->GetStaticMesh();
+
+	// Per-actor dynamic materials would open a batch per actor, those actors draw themselves
+	ScratchKey.Mesh = Mesh;
+	ScratchKey.Materials.Reset();
+	for (int32 Index = 0; Index < Source->GetNumMaterials(); Index++)
+	{
+		UMaterialInterface* Material = Source->GetMaterial(Index);
+		if (Material && Material->IsA<UMaterialInstanceDynamic>()) return INDEX_NONE;
+
+		ScratchKey.Materials.Add(Material);
+	}
+
+	if (const int32* Found = BatchByKey.Find(ScratchKey))
+	{
+		return *Found;
+	}
+
+	if (!RenderActor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		RenderActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!RenderActor) return INDEX_NONE;
+
+		USceneComponent* Root = NewObject<USceneComponent>(RenderActor, TEXT("Root"));
+		RenderActor->SetRootComponent(Root);
+		Root->RegisterComponent();
+	}
+
+	UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(RenderActor);
+	Component->SetStaticMesh(Mesh);
+	Component->SetMobility(EComponentMobility::Movable);
+	Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Component->SetCastShadow(Source->CastShadow);
+	Component->SetNumCustomDataFloats(BombermanInstanceData::NumFloats);
+	for (int32 Index = 0; Index < Source->GetNumMaterials(); Index++)
+	{
+		Component->SetMaterial(Index, Source->GetMaterial(Index));
+	}
+	Component->SetupAttachment(RenderActor->GetRootComponent());
+	Component->RegisterComponent();
+	RenderActor->AddInstanceComponent(Component);
+
+	const int32 BatchIndex = Batches.AddDefaulted();
+	Batches[BatchIndex].Component = Component;
+	BatchByKey.Add(ScratchKey, BatchIndex);
+
+	UE_LOG(LogBomberman, Log, TEXT("Instanced batch created for mesh: %s (%d materials)"), *GetNameSafe(Mesh), ScratchKey.Materials.Num());
+
+	return BatchIndex;
+}
+
+FInstancedMeshHandle UInstancedMeshRenderSubsystem::AddInstance(UStaticMeshComponent* Source, TConstArrayView<float> CustomData)
+{
+	FInstancedMeshHandle Handle;
+	if (!Source || !Source->GetStaticMesh()) return Handle;
+
+	const int32 BatchIndex = FindOrAddBatch(Source);
+	if (BatchIndex == INDEX_NONE) return Handle;
+
+	FInstancedMeshBatch& Batch	= Batches[BatchIndex];
+	const FTransform& Transform = Source->GetComponentTransform();
+
+	Handle.Batch = BatchIndex;
+	if (Batch.FreeInstances.Num() > 0)
+	{
+		Handle.Instance = Batch.FreeInstances.Pop(EAllowShrinking::No);
+		Batch.Component->UpdateInstanceTransform(Handle.Instance, Transform, true, false, true);
+	}
+	else
+	{
+		Handle.Instance = Batch.Component->AddInstance(Transform, true);
+	}
+	Batch.Component->SetCustomData(Handle.Instance, CustomData, false);
+	Batch.bDirty = true;
+
+	Source->SetVisibility(false);
+
+	return Handle;
+}
+
+void UInstancedMeshRenderSubsystem::RemoveInstance(FInstancedMeshHandle& Handle, UStaticMeshComponent* Source)
+{
+	if (Source)
+	{
+		Source->SetVisibility(true);
+	}
+
+	if (!Handle.IsValid() || !Batches.IsValidIndex(Handle.Batch))
+	{
+		Handle.Reset();
+		return;
+	}
+
+	// Collapse the instance instead of removing it, removal would shift the other indices
+	FInstancedMeshBatch& Batch = Batches[Handle.Batch];
+	if (Batch.Component)
+	{
+		Batch.Component->UpdateInstanceTransform(Handle.Instance, FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), true, false, true);
+		Batch.FreeInstances.Add(Handle.Instance);
+		Batch.bDirty = true;
+	}
+	Handle.Reset();
+}
+
+void UInstancedMeshRenderSubsystem::UpdateTransform(const FInstancedMeshHandle& Handle, const FTransform& WorldTransform)
+{
+	if (!Handle.IsValid() || !Batches.IsValidIndex(Handle.Batch)) return;
+
+	FInstancedMeshBatch& Batch = Batches[Handle.Batch];
+	if (Batch.Component)
+	{
+		Batch.Component->UpdateInstanceTransform(Handle.Instance, WorldTransform, true, false, false);
+		Batch.bDirty = true;
+	}
+}
+
+void UInstancedMeshRenderSubsystem::SetCustomData(const FInstancedMeshHandle& Handle, TConstArrayView<float> CustomData)
+{
+	if (!Handle.IsValid() || !Batches.IsValidIndex(Handle.Batch)) return;
+
+	FInstancedMeshBatch& Batch = Batches[Handle.Batch];
+	if (Batch.Component)
+	{
+		Batch.Component->SetCustomData(Handle.Instance, CustomData, false);
+		Batch.bDirty = true;
+	}
+}
@@ -2,6 +2,24 @@
 
 
 #include "World/Powerup.h"
+#include "World/BombermanGridSubsystem.h"
 
+void APowerup::BeginPlay()
+{
+	Super::BeginPlay();
 
+	if (UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>())
+	{
+		Grid->RegisterPowerup(this);
+	}
+}
 
+void APowerup::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UBombermanGridSubsystem* Grid = GetWorld()->GetSubsystem<UBombermanGridSubsystem>())
+	{
+		Grid->UnregisterPowerup(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Core/BombermanDangerMap.h"
+#include "Core/BombermanGrid.h"
+#include "Sim/BombermanSimMcts.h"
+
+struct FGridFlowField;
+
+// Read-only copy of the arena the bots plan on, taken on the game thread and shared by every planning task
+struct BOMBERMAN_API FBotSnapshot
+{
+	FBombermanGrid Grid;
+
+	// Earliest burn tick per cell, indexed like the grid (see UBombermanGridSubsystem::GetBurnTick)
+	TArray<int64> BurnTicks;
+
+	// Gameplay tick the snapshot was taken on
+	int64 Now = 0;
+
+	// Living players, with the flow field towards each one built up front
+	TArray<FGridCoord> PlayerCells;
+	TArray<const FGridFlowField*> PlayerFields;
+	const FGridFlowField* BlocksField = nullptr;
+
+	// Headless copy of the match for the bots that search ahead, captured only when one of them asks
+	FSimState SimState;
+	bool bHasSimState = false;
+
+	uint32 LayoutVersion = 0;
+	uint64 Frame		 = 0;
+
+	int64 GetBurnTick(FGridCoord Cell) const
+	{
+		return Grid.Contains(Cell) && BurnTicks.Num() == Grid.Num() ? BurnTicks[Grid.ToIndex(Cell)] : FBombermanDangerMap::Never;
+	}
+};
+
+// Tuning of one bot, in gameplay ticks and cells
+struct FBotSettings
+{
+	// Ticks a cell on the way has to stay clear after the bot left it
+	int32 SafetyMarginTicks = 6;
+
+	// Ticks the bot gives itself to get clear of its own bomb
+	int32 EscapeBudgetTicks = 120;
+
+	// How far down a line a kicked bomb is worth sending at a player
+	int32 KickSightCells = 6;
+};
+
+// What a bot knows about its own pawn when it asks for a decision
+struct FBotView
+{
+	FGridCoord Cell;
+	int32 TicksPerCell = 1;
+	int32 BombPower	   = 1;
+	bool bCanPlaceBomb = false;
+	bool bCanKick	   = false;
+
+	// Direction (index into GridDirections) the pawn faces, INDEX_NONE between directions
+	int32 FacingDir = INDEX_NONE;
+
+	// The bot's own entry in FBotSnapshot::PlayerCells
+	int32 PlayerIndex = INDEX_NONE;
+
+	// The bot's player in FBotSnapshot::SimState (its UBombermanGridSubsystem player slot)
+	int32 Seat = INDEX_NONE;
+
+	// Tree search time per decision, 0 decides on the flow fields alone
+	double SearchSeconds = 0.0;
+
+	FBotSettings Settings;
+};
+
+enum class EBotAction : uint8
+{
+	None,
+	PlaceBomb,
+	Kick,
+};
+
+struct FBotDecision
+{
+	EBotAction Action = EBotAction::None;
+
+	// Cell to walk to, the bot's own cell to stay put
+	FGridCoord MoveTarget;
+
+	// Decide again as soon as MoveTarget is reached instead of waiting for the think interval
+	bool bThinkOnArrival = false;
+};
+
+// Search buffers of one bot, indexed like the grid and kept between decisions
+struct FBotScratch
+{
+	TArray<int32> Queue;
+	TArray<int64> ArrivalTicks;
+	TArray<int8> FirstSteps;
+	TBitArray<> OwnBlast;
+
+	// Created on the first search, keeps its trees between decisions
+	TUniquePtr<FBombermanSimMcts> Planner;
+};
+
+namespace BombermanBotBrain
+{
+	// Flees cells about to burn, bombs blocks and players when there is a way out, kicks bombs at
+	// players and otherwise follows the flow fields. Bots with a search budget run FBombermanSimMcts
+	// on the snapshot's sim state instead. Only reads the snapshot (called from worker threads).
+	BOMBERMAN_API void Decide(const FBotSnapshot& Snapshot, const FBotView& View, FBotScratch& Scratch, FBotDecision& OutDecision);
+}
@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+
+#include "Core/GridCoord.h"
+#include "BombermanBotController.generated.h"
+
+class ABombermanCharacter;
+struct FBotDecision;
+struct FBotView;
+
+/**
+ * Bot that plans on the tile grid instead of the navmesh: it leaves cells the danger map says
+ * will burn, bombs blocks and players when there is a way out, kicks bombs down lines with
+ * players in them and otherwise follows the shared flow fields of UBombermanFlowFieldSubsystem.
+ * It drives ABombermanCharacter through the same input paths a player's bindings use.
+ * Decisions are planned by UBombermanBotSchedulerSubsystem within its frame budget; the
+ * controller only asks for them and steers towards the cell it was given.
+ */
+UCLASS(Config = Game)
+class BOMBERMAN_API ABombermanBotController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+	ABombermanBotController();
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	// Queues one decision, normally every ThinkInterval and whenever the next cell is reached
+	void RequestDecision();
+
+	// The pawn as the planner sees it, false without a living pawn
+	bool GetBotView(FBotView& OutView) const;
+
+	// Runs the decision's bomb and kick inputs and heads for its cell
+	void ApplyDecision(const FBotDecision& Decision);
+
+	// Spawns Count bots with the game mode's default pawn at its player starts (server only)
+	static void SpawnBots(UWorld* World, int32 Count);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnPossess(APawn* InPawn) override;
+	virtual void OnUnPossess() override;
+
+	// Seconds between decisions, movement is steered every frame in between
+	UPROPERTY(EditAnywhere, Config, Category = "Bomberman|Bot")
+	float ThinkInterval = 0.2f;
+
+	// Ticks a cell on the way has to stay clear after the bot left it
+	UPROPERTY(EditAnywhere, Config, Category = "Bomberman|Bot")
+	int32 SafetyMarginTicks = 6;
+
+	// Seconds the bot gives itself to get clear of its own bomb
+	UPROPERTY(EditAnywhere, Config, Category = "Bomberman|Bot")
+	float EscapeBudgetSeconds = 2.0f;
+
+	// How far down a line a kicked bomb is worth sending at a player, in cells
+	UPROPERTY(EditAnywhere, Config, Category = "Bomberman|Bot")
+	int32 KickSightCells = 6;
+
+	// Milliseconds of tree search over the headless rules per decision, 0 decides on the flow fields alone
+	UPROPERTY(EditAnywhere, Config, Category = "Bomberman|Bot")
+	float LookaheadBudgetMs = 0.0f;
+
+	// A cell center counts as reached this close, in cells
+	UPROPERTY(EditAnywhere, Config, Category = "Bomberman|Bot")
+	float ArriveTolerance = 0.15f;
+
+private:
+	friend class UBombermanBotSchedulerSubsystem;
+
+	// Index in UBombermanBotSchedulerSubsystem, INDEX_NONE when not registered
+	int32 SchedulerSlot = INDEX_NONE;
+
+	FGridCoord MoveTarget;
+	bool bHasMoveTarget	 = false;
+	bool bThinkOnArrival = false;
+	float ThinkCountdown = 0.0f;
+
+	ABombermanCharacter* GetBot() const;
+	void Steer();
+};
@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "AI/BombermanBotBrain.h"
+#include "BombermanBotSchedulerSubsystem.generated.h"
+
+class ABombermanBotController;
+class ABombermanCharacter;
+
+/**
+ * Hands out bot decisions under a per-frame time budget (bomberman.Bot.BudgetMs).
+ * Bots queue a request instead of thinking in their own Tick. Each frame the queue is drained in
+ * batches: the game thread snapshots the grid, burn ticks and flow fields once, the pure planning
+ * (BombermanBotBrain::Decide) runs as parallel tasks over that snapshot, and the decisions are
+ * applied to the pawns back on the game thread. Whatever the budget leaves over waits for the next frame.
+ * Bots that search ahead spend their own search time inside the batch, size the budget for it.
+ */
+UCLASS()
+class BOMBERMAN_API UBombermanBotSchedulerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void Register(ABombermanBotController* Bot);
+	void Unregister(ABombermanBotController* Bot);
+
+	// Queues a decision for the bot, a no-op while one is already queued
+	void RequestDecision(ABombermanBotController* Bot);
+
+	int32 NumQueued() const { return Queue.Num(); }
+
+private:
+	// Per bot, indexed by ABombermanBotController::SchedulerSlot
+	struct FBotEntry
+	{
+		ABombermanBotController* Bot = nullptr;
+		FBotView View;
+		FBotDecision Decision;
+		FBotScratch Scratch;
+		double RequestTime = 0.0;
+		bool bQueued	   = false;
+	};
+
+	TArray<FBotEntry> Entries;
+
+	// Slots waiting for a decision, oldest request first
+	TArray<int32> Queue;
+
+	// Slots planned together in one parallel pass
+	TArray<int32> Batch;
+
+	FBotSnapshot Snapshot;
+
+	// Pawns of FBotSnapshot::PlayerCells, to find a bot's own entry
+	TArray<const ABombermanCharacter*> SnapshotPlayers;
+
+	// Retakes the snapshot when the frame or the grid's layout moved on since the last one
+	bool UpdateSnapshot();
+};
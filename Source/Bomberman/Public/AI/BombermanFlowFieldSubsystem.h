@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "Core/BombermanGrid.h"
+#include "BombermanFlowFieldSubsystem.generated.h"
+
+// Steps from every cell of the arena to the nearest goal cell, through cells a player can walk
+struct BOMBERMAN_API FGridFlowField
+{
+	static constexpr uint16 Unreachable = MAX_uint16;
+
+	// Indexed like the grid
+	TArray<uint16> Distances;
+
+	uint32 LayoutVersion = 0;
+	uint64 LastUsedFrame = 0;
+
+	uint16 GetDistance(const FBombermanGrid& Grid, FGridCoord Cell) const
+	{
+		return Grid.Contains(Cell) && Distances.Num() == Grid.Num() ? Distances[Grid.ToIndex(Cell)] : Unreachable;
+	}
+
+	// Directions (indices into GridDirections) leading one step closer, as a 4 bit mask
+	uint8 GetDownhillMask(const FBombermanGrid& Grid, FGridCoord Cell) const;
+};
+
+/**
+ * Flow fields on the occupancy grid, shared by every bot heading for the same goal.
+ * A field is one breadth-first pass over the arena, cached per goal and rebuilt only once the
+ * grid's layout (walls, blocks, bombs) has changed since it was built, never per bot or per frame.
+ * Returned fields stay put until the end of the frame, so a frame's requests can be read together
+ * (e.g. by bot planning tasks); a field handed out this frame is never evicted.
+ */
+UCLASS(Config = Game)
+class BOMBERMAN_API UBombermanFlowFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Towards a single cell (a player, a powerup)
+	const FGridFlowField* GetFieldToCell(FGridCoord Goal);
+
+	// Towards the nearest walkable cell next to a destructible block
+	const FGridFlowField* GetFieldToBlocks();
+
+	int32 NumCachedFields() const { return Fields.Num(); }
+
+protected:
+	// Least recently used fields are dropped past this many
+	UPROPERTY(Config)
+	int32 MaxCachedFields = 64;
+
+private:
+	// Cell index of the goal, or one of the shared keys below
+	static constexpr int32 BlocksKey = -1;
+
+	// Boxed so handing out new fields never moves the ones already handed out
+	TMap<int32, TUniquePtr<FGridFlowField>> Fields;
+
+	// Breadth-first scratch
+	TArray<int32> Queue;
+
+	FGridFlowField* FindOrBuild(int32 Key);
+	void Build(const FBombermanGrid& Grid, int32 Key, FGridFlowField& Field);
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Counts heap allocations per thread by putting a forwarding proxy in front of GMalloc.
+ * Only meant for benchmarks: install before the measured section, uninstall afterwards.
+ */
+class BOMBERMAN_API FBombermanAllocCounter
+{
+public:
+	static void Install();
+	static void Uninstall();
+	static bool IsInstalled();
+
+	// Malloc and growing Realloc calls made on the calling thread since it started
+	static uint64 GetThreadAllocations();
+};
+
+// Allocations made on this thread inside the scope
+class FBombermanAllocScope
+{
+public:
+	FBombermanAllocScope()
+		: Start(FBombermanAllocCounter::GetThreadAllocations())
+	{
+	}
+
+	uint64 Get() const { return FBombermanAllocCounter::GetThreadAllocations() - Start; }
+
+private:
+	uint64 Start;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Bench/BombermanAllocCounter.h"
+#include "Core/GridCoord.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class ABomb;
+class ABombermanCharacter;
+class UActorPoolSubsystem;
+class UBombermanGridSubsystem;
+class UChainReactionSubsystem;
+
+// One measured gameplay operation of a scenario
+struct FBombermanBenchmarkOp
+{
+	FString Scenario;
+	FString Operation;
+	// Per operation, in microseconds
+	TArray<double> Micros;
+	uint64 Allocations = 0;
+	int64 Spawns	   = 0;
+	int64 Calls		   = 0;
+	// Any heap allocation in a measured call fails the run
+	bool bRequireZeroAllocs = false;
+
+	double Percentile(const TArray<double>& Sorted, double Fraction) const
+	{
+		return Sorted.Num() > 0 ? Sorted[FMath::Min(Sorted.Num() - 1, int32(Sorted.Num() * Fraction))] : 0.0;
+	}
+};
+
+/**
+ * Builds one headless game world per scenario (Empty, Dense, ChainGrid) and measures the gameplay
+ * entry points the way players reach them. Shared by UBombermanBenchmarkCommandlet and the
+ * Bomberman.Benchmark automation tests. Allocations are only counted while FBombermanAllocCounter is installed.
+ */
+class BOMBERMAN_API FBombermanBenchmark
+{
+public:
+	static const TCHAR* DefaultCharacterClassPath;
+
+	// BombClass may be null, the character's bomb class is used then
+	FBombermanBenchmark(UClass* InCharacterClass, UClass* InBombClass, int32 InIterations);
+
+	bool Run(const FString& Scenario);
+	FString ToJson() const;
+	void LogSummary() const;
+	bool CheckAllocations() const;
+
+	const TArray<FBombermanBenchmarkOp>& GetResults() const { return Results; }
+
+private:
+	UClass* CharacterClass;
+	UClass* BombClass;
+	int32 Iterations;
+
+	UWorld* World					  = nullptr;
+	ABombermanCharacter* Character	  = nullptr;
+	UBombermanGridSubsystem* Grid	  = nullptr;
+	UChainReactionSubsystem* Chain	  = nullptr;
+	UActorPoolSubsystem* Pool		  = nullptr;
+	int64 SpawnCount				  = 0;
+	FDelegateHandle SpawnHandle;
+
+	TArray<FBombermanBenchmarkOp> Results;
+	FRandomStream Random{1234};
+
+	bool CreateWorld(int32 ArenaSize);
+	void DestroyWorld();
+	void Advance(float Seconds);
+
+	FVector CellToWorld(FGridCoord Cell) const;
+	void SpawnBlock(FGridCoord Cell);
+	ABomb* SpawnBomb(FGridCoord Cell, int32 Power);
+	FGridCoord PickFreeCell(const TArray<FGridCoord>& FreeCells) const;
+	float GetFuseSeconds() const;
+
+	// Index of the new op in Results, ops are looked up by index since adding one can move the others
+	int32 AddOp(const TCHAR* Scenario, const TCHAR* Operation, bool bRequireZeroAllocs = false);
+
+	// Times Body as one sample of Calls operations of Results[OpIndex]
+	template <typename FBody>
+	void Measure(int32 OpIndex, int32 Calls, FBody&& Body)
+	{
+		const int64 SpawnsBefore = SpawnCount;
+		const FBombermanAllocScope Allocs;
+		const uint64 Start = FPlatformTime::Cycles64();
+
+		Body();
+
+		const double Micros			 = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - Start) * 1000.0;
+		FBombermanBenchmarkOp& Stats = Results[OpIndex];
+		Stats.Micros.Add(Micros / Calls);
+		Stats.Allocations += Allocs.Get();
+		Stats.Spawns += SpawnCount - SpawnsBefore;
+		Stats.Calls += Calls;
+	}
+
+	void RunCommon(const TCHAR* Scenario, int32 ArenaSize, const TArray<FGridCoord>& FreeCells);
+	void RunChainGrid();
+};
+
+#endif
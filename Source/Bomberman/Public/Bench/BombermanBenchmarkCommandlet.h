@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BombermanBenchmarkCommandlet.generated.h"
+
+/**
+ * Times the gameplay hot paths (placement, bomb lookup, detonation, chain reactions)
+ * on synthetic arenas in a headless game world and writes latency percentiles,
+ * heap allocations and actor spawns per operation as JSON. Fails when an operation that
+ * must stay allocation-free (lookups, the blast kernel, detonation) allocated after warmup.
+ *
+ * UnrealEditor-Cmd Bomberman.uproject -run=BombermanBenchmark -nullrhi -unattended
+ *   -Scenarios=Empty,Dense,ChainGrid -Iterations=200 -Out=Saved/Benchmarks/Bomberman.json
+ *   -BombClass=/Game/Blueprints/B_Bomb.B_Bomb_C -CharacterClass=/Game/Blueprints/B_BombermanCharacter.B_BombermanCharacter_C
+ */
+UCLASS()
+class BOMBERMAN_API UBombermanBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBombermanBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
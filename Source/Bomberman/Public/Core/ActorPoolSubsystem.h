@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ActorPoolSubsystem.generated.h"
+
+USTRUCT(BlueprintType)
+struct FActorPoolStats
+{
+	GENERATED_BODY()
+
+	// Total acquisitions
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Acquired = 0;
+
+	// Acquisitions served by a pooled instance
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Reused = 0;
+
+	// Acquisitions that had to spawn a new actor
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Misses = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Released = 0;
+
+	// Releases destroyed because the pool was at its high-water mark
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Discarded = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Active = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 PeakActive = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Pool")
+	int32 Pooled = 0;
+};
+
+/**
+ * Recycles actors implementing IPoolableActor, keyed by class.
+ */
+UCLASS(Config = Game)
+class BOMBERMAN_API UActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	template <typename T>
+	T* Acquire(TSubclassOf<T> Class, const FTransform& Transform, AActor* Owner = nullptr)
+	{
+		return Cast<T>(AcquireActor(Class, Transform, Owner));
+	}
+
+	// Returns a pooled instance moved to Transform, or spawns one on a pool miss
+	AActor* AcquireActor(UClass* Class, const FTransform& Transform, AActor* Owner);
+
+	// Deactivates the actor and keeps it for reuse, destroys it when the pool is full
+	void Release(AActor* Actor);
+
+	// Spawns inactive instances until Count are pooled (PrewarmCount when Count < 0)
+	void Prewarm(UClass* Class, int32 Count = INDEX_NONE);
+
+	UFUNCTION(BlueprintPure, Category = "Bomberman|Pool")
+	FActorPoolStats GetPoolStats(TSubclassOf<AActor> Class) const;
+
+protected:
+	// Instances spawned per class by Prewarm
+	UPROPERTY(Config)
+	int32 PrewarmCount = 32;
+
+	// High-water mark of inactive instances kept per class
+	UPROPERTY(Config)
+	int32 MaxPooledPerClass = 256;
+
+private:
+	struct FClassPool
+	{
+		TArray<TWeakObjectPtr<AActor>> Free;
+		FActorPoolStats Stats;
+	};
+
+	TMap<TObjectKey<UClass>, FClassPool> Pools;
+
+	AActor* SpawnPooledActor(UClass* Class, const FTransform& Transform, AActor* Owner, bool bStartInactive);
+};
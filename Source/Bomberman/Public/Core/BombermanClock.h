@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Fixed-step gameplay clock. Fuses, kicks, chain delays and explosion lifetimes count whole
+// ticks so a match plays out the same at any frame rate and on any machine (same rate as FSimRules)
+namespace BombermanClock
+{
+	constexpr int32 TicksPerSecond	 = 60;
+	constexpr double SecondsPerTick	 = 1.0 / TicksPerSecond;
+
+	// A long hitch is dropped past this many steps instead of being simulated in one frame
+	constexpr int32 MaxStepsPerFrame = 8;
+
+	// Kick distances and speeds are fixed point, 1/256 of a world unit
+	constexpr int32 FixedShift		 = 8;
+	constexpr int32 FixedOne		 = 1 << FixedShift;
+
+	// Design values are seconds, rounded once to whole ticks
+	inline int32 SecondsToTicks(float Seconds)
+	{
+		return FMath::Max(0, FMath::RoundToInt32(Seconds * TicksPerSecond));
+	}
+
+	inline float TicksToSeconds(int64 Ticks)
+	{
+		return float(double(Ticks) * SecondsPerTick);
+	}
+
+	// Units per second to fixed point units per tick
+	inline int32 SpeedToFixed(float UnitsPerSecond)
+	{
+		return FMath::RoundToInt32(UnitsPerSecond * FixedOne / TicksPerSecond);
+	}
+
+	// Units per second squared to fixed point units per tick per tick
+	inline int32 AccelerationToFixed(float UnitsPerSecondSquared)
+	{
+		return FMath::RoundToInt32(UnitsPerSecondSquared * FixedOne / (TicksPerSecond * TicksPerSecond));
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Core/BombermanGrid.h"
+
+/**
+ * Earliest gameplay tick at which each cell of the arena will burn, given the bombs on it.
+ * A bomb goes off at its fuse tick, or earlier when a blast reaching it goes off (plus that
+ * blast's chain delay). A cell burns with the earliest bomb whose blast reaches it.
+ * Each change only revisits the bombs chained to the changed cells and the cells those bombs
+ * reach, so reads are one array lookup and the map is never rebuilt during a match.
+ * Changes are reported after the grid flags already reflect them.
+ */
+class BOMBERMAN_API FBombermanDangerMap
+{
+public:
+	static constexpr int64 Never = TNumericLimits<int64>::Max();
+
+	// Drops every bomb and sizes the map for Grid
+	void Reset(const FBombermanGrid& Grid);
+
+	void AddBomb(const FBombermanGrid& Grid, FGridCoord Cell, int32 Range, int64 FuseTick, int32 ChainDelayTicks);
+	void RemoveBomb(const FBombermanGrid& Grid, FGridCoord Cell);
+	void MoveBomb(const FBombermanGrid& Grid, FGridCoord From, FGridCoord To);
+	void SetBombFuseTick(const FBombermanGrid& Grid, FGridCoord Cell, int64 FuseTick);
+	void SetBombRange(const FBombermanGrid& Grid, FGridCoord Cell, int32 Range);
+
+	// Something that stops blasts appeared on Cell or left it (block spawned or destroyed)
+	void CellChanged(const FBombermanGrid& Grid, FGridCoord Cell);
+
+	// Earliest tick a blast reaches the cell, Never when no bomb reaches it
+	int64 GetBurnTick(int32 CellIndex) const { return BurnTicks.IsValidIndex(CellIndex) ? BurnTicks[CellIndex] : Never; }
+
+	// Tick the bomb on Cell goes off at with its chain taken into account, Never without a bomb or fuse
+	int64 GetDetonateTick(const FBombermanGrid& Grid, FGridCoord Cell) const;
+
+	int32 NumBombs() const { return Bombs.Num(); }
+
+private:
+	struct FBomb
+	{
+		FGridCoord Cell;
+		int32 Range			  = 0;
+		int32 ChainDelayTicks = 0;
+		int64 FuseTick		  = Never;
+		int64 DetonateTick	  = Never;
+		// Cells the blast covers in each of the GridDirections
+		uint8 Reach[4]		  = {};
+	};
+
+	TArray<FBomb> Bombs;
+	// Slot in Bombs per cell, indexed like the grid
+	TArray<int32> BombAtCell;
+	TArray<int64> BurnTicks;
+	// Largest range ever added, how far a cell looks for bombs reaching it
+	int32 MaxRange = 0;
+
+	// Per change scratch, kept to reuse its allocations
+	TArray<int32> Seeds;
+	TArray<int32> Component;
+	TBitArray<> InComponent;
+	TArray<int32> DirtyCells;
+	TBitArray<> DirtyCellBits;
+	TArray<TPair<int64, int32>> Frontier;
+
+	int32 FindBomb(const FBombermanGrid& Grid, FGridCoord Cell) const;
+	void ComputeReach(const FBombermanGrid& Grid, FBomb& Bomb) const;
+	void MarkFootprint(const FBombermanGrid& Grid, const FBomb& Bomb);
+	// Bombs whose blast stops on or passes Cell get their reach recomputed
+	void ReblockAround(const FBombermanGrid& Grid, FGridCoord Cell);
+	void Propagate(const FBombermanGrid& Grid);
+
+	// Visitor signature: void(int32 CellIndex, int32 Distance)
+	template <typename FVisitor>
+	void ForEachFootprintCell(const FBombermanGrid& Grid, const FBomb& Bomb, FVisitor&& Visit) const;
+
+	// Every bomb whose blast covers Cell, the one on it included. Visitor signature: void(int32 Slot)
+	template <typename FVisitor>
+	void ForEachCoveringBomb(const FBombermanGrid& Grid, FGridCoord Cell, FVisitor&& Visit) const;
+};
@@ -20,6 +20,9 @@ public:
 	// Called when a player logs in
 	virtual void PostLogin(APlayerController* NewPlayer) override;
 
+	// Prefers starts no pending blast reaches, then the one that burns last
+	virtual AActor* ChoosePlayerStart_Implementation(AController* Player) override;
+
 	UFUNCTION(BlueprintCallable)
 	void StartGame();
 
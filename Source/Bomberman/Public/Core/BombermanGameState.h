@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "BombermanGameState.generated.h"
+
+class UBombermanGridStateComponent;
+
+/**
+ * Carries the replicated arena state: bombs and blasts travel as grid events
+ * on the grid state component instead of one replicated actor per bomb or cell.
+ */
+UCLASS()
+class BOMBERMAN_API ABombermanGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+public:
+	ABombermanGameState();
+
+	UBombermanGridStateComponent* GetGridState() const { return GridState; }
+
+protected:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	TObjectPtr<UBombermanGridStateComponent> GridState;
+};
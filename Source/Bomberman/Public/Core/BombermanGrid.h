@@ -0,0 +1,115 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Core/GridCoord.h"
+
+// What currently occupies a grid cell
+enum class EGridCellFlags : uint8
+{
+	None	= 0,
+	Wall	= 1 << 0, // Indestructible obstacle
+	Block	= 1 << 1, // Destructible block
+	Bomb	= 1 << 2,
+	Powerup = 1 << 3,
+	Player	= 1 << 4,
+	Burning = 1 << 5, // Covered by a live explosion
+
+	// Stops a blast after the cell itself has burned
+	BlastStop = Block | Bomb,
+	// Cannot be entered by a kicked bomb
+	KickStop = Wall | Block | Bomb | Player,
+	// A bomb cannot be placed on it
+	PlaceStop = Wall | Block | Bomb,
+};
+ENUM_CLASS_FLAGS(EGridCellFlags)
+
+// +X, -X, +Y, -Y (same order as the original explosion directions)
+static constexpr FGridCoord GridDirections[4] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+// Index into GridDirections of the axis the vector mostly points along, INDEX_NONE for zero
+inline int32 GridDirectionFromVector(const FVector& Direction)
+{
+	if (FMath::IsNearlyZero(Direction.X) && FMath::IsNearlyZero(Direction.Y)) return INDEX_NONE;
+
+	if (FMath::Abs(Direction.X) >= FMath::Abs(Direction.Y)) return Direction.X > 0.0 ? 0 : 1;
+	return Direction.Y > 0.0 ? 2 : 3;
+}
+
+/**
+ * Dense occupancy grid for the arena.
+ * Cells are addressed in world-cell coordinates (World / CellSize rounded),
+ * MinCell is the world-cell coordinate stored at index 0.
+ */
+struct BOMBERMAN_API FBombermanGrid
+{
+	FGridCoord MinCell;
+	int32 Width	   = 0;
+	int32 Height   = 0;
+	float CellSize = 100.0f;
+
+	TArray<EGridCellFlags> Cells;
+
+	void Init(FGridCoord InMinCell, int32 InWidth, int32 InHeight, float InCellSize)
+	{
+		MinCell	 = InMinCell;
+		Width	 = InWidth;
+		Height	 = InHeight;
+		CellSize = InCellSize;
+		Cells.Init(EGridCellFlags::None, Width * Height);
+	}
+
+	bool IsValid() const { return Width > 0 && Height > 0; }
+	int32 Num() const { return Cells.Num(); }
+
+	bool Contains(FGridCoord Cell) const
+	{
+		return Cell.X >= MinCell.X && Cell.Y >= MinCell.Y && Cell.X < MinCell.X + Width && Cell.Y < MinCell.Y + Height;
+	}
+
+	int32 ToIndex(FGridCoord Cell) const { return (Cell.Y - MinCell.Y) * Width + (Cell.X - MinCell.X); }
+	FGridCoord ToCell(int32 Index) const { return FGridCoord(MinCell.X + Index % Width, MinCell.Y + Index / Width); }
+
+	FGridCoord WorldToCell(const FVector& WorldPosition) const { return FGridCoord::FromWorld(WorldPosition, CellSize); }
+	FVector CellToWorld(FGridCoord Cell, float Z) const { return Cell.ToWorld(CellSize, Z); }
+
+	// Everything outside the arena behaves like a wall
+	EGridCellFlags Get(FGridCoord Cell) const { return Contains(Cell) ? Cells[ToIndex(Cell)] : EGridCellFlags::Wall; }
+
+	bool HasAny(FGridCoord Cell, EGridCellFlags Mask) const { return EnumHasAnyFlags(Get(Cell), Mask); }
+
+	void Add(FGridCoord Cell, EGridCellFlags Flags)
+	{
+		if (Contains(Cell)) Cells[ToIndex(Cell)] |= Flags;
+	}
+
+	void Remove(FGridCoord Cell, EGridCellFlags Flags)
+	{
+		if (Contains(Cell)) Cells[ToIndex(Cell)] &= ~Flags;
+	}
+
+	/**
+	 * Walks the cells a blast of the given range would burn.
+	 * Walls stop the blast, blocks and bombs burn and then stop it.
+	 * Visitor signature: void(FGridCoord Cell, int32 Distance, bool bIsEnd, EGridCellFlags Flags)
+	 */
+	template <typename FVisitor>
+	void ForEachBlastCell(FGridCoord Origin, int32 Range, FVisitor&& Visit) const
+	{
+		Visit(Origin, 0, false, Get(Origin));
+
+		for (int32 Dir = 0; Dir < 4; Dir++)
+		{
+			for (int32 i = 1; i <= Range; i++)
+			{
+				const FGridCoord Cell = Origin + GridDirections[Dir] * i;
+				const EGridCellFlags Flags = Get(Cell);
+				if (EnumHasAnyFlags(Flags, EGridCellFlags::Wall)) break;
+
+				Visit(Cell, i, i == Range, Flags);
+
+				if (EnumHasAnyFlags(Flags, EGridCellFlags::BlastStop)) break;
+			}
+		}
+	}
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Logging/LogMacros.h"
+
+// Per-event gameplay logs are Verbose, compiled out of Test (above Log) and Shipping (above Warning)
+#if UE_BUILD_SHIPPING
+BOMBERMAN_API DECLARE_LOG_CATEGORY_EXTERN(LogBomberman, Warning, Warning);
+#elif UE_BUILD_TEST
+BOMBERMAN_API DECLARE_LOG_CATEGORY_EXTERN(LogBomberman, Log, Log);
+#else
+BOMBERMAN_API DECLARE_LOG_CATEGORY_EXTERN(LogBomberman, Log, All);
+#endif
+
+/**
+ * Logs one in every Every calls from this call site, for events that fire once per cell or per frame.
+ * Nothing is formatted unless the verbosity is compiled in and enabled. Game thread only.
+ */
+#define BOMBERMAN_LOG_SAMPLED(Every, Verbosity, Format, ...)                     \
+	do                                                                           \
+	{                                                                            \
+		if (UE_LOG_ACTIVE(LogBomberman, Verbosity))                              \
+		{                                                                        \
+			static uint32 BombermanLogSampleCounter = 0;                         \
+			if (BombermanLogSampleCounter++ % uint32(Every) == 0)                \
+			{                                                                    \
+				UE_LOG(LogBomberman, Verbosity, Format, ##__VA_ARGS__);          \
+			}                                                                    \
+		}                                                                        \
+	}                                                                            \
+	while (false)
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+
+// stat Bomberman
+DECLARE_STATS_GROUP(TEXT("Bomberman"), STATGROUP_Bomberman, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Place Bomb"), STAT_Bomberman_PlaceBomb, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Kick Sweep"), STAT_Bomberman_KickSweep, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Chain Resolve"), STAT_Bomberman_ChainResolve, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Chain Detonate"), STAT_Bomberman_ChainDetonate, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Explosion"), STAT_Bomberman_CreateExplosion, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Explosion Blueprint Events"), STAT_Bomberman_ExplosionEvents, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Blast Damage"), STAT_Bomberman_BlastDamage, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pool Acquire"), STAT_Bomberman_PoolAcquire, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Replay Record"), STAT_Bomberman_ReplayRecord, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Danger Update"), STAT_Bomberman_DangerUpdate, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Flow Field Build"), STAT_Bomberman_FlowFieldBuild, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bot Think"), STAT_Bomberman_BotThink, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bot Schedule"), STAT_Bomberman_BotSchedule, STATGROUP_Bomberman, BOMBERMAN_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Active Bombs"), STAT_Bomberman_ActiveBombs, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Explosion Cells"), STAT_Bomberman_ExplosionCells, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pool Spawns"), STAT_Bomberman_PoolSpawns, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bot Decisions"), STAT_Bomberman_BotDecisions, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bot Queue"), STAT_Bomberman_BotQueue, STATGROUP_Bomberman, BOMBERMAN_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Bot Decision Latency Max (ms)"), STAT_Bomberman_BotLatencyMax, STATGROUP_Bomberman, BOMBERMAN_API);
+
+// Frames the bot scheduler ran past its budget, since startup
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Bot Budget Overruns"), STAT_Bomberman_BotBudgetOverruns, STATGROUP_Bomberman, BOMBERMAN_API);
+
+// Insights channel for the gameplay scopes, -trace=cpu,Bomberman
+UE_TRACE_CHANNEL_EXTERN(BombermanChannel, BOMBERMAN_API);
+
+// csvprofile start, timings and gauges land under the Bomberman category
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(BOMBERMAN_API, Bomberman);
+
+// Cycle counter, Insights scope and CSV timing for one gameplay hot path
+#define BOMBERMAN_SCOPE(Name)                                                          \
+	SCOPE_CYCLE_COUNTER(STAT_Bomberman_##Name);                                        \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Bomberman_##Name, BombermanChannel);      \
+	CSV_SCOPED_TIMING_STAT(Bomberman, Name)
+
+namespace BombermanStats
+{
+	// Explosion cells burning right now, across all worlds
+	BOMBERMAN_API extern int32 LiveExplosionCells;
+
+	// Pushes the gauges to stat Bomberman and the CSV profiler, once per frame
+	BOMBERMAN_API void ReportGauges(int32 ActiveBombs);
+}
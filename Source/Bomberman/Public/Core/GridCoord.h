@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Integer world-cell coordinate (world position / cell size, rounded), packed into 32 bits.
+ * Exact to compare, hashes to itself and half the size of an FIntPoint in per-cell state.
+ */
+struct FGridCoord
+{
+	int16 X = 0;
+	int16 Y = 0;
+
+	constexpr FGridCoord() = default;
+	constexpr FGridCoord(int32 InX, int32 InY)
+		: X(int16(InX))
+		, Y(int16(InY))
+	{
+	}
+	explicit constexpr FGridCoord(FIntPoint Point)
+		: FGridCoord(Point.X, Point.Y)
+	{
+	}
+
+	static FGridCoord FromWorld(const FVector& WorldPosition, float CellSize)
+	{
+		return FGridCoord(FMath::RoundToInt32(WorldPosition.X / CellSize), FMath::RoundToInt32(WorldPosition.Y / CellSize));
+	}
+
+	// Center of the cell, at height Z
+	FVector ToWorld(float CellSize, double Z) const { return FVector(X * CellSize, Y * CellSize, Z); }
+
+	// The position moved to the center of its cell, height kept
+	static FVector Snap(const FVector& WorldPosition, float CellSize) { return FromWorld(WorldPosition, CellSize).ToWorld(CellSize, WorldPosition.Z); }
+
+	constexpr uint32 Pack() const { return uint32(uint16(X)) | (uint32(uint16(Y)) << 16); }
+	static constexpr FGridCoord Unpack(uint32 Packed) { return FGridCoord(int16(uint16(Packed)), int16(uint16(Packed >> 16))); }
+
+	FIntPoint ToIntPoint() const { return FIntPoint(X, Y); }
+	FString ToString() const { return FString::Printf(TEXT("X=%d Y=%d"), X, Y); }
+
+	constexpr FGridCoord operator+(FGridCoord Other) const { return FGridCoord(X + Other.X, Y + Other.Y); }
+	constexpr FGridCoord operator-(FGridCoord Other) const { return FGridCoord(X - Other.X, Y - Other.Y); }
+	constexpr FGridCoord operator*(int32 Scale) const { return FGridCoord(X * Scale, Y * Scale); }
+	constexpr FGridCoord& operator+=(FGridCoord Other) { return *this = *this + Other; }
+
+	constexpr bool operator==(FGridCoord Other) const { return Pack() == Other.Pack(); }
+	constexpr bool operator!=(FGridCoord Other) const { return Pack() != Other.Pack(); }
+
+	// Manhattan distance in cells
+	static constexpr int32 Distance(FGridCoord A, FGridCoord B)
+	{
+		return (A.X > B.X ? A.X - B.X : B.X - A.X) + (A.Y > B.Y ? A.Y - B.Y : B.Y - A.Y);
+	}
+
+	friend uint32 GetTypeHash(FGridCoord Coord) { return Coord.Pack(); }
+};
+
+static_assert(sizeof(FGridCoord) == 4, "FGridCoord is meant to pack into 32 bits");
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "PoolableActor.generated.h"
+
+UINTERFACE(MinimalAPI, meta = (CannotImplementInterfaceInBlueprint))
+class UPoolableActor : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Actors that can be recycled by UActorPoolSubsystem instead of being spawned and destroyed.
+ */
+class BOMBERMAN_API IPoolableActor
+{
+	GENERATED_BODY()
+
+public:
+	// Called after the pool moved the actor into place, before the caller initializes it
+	virtual void OnAcquiredFromPool() = 0;
+
+	// Called when the actor goes back to the pool (also right after a pre-warm spawn)
+	virtual void OnReturnedToPool() = 0;
+
+	// Sitting inactive in the pool, between OnReturnedToPool and OnAcquiredFromPool
+	virtual bool IsInPool() const = 0;
+};
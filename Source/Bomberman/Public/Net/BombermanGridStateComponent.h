@@ -0,0 +1,229 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Net/Serialization/FastArraySerializer.h"
+
+#include "World/Explosion.h"
+#include "BombermanGridStateComponent.generated.h"
+
+class ABomb;
+class ABombermanCharacter;
+class UBombermanGridStateComponent;
+struct FChainReactionResult;
+
+UENUM()
+enum class EGridEventType : uint8
+{
+	// Param: bomb power, Time: when the fuse runs out
+	BombPlaced,
+	// Param: direction (index into GridDirections)
+	BombKicked,
+	// Cell: where the kick ended
+	BombStopped,
+	// Time: when the bomb goes off, its CellBurned events share the time
+	BombDetonated,
+	// Param: EExplosionType
+	CellBurned,
+};
+
+// One change of the arena, cells are grid indices so both sides must have built the same grid
+USTRUCT()
+struct FGridEvent : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint16 CellIndex = 0;
+
+	UPROPERTY()
+	EGridEventType Type = EGridEventType::BombPlaced;
+
+	UPROPERTY()
+	uint8 Param = 0;
+
+	// Bomb the event is about, assigned by the server when the bomb is placed
+	UPROPERTY()
+	uint16 BombId = 0;
+
+	// Server world time in milliseconds
+	UPROPERTY()
+	int32 TimeMs = 0;
+
+	// BombPlaced only: placing player (player id + 1, 0 for none) and the key of their prediction
+	UPROPERTY()
+	uint8 OwnerSeat = 0;
+
+	UPROPERTY()
+	uint8 PredictionKey = 0;
+
+	// Server only, when the event was added (drives pruning)
+	double RecordTime = 0.0;
+
+	void PostReplicatedAdd(const struct FGridEventArray& InArraySerializer);
+
+	// 6 bytes plus the packed time (and 2 for placements) instead of a property header per field
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FGridEvent> : public TStructOpsTypeTraitsBase2<FGridEvent>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+USTRUCT()
+struct FGridEventArray : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FGridEvent> Items;
+
+	UPROPERTY(NotReplicated)
+	TObjectPtr<UBombermanGridStateComponent> Owner;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FGridEvent, FGridEventArray>(Items, DeltaParms, *this);
+	}
+};
+
+template <>
+struct TStructOpsTypeTraits<FGridEventArray> : public TStructOpsTypeTraitsBase2<FGridEventArray>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
+
+/**
+ * Server-authoritative bomb and blast state for networked matches.
+ * The server records placements, kicks and resolved blasts as small grid events in a
+ * delta-serialized fast array; clients rebuild bombs and explosions locally from them,
+ * so neither bombs nor explosion cells need an actor channel.
+ */
+UCLASS(ClassGroup = (Bomberman), meta = (BlueprintSpawnableComponent))
+class BOMBERMAN_API UBombermanGridStateComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UBombermanGridStateComponent();
+
+	// Component on the world's game state, nullptr until the game state exists
+	static UBombermanGridStateComponent* Get(const UObject* WorldContextObject);
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Server world time on both sides
+	double GetServerTime() const;
+
+	// Seat a player's bombs are tagged with in the events, 0 without a player state
+	static uint8 GetOwnerSeat(const ABombermanCharacter* Player);
+
+	// ===== Server: recorded from the authoritative gameplay code =====
+	// PredictionKey: key the owning client predicted the placement with, 0 for none
+	void RecordBombPlaced(ABomb* Bomb, uint8 PredictionKey = 0);
+	void RecordBombKicked(const ABomb* Bomb, int32 Dir);
+	void RecordBombStopped(const ABomb* Bomb);
+
+	// ===== Client: rebuilds the arena from replicated events =====
+	void ApplyEvent(const FGridEvent& Event);
+
+	// ===== Client: prediction for the local player, reconciled against the events =====
+	// Spawns the bomb before the server answers, returns the key to send along (0 when not predicted)
+	uint8 PredictBombPlaced(ABombermanCharacter* Player, FGridCoord Cell, int32 Power);
+	void RejectBombPrediction(uint8 Key);
+
+	// Kicks the local copy of a placed bomb, returns its id to send along (0 when not predicted)
+	uint16 PredictKick(ABomb* Bomb, const FVector& Direction, ABombermanCharacter* Kicker);
+	void RejectKickPrediction(uint16 BombId);
+
+	// Bombs of the player that are ticking here, predicted or confirmed (the client's view of its bomb count)
+	int32 CountLocalBombs(const ABombermanCharacter* Player) const;
+
+protected:
+	// Seconds an event stays in the replicated array (longer than a fuse plus a chain)
+	UPROPERTY(EditDefaultsOnly, Category = "Bomberman|Net")
+	float EventLifetime = 6.0f;
+
+	// Predictions the server neither confirmed nor rejected by then are rolled back
+	UPROPERTY(EditDefaultsOnly, Category = "Bomberman|Net")
+	float PredictionTimeout = 2.0f;
+
+private:
+	// Height bombs and blasts sit at, taken from the bombs placed on the server
+	UPROPERTY(Replicated)
+	float CellZ = 0.0f;
+
+	// Class of the last bomb placed on the server, spawned locally for other players' placements
+	// (its explosion class draws the blasts). Declared before Events so it arrives first.
+	UPROPERTY(Replicated)
+	TSubclassOf<ABomb> BombClass;
+
+	UPROPERTY(Replicated)
+	FGridEventArray Events;
+
+	uint16 NextBombId = 1;
+	FDelegateHandle ChainResolvedHandle;
+
+	struct FProxyBomb
+	{
+		TWeakObjectPtr<ABomb> Bomb;
+		uint8 OwnerSeat;
+	};
+
+	// Client: local bombs by server id, burns waiting for their server time
+	TMap<uint16, FProxyBomb> ProxyBombs;
+	TArray<FGridEvent> PendingBurns;
+
+	struct FPredictedBomb
+	{
+		uint8 Key;
+		uint8 OwnerSeat;
+		TWeakObjectPtr<ABomb> Bomb;
+		double Time;
+	};
+
+	struct FPredictedKick
+	{
+		uint16 BombId;
+		FGridCoord StartCell;
+		uint8 Dir;
+		double Time;
+	};
+
+	// Client: local player's actions the server has not answered yet
+	TArray<FPredictedBomb> PredictedBombs;
+	TArray<FPredictedKick> PredictedKicks;
+	uint8 NextPredictionKey = 1;
+
+	// Client per-tick scratch
+	TArray<FGridEvent> DueBurns;
+	TArray<FBlastCell> BurnCells;
+
+	bool IsServer() const;
+	FGridEvent* AddEvent(EGridEventType Type, FGridCoord Cell, uint16 BombId, uint8 Param, double Time);
+	void RecordChain(const FChainReactionResult& Result);
+	void PruneEvents(double Now);
+
+	ABomb* FindProxyBomb(uint16 BombId) const;
+	// The placing character's bomb class, else the server's, else the local player's
+	UClass* GetProxyBombClass(const ABombermanCharacter* Placer) const;
+	ABomb* SpawnProxyBomb(UClass* Class, FGridCoord Cell, int32 Power);
+	ABomb* AdoptPredictedBomb(const FGridEvent& Event);
+	void ReplayKick(ABomb* Bomb, const FGridEvent& Event, FGridCoord Cell);
+	void ExpirePredictions(double Now);
+	void BurnDueCells(double ServerNow);
+	void BurnCellsOf(uint16 BombId, TConstArrayView<FGridEvent> Burns);
+};
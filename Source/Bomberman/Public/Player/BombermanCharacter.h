@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+
+#include "Core/GridCoord.h"
 #include "BombermanCharacter.generated.h"
 
 class UInputAction;
@@ -23,6 +25,8 @@ class BOMBERMAN_API ABombermanCharacter : public ACharacter
 public:
 	ABombermanCharacter();
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	// Basic actions
 	UFUNCTION(BlueprintCallable, Category = "Bomberman|Actions")
 	void PlaceBomb();
@@ -33,10 +37,19 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Bomberman|Actions")
 	void PickupPowerup(APowerup* Powerup);
 
+	// The paths the input bindings take, for controllers without a local player (bots).
+	// Axis is the Input_Move value: X moves along world Y, Y along world X
+	void ApplyMoveInput(const FVector2D& Axis);
+	void ApplyBombPlaceInput();
+	void ApplyBombKickInput();
+
 	// Get Status
 	UFUNCTION(BlueprintPure, Category = "Bomberman|Stats")
 	int32 GetBombCount() const { return CurrentBombCount; }
 
+	UFUNCTION(BlueprintPure, Category = "Bomberman|Stats")
+	int32 GetMaxBombCount() const { return MaxBombCount; }
+
 	UFUNCTION(BlueprintPure, Category = "Bomberman|Stats")
 	int32 GetBombPower() const { return BombPower; }
 
@@ -46,6 +59,14 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Bomberman|Stats")
 	bool CanKickBombs() const { return bCanKickBombs; }
 
+	TSubclassOf<ABomb> GetBombClass() const { return BombClass; }
+
+	UFUNCTION(BlueprintPure, Category = "Bomberman|Health")
+	bool IsDead() const { return bIsDead; }
+
+	UFUNCTION(BlueprintPure, Category = "Bomberman|Health")
+	bool IsInvincible() const { return bIsInvincible; }
+
 	// Damage and death handling
 	UFUNCTION(BlueprintCallable, Category = "Bomberman|Health")
 	void TakeBombDamage(float DamageAmount, AActor* DamageSource);
@@ -56,24 +77,34 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Bomberman|Health")
 	void Respawn();
 
+#if WITH_DEV_AUTOMATION_TESTS
+	// Hooks for the benchmark and automation tests, which drive the character without input or a match
+	void SetInvincibleForTest(bool bInvincible) { bIsInvincible = bInvincible; }
+	void SetMaxBombCountForTest(int32 Count) { MaxBombCount = Count; }
+	void ResetBombCooldownForTest() { LastBombPlaceTime = -BombPlacementCooldown; }
+	bool CanPlaceBombAtForTest(FGridCoord Cell) const { return CanPlaceBombAt(Cell); }
+	ABomb* FindNearbyBombForTest() const { return FindNearbyBomb(); }
+#endif
+
 protected:
 	virtual void BeginPlay() override;
-	// virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaTime) override;
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
 	virtual void PossessedBy(AController* NewController) override;
 
 	// ===== Basic Status =====
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bomberman|Stats")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "Bomberman|Stats")
 	int32 MaxBombCount = 1;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bomberman|Stats")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "Bomberman|Stats")
 	int32 BombPower = 1;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bomberman|Stats")
 	float BaseMoveSpeed = 300.0f;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bomberman|Stats")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated, Category = "Bomberman|Stats")
 	bool bCanKickBombs = false;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bomberman|Stats")
@@ -142,6 +173,10 @@ private:
 	float LastBombPlaceTime;
 	bool bIsDead = false;
 
+	// Server: the cell the player stands on and the one it came from, bombs are only accepted on these
+	FGridCoord ServerCell;
+	FGridCoord PreviousServerCell;
+
 	UPROPERTY()
 	TArray<ABomb*> PlacedBombs;
 
@@ -152,16 +187,31 @@ private:
 	void MoveForward(float Value);
 	void MoveRight(float Value);
 	void PlaceBombInput();
+	void UpdateServerCells(bool bTeleported = false);
 	void KickBombInput();
 
 	void Handle_Move(const FInputActionInstance& Instance);
 	void Handle_BombPlace(const FInputActionValue& InputValue);
 	void Handle_BombKick(const FInputActionValue& InputValue);
 
+	// Clients predict and ask the server, which confirms through the grid events or rejects
+	UFUNCTION(Server, Reliable)
+	void ServerPlaceBomb(int32 PackedCell, uint8 PredictionKey);
+
+	UFUNCTION(Client, Reliable)
+	void ClientRejectBomb(uint8 PredictionKey);
+
+	UFUNCTION(Server, Reliable)
+	void ServerKickBomb(uint16 PredictedBombId);
+
+	UFUNCTION(Client, Reliable)
+	void ClientRejectKick(uint16 PredictedBombId);
+
 	// ===== Utility functions =====
-	FVector GetGridPosition(FVector WorldPosition) const;
-	bool CanPlaceBombAtPosition(FVector Position) const;
-	ABomb* FindNearbyBomb(float SearchRadius = 150.0f) const;
+	bool CanPlaceBombAt(FGridCoord Cell) const;
+	ABomb* PlaceBombAt(FGridCoord Cell, uint8 PredictionKey = 0);
+	ABomb* FindNearbyBomb() const;
+	FVector GetKickDirection(const ABomb* Bomb) const;
 	void UpdateMovementSpeed();
 	void StartInvincibility();
 	void EndInvincibility();
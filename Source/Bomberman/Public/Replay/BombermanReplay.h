@@ -0,0 +1,197 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/MemoryWriter.h"
+#include "Tasks/Pipe.h"
+
+#include "Sim/BombermanSim.h"
+
+class IFileHandle;
+
+// Record tags of the replay stream, each one followed by its payload
+enum class EReplayRecord : uint8
+{
+	// Packed tick delta, the records after it happened on the new tick
+	Tick,
+	// Seat, move axis X and Y (-127..127): Handle_Move held from this tick on
+	Move,
+	// Seat, EReplayButtons pressed on this tick
+	Buttons,
+	// Seat, packed cell index: the player entered a new cell
+	PlayerCell,
+	// Seat, packed cell index, power, packed fuse ticks
+	BombPlaced,
+	// Seat, packed cell index, direction (index into GridDirections)
+	BombKicked,
+	// Packed cell index, packed ticks until it goes off (chain delay)
+	BombDetonated,
+	// Seat, packed cell index
+	PlayerDied,
+	// Packed size, then the full FSimState at this tick
+	Keyframe,
+	End,
+};
+
+enum class EReplayButtons : uint8
+{
+	None	  = 0,
+	PlaceBomb = 1 << 0,
+	Kick	  = 1 << 1,
+};
+ENUM_CLASS_FLAGS(EReplayButtons)
+
+struct BOMBERMAN_API FReplayHeader
+{
+	static constexpr uint32 Magic	= 0x50524D42; // "BMRP"
+	static constexpr uint32 Version = 1;
+
+	int32 TicksPerSecond   = 60;
+	int32 KeyframeInterval = 300;
+	FString MapName;
+	FDateTime RecordedAt;
+
+	friend FArchive& operator<<(FArchive& Ar, FReplayHeader& Header);
+};
+
+// One record with its tick, fields unused by the record type stay zero
+struct FReplayRecord
+{
+	EReplayRecord Type = EReplayRecord::End;
+	int64 Tick		   = 0;
+	int32 Seat		   = 0;
+	int32 CellIndex	   = 0;
+	int32 Value		   = 0;
+	int32 Value2	   = 0;
+};
+
+// Event found on only one side of a replay: in the recording or in the re-simulation
+struct FReplayDivergence
+{
+	FReplayRecord Event;
+	bool bRecorded = false;
+};
+
+// Full simulation state as stored in keyframes
+BOMBERMAN_API void SerializeSimState(FArchive& Ar, FSimState& State);
+
+/**
+ * Streams replay records to a file. Records are appended to a memory buffer on the game
+ * thread and handed to a background pipe in chunks, so recording never waits on the disk.
+ */
+class BOMBERMAN_API FBombermanReplayWriter
+{
+public:
+	FBombermanReplayWriter();
+	~FBombermanReplayWriter();
+
+	bool Open(const FString& Path, FReplayHeader Header);
+	void Close();
+	bool IsOpen() const { return File.IsValid(); }
+
+	// Records written from now on happened on Tick (never earlier than the current one)
+	void SetTick(int64 Tick);
+
+	void WriteMove(int32 Seat, int8 AxisX, int8 AxisY);
+	void WriteButtons(int32 Seat, EReplayButtons Buttons);
+	void WritePlayerCell(int32 Seat, int32 CellIndex);
+	void WriteBombPlaced(int32 Seat, int32 CellIndex, int32 Power, int32 FuseTicks);
+	void WriteBombKicked(int32 Seat, int32 CellIndex, int32 Dir);
+	void WriteBombDetonated(int32 CellIndex, int32 DelayTicks);
+	void WritePlayerDied(int32 Seat, int32 CellIndex);
+	void WriteKeyframe(const FSimState& State);
+
+	int64 GetBytesWritten() const { return BytesFlushed + Buffer.Num(); }
+
+private:
+	// Chunks smaller than this stay in memory
+	static constexpr int32 FlushBytes = 16 * 1024;
+
+	TSharedPtr<IFileHandle> File;
+	UE::Tasks::FPipe WritePipe;
+
+	TArray<uint8> Buffer;
+	FMemoryWriter Ar;
+	TArray<uint8> KeyframeBuffer;
+
+	int64 CurrentTick  = 0;
+	int64 WrittenTick  = 0;
+	int64 BytesFlushed = 0;
+
+	void BeginRecord(EReplayRecord Type);
+	void WritePacked(uint32 Value);
+	void WriteByte(uint8 Value);
+	void Flush();
+};
+
+/**
+ * Plays a recorded match back through the headless simulation.
+ * Keyframes restore the complete state, the ticks between them are re-driven from the recorded
+ * inputs and actions, so a seek simulates at most one keyframe interval. Recorded detonations and
+ * deaths the re-simulation does not reproduce (and the other way round) are reported as divergences.
+ */
+class BOMBERMAN_API FBombermanReplayPlayer
+{
+public:
+	explicit FBombermanReplayPlayer(const FSimRules& InRules = FSimRules());
+
+	bool Load(const FString& Path);
+	bool Load(TArray<uint8>&& InData);
+
+	const FReplayHeader& GetHeader() const { return Header; }
+	int64 GetStartTick() const { return Keyframes.Num() > 0 ? Keyframes[0].Tick : 0; }
+	int64 GetEndTick() const { return EndTick; }
+	int32 NumKeyframes() const { return Keyframes.Num(); }
+
+	// Tick the simulation is at, the next Step plays this tick's records
+	int64 GetTick() const { return Sim.GetState().Tick; }
+	bool IsFinished() const { return GetTick() >= EndTick; }
+
+	// Restores the last keyframe at or before Tick and simulates up to it
+	bool Seek(int64 Tick);
+
+	// Plays one tick, false once the end of the recording is reached
+	bool Step();
+
+	const FBombermanSim& GetSim() const { return Sim; }
+
+	// Detonations and deaths only one side saw since the last keyframe restore
+	const TArray<FReplayDivergence>& GetDivergences() const { return Divergences; }
+
+private:
+	// Detonations and deaths may land this many ticks apart and still count as the same event
+	static constexpr int32 MatchWindowTicks = 12;
+
+	struct FKeyframeEntry
+	{
+		int64 Tick;
+		// Offset of the keyframe record in Data
+		int64 Offset;
+	};
+
+	FSimRules Rules;
+	FBombermanSim Sim;
+	FReplayHeader Header;
+
+	TArray<uint8> Data;
+	int64 RecordsOffset = 0;
+	TArray<FKeyframeEntry> Keyframes;
+	int64 EndTick = 0;
+
+	// Next record to play and the tick it belongs to
+	int64 Cursor	 = 0;
+	int64 CursorTick = 0;
+
+	// Per step scratch
+	TArray<FSimInput> Inputs;
+	TArray<FReplayRecord> Placed;
+
+	// Events waiting for their counterpart on the other side
+	TArray<FReplayRecord> Expected;
+	TArray<FReplayRecord> Unexpected;
+	TArray<FReplayDivergence> Divergences;
+
+	bool ReadRecord(FArchive& Reader, FReplayRecord& OutRecord, FSimState* OutKeyframe);
+	bool RestoreKeyframe(int32 KeyframeIndex);
+	void ApplyPlacement(const FReplayRecord& Record);
+	void MatchEvents();
+};
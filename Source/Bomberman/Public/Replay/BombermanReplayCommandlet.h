@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BombermanReplayCommandlet.generated.h"
+
+/**
+ * Plays a recorded replay back through the headless simulation and reports every detonation
+ * or death the recording and the re-simulation disagree on. Fails with -Strict if there are any.
+ *
+ * UnrealEditor-Cmd Bomberman.uproject -run=BombermanReplay -nullrhi -unattended
+ *   -Replay=Saved/Replays/Arena-2024.01.01-12.00.00.bmreplay -From=30 -To=45 -Strict
+ */
+UCLASS()
+class BOMBERMAN_API UBombermanReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBombermanReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
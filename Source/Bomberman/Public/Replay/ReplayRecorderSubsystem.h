@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "Replay/BombermanReplay.h"
+#include "ReplayRecorderSubsystem.generated.h"
+
+class ABomb;
+class ABombermanCharacter;
+struct FChainReactionResult;
+
+/**
+ * Records the match into a replay file: held inputs, actions, detonations and deaths per
+ * gameplay tick, plus a keyframe of the whole arena every few seconds (see FBombermanReplayPlayer).
+ * Starts with the world while bomberman.Replay.Record is set, only where the gameplay is authoritative.
+ */
+UCLASS()
+class BOMBERMAN_API UReplayRecorderSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// The world's recorder while it records, nullptr otherwise (the gameplay hooks check this)
+	static UReplayRecorderSubsystem* GetActive(const UObject* WorldContextObject);
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	UFUNCTION(BlueprintCallable, Category = "Bomberman|Replay")
+	bool StartRecording(const FString& Path);
+
+	UFUNCTION(BlueprintCallable, Category = "Bomberman|Replay")
+	void StopRecording();
+
+	UFUNCTION(BlueprintPure, Category = "Bomberman|Replay")
+	bool IsRecording() const { return Writer.IsValid(); }
+
+	// ===== Gameplay hooks =====
+	void RecordMove(const ABombermanCharacter* Player, const FVector2D& Axis);
+	void RecordButtons(const ABombermanCharacter* Player, EReplayButtons Buttons);
+	void RecordBombPlaced(const ABombermanCharacter* Player, const ABomb* Bomb);
+	void RecordBombKicked(const ABombermanCharacter* Kicker, const ABomb* Bomb, int32 Dir);
+	void RecordPlayerDied(const ABombermanCharacter* Player);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FSeat
+	{
+		// Who sat here at the last tick, a change forces a keyframe
+		TWeakObjectPtr<const ABombermanCharacter> Player;
+
+		// Handle_Move value and the frame it was last seen in
+		int8 AxisX		 = 0;
+		int8 AxisY		 = 0;
+		uint64 AxisFrame = 0;
+		EReplayButtons Buttons = EReplayButtons::None;
+
+		// Last values in the stream
+		int8 WrittenX	= 0;
+		int8 WrittenY	= 0;
+		int32 CellIndex = INDEX_NONE;
+	};
+
+	TUniquePtr<FBombermanReplayWriter> Writer;
+	TArray<FSeat> Seats;
+	int32 KeyframeTicks	= 0;
+	bool bNeedsKeyframe = false;
+
+	FDelegateHandle FixedTickHandle;
+	FDelegateHandle ChainResolvedHandle;
+
+	// Scratch for keyframes
+	FSimState KeyframeState;
+
+	FSeat* FindSeat(const ABombermanCharacter* Player, int32& OutSeat);
+	FSeat& GetSeat(int32 SeatIndex, const ABombermanCharacter* Player);
+	int32 GetCellIndex(const FVector& Location) const;
+	void OnFixedTick(int64 Tick);
+	void OnChainResolved(const FChainReactionResult& Result);
+};
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BombermanBatchSimCommandlet.generated.h"
+
+/**
+ * Runs many headless matches in parallel and writes aggregate stats as JSON.
+ *
+ * UnrealEditor-Cmd Bomberman.uproject -run=BombermanBatchSim -nullrhi -unattended
+ *   -Matches=10000 -Seed=0 -Players=4 -Policies=Greedy,Random -Maps=Arena.txt,Classic
+ *   -BlockPercent=70 -MatchSeconds=180 -NoRespawn -SingleThreaded -Out=Saved/BatchSim/Results.json
+ */
+UCLASS()
+class BOMBERMAN_API UBombermanBatchSimCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBombermanBatchSimCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
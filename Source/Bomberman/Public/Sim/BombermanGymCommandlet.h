@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BombermanGymCommandlet.generated.h"
+
+// Start of the shared memory region, every offset counts from here and every block is 64 byte aligned
+struct FSimGymSharedHeader
+{
+	static constexpr uint32 MagicValue = 0x4D594742; // "BGYM"
+	static constexpr int32 Version	   = 1;
+
+	uint32 Magic;
+	int32 LayoutVersion;
+	int32 NumEnvs;
+	int32 NumPlayers;
+	int32 Width;
+	int32 Height;
+	int32 NumPlanes;
+	int32 NumPlayerStats;
+
+	// int8 [Env][Player], ESimMctsAction values
+	int32 ActionsOffset;
+	// float [Env][Player]
+	int32 RewardsOffset;
+	// uint8 [Env]
+	int32 DonesOffset;
+	// uint8 [Env][Player][NumPlayerStats]
+	int32 PlayerStatsOffset;
+	// uint8 [Env][Plane][Height][Width]
+	int32 ObservationsOffset;
+	int32 TotalSize;
+
+	// The trainer writes the actions and Command, then increments CommandSeq.
+	// The environment answers by setting DoneSeq to the same value once the outputs are written.
+	volatile int32 Command;
+	volatile int32 CommandSeq;
+	volatile int32 DoneSeq;
+};
+
+enum class ESimGymCommand : int32
+{
+	Reset = 1,
+	Step  = 2,
+	Close = 3,
+};
+
+/**
+ * Serves FBombermanSimGym to a trainer process on the same machine through a named shared memory
+ * region (FSimGymSharedHeader). Observations are written in place, nothing is copied per step.
+ * From Python: multiprocessing.shared_memory.SharedMemory(name=Name), read the header with struct,
+ * then numpy views at the offsets.
+ *
+ * UnrealEditor-Cmd Bomberman.uproject -run=BombermanGym -nullrhi -unattended
+ *   -Name=BombermanGym -Envs=64 -Players=4 -Width=13 -Height=11 -BlockPercent=70 -Seed=0
+ *   -MatchSeconds=180 -NoRespawn -SingleThreaded
+ */
+UCLASS()
+class BOMBERMAN_API UBombermanGymCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBombermanGymCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
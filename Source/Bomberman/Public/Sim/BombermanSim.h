@@ -0,0 +1,234 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+
+#include "Core/BombermanGrid.h"
+
+// Powerup lying on a cell (see ABombermanCharacter::PickupPowerup)
+enum class ESimPowerup : uint8
+{
+	None,
+	BombCount,
+	BombPower,
+	Speed,
+	KickBomb,
+
+	Num
+};
+
+/**
+ * Match rules in fixed ticks. Defaults mirror the actor properties
+ * (ABomb, AExplosion, ABombermanCharacter) at 60 ticks per second.
+ */
+struct BOMBERMAN_API FSimRules
+{
+	int32 TicksPerSecond = 60;
+	// World units per cell, move and kick speeds are converted with it
+	int32 CellSize = 100;
+
+	// ABomb::DefaultExplosionTime
+	int32 FuseTicks = 180;
+	// AExplosion::LifeTime, cells keep burning (and killing) for this long
+	int32 ExplosionTicks = 60;
+	// AExplosion::ChainExplosionDelay
+	int32 ChainDelayTicks = 6;
+
+	// ABombermanCharacter::RespawnDelay / InvincibleDuration
+	int32 RespawnTicks	  = 180;
+	int32 InvincibleTicks = 120;
+	bool bRespawn		  = true;
+	// AExplosion ignores the owner of the bomb by default
+	bool bSelfDamage = false;
+
+	// ABombermanGameMode::GameDuration
+	int32 MatchTicks = 180 * 60;
+
+	// ABombermanCharacter::BaseMoveSpeed, +50 per speed powerup up to 600
+	int32 BaseMoveSpeed	 = 300;
+	int32 MoveSpeedStep	 = 50;
+	int32 MaxMoveSpeed	 = 600;
+	int32 MaxBombCount	 = 10;
+	int32 MaxBombPower	 = 10;
+
+	// ABomb::KickSpeed / KickDeceleration: 800 u/s slowing by 1000 u/s² stops after ~3 cells
+	int32 KickSpeed		= 800;
+	int32 KickMaxCells	= 3;
+
+	// ADestructibleBlock::PowerupSpawnChance in percent
+	int32 PowerupChance = 30;
+
+	int32 GetMoveTicksPerCell(int32 MoveSpeed) const { return FMath::Max(1, TicksPerSecond * CellSize / FMath::Max(1, MoveSpeed)); }
+	int32 GetKickTicksPerCell() const { return FMath::Max(1, TicksPerSecond * CellSize / FMath::Max(1, KickSpeed)); }
+};
+
+/**
+ * Static arena description: walls, destructible blocks and spawn cells.
+ * '#' wall, '+' block, '.' empty, '1'..'4' player spawn.
+ */
+struct BOMBERMAN_API FSimMapLayout
+{
+	int32 Width	 = 0;
+	int32 Height = 0;
+	TArray<EGridCellFlags> Cells;
+	TArray<FGridCoord> SpawnCells;
+
+	bool IsValid() const { return Width > 0 && Height > 0 && SpawnCells.Num() > 0; }
+
+	static FSimMapLayout FromRows(TConstArrayView<FString> Rows);
+
+	// Outer walls, pillars on even cells, random blocks except around the four corner spawns
+	static FSimMapLayout Classic(int32 Width = 13, int32 Height = 11, int32 BlockPercent = 70, int32 Seed = 0);
+};
+
+struct FSimBomb
+{
+	FGridCoord Cell;
+	int32 Owner	   = INDEX_NONE;
+	int32 Range	   = 1;
+	// Ticks until detonation
+	int32 FuseTicks = 0;
+	// Bombs between this one and the bomb that started the chain
+	int32 ChainDepth = 0;
+	// Kick direction (index into GridDirections), INDEX_NONE while resting
+	int32 KickDir		 = INDEX_NONE;
+	int32 KickCellsLeft	 = 0;
+	int32 KickTicks		 = 0;
+	// Cleared when the owner dies, the owner's bomb count was reset already
+	bool bCountsForOwner = true;
+};
+
+struct FSimPlayer
+{
+	FGridCoord Cell;
+	FGridCoord SpawnCell;
+	int32 Facing = 0;
+
+	int32 MaxBombCount = 1;
+	int32 BombPower	   = 1;
+	int32 MoveSpeed	   = 300;
+	bool bCanKickBombs = false;
+
+	int32 ActiveBombs	  = 0;
+	int32 MoveCooldown	  = 0;
+	int32 RespawnTicks	  = 0;
+	int32 InvincibleTicks = 0;
+	bool bAlive			  = true;
+
+	int32 Kills	 = 0;
+	int32 Deaths = 0;
+};
+
+// One player's command for one tick, same actions as the character input handlers
+struct FSimInput
+{
+	int8 MoveDir	= INDEX_NONE;
+	bool bPlaceBomb = false;
+	bool bKick		= false;
+};
+
+enum class ESimEventType : uint8
+{
+	BombPlaced,
+	BombKicked,
+	BombDetonated,
+	BlockDestroyed,
+	PowerupTaken,
+	PlayerDied,
+	PlayerRespawned,
+};
+
+// Something that happened during the last step, for stats and views
+struct FSimEvent
+{
+	ESimEventType Type;
+	FGridCoord Cell;
+	// Player involved (owner, victim, collector), INDEX_NONE when none
+	int16 Player;
+	// Chain depth for detonations, killer for deaths, powerup for pickups
+	int16 Value;
+};
+
+/**
+ * Complete match state. Plain data, copying it forks the match.
+ */
+struct BOMBERMAN_API FSimState
+{
+	FBombermanGrid Grid;
+	TArray<ESimPowerup> Powerups;
+	// Ticks each cell keeps burning and the player whose blast owns it
+	TArray<uint16> BurnTicks;
+	TArray<int8> BurnOwners;
+
+	TArray<FSimBomb> Bombs;
+	TArray<FSimPlayer> Players;
+
+	int32 Tick = 0;
+	FRandomStream Random;
+
+	// Filled by the last step only
+	TArray<FSimEvent> Events;
+
+	int32 FindBomb(FGridCoord Cell) const;
+	int32 NumAlivePlayers() const;
+};
+
+struct FSimMatchResult
+{
+	// INDEX_NONE on a draw
+	int32 Winner = INDEX_NONE;
+	int32 Ticks	 = 0;
+};
+
+/**
+ * Headless Bomberman rules over a compact grid state, advanced in fixed ticks.
+ * No actors, physics or timers: the same seed, layout and inputs always give the same match.
+ */
+class BOMBERMAN_API FBombermanSim
+{
+public:
+	explicit FBombermanSim(const FSimRules& InRules = FSimRules());
+
+	// Starts a new match with one player per spawn cell (up to NumPlayers)
+	void Reset(const FSimMapLayout& Layout, int32 NumPlayers, int32 Seed);
+
+	// Starts from a captured state (e.g. UBombermanGridSubsystem::CaptureSimState)
+	void Reset(const FSimState& InState);
+
+	// Advances one tick, Inputs are indexed by player (missing entries are idle)
+	void Step(TConstArrayView<FSimInput> Inputs);
+
+	bool IsFinished() const;
+	FSimMatchResult GetResult() const;
+
+	const FSimRules& GetRules() const { return Rules; }
+	const FSimState& GetState() const { return State; }
+	FSimState& GetMutableState() { return State; }
+
+private:
+	FSimRules Rules;
+	FSimState State;
+
+	// Per step scratch
+	TArray<int32> Detonating;
+	TArray<FGridCoord> BlocksToClear;
+
+	void ApplyInput(int32 PlayerIndex, const FSimInput& Input);
+	void MovePlayer(FSimPlayer& Player, int32 PlayerIndex, int32 Dir);
+	void PickupPowerup(FSimPlayer& Player, int32 PlayerIndex, FGridCoord Cell);
+	void PlaceBomb(int32 PlayerIndex);
+	void KickBomb(FSimPlayer& Player, int32 PlayerIndex);
+
+	void UpdateKicks();
+	void UpdateFuses();
+	void Detonate();
+	void ApplyDamage();
+	void UpdatePlayers();
+
+	void KillPlayer(int32 PlayerIndex, int32 Killer);
+	void RespawnPlayer(int32 PlayerIndex);
+	void SpawnPowerup(FGridCoord Cell);
+	void SyncPlayerFlags();
+
+	void AddEvent(ESimEventType Type, FGridCoord Cell, int32 Player, int32 Value = 0);
+};
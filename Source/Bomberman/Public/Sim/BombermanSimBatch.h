@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Sim/BombermanSim.h"
+#include "Sim/BombermanSimPolicies.h"
+
+// Longest chain tracked on its own, deeper chains share the last bucket
+static constexpr int32 SimMaxChainDepthBucket = 15;
+
+struct FSimBatchConfig
+{
+	int32 NumMatches = 1000;
+	// Match i uses BaseSeed + i for the layout, the rules and the policies
+	int32 BaseSeed	 = 0;
+	int32 NumPlayers = 4;
+	FSimRules Rules;
+
+	// Cycled per match, a classic layout generated from the match seed when empty
+	TArray<FSimMapLayout> Maps;
+	int32 BlockPercent = 70;
+
+	// Cycled per seat, SeatPolicyNames labels them in the stats
+	TArray<FSimPolicyFunc> SeatPolicies;
+	TArray<FString> SeatPolicyNames;
+
+	bool bSingleThreaded = false;
+};
+
+struct BOMBERMAN_API FSimBatchStats
+{
+	int32 Matches = 0;
+	int32 Draws	  = 0;
+	TArray<int32> WinsBySeat;
+
+	// Distinct policy names with the seats they played and the matches they won
+	TArray<FString> PolicyNames;
+	TArray<int32> PolicySeats;
+	TArray<int32> PolicyWins;
+
+	// Match length in ticks
+	int64 TotalTicks   = 0;
+	int32 MinTicks	   = 0;
+	int32 MaxTicks	   = 0;
+	int32 MedianTicks  = 0;
+	int32 P95Ticks	   = 0;
+
+	int64 Detonations	  = 0;
+	int64 BlocksDestroyed = 0;
+	int64 Deaths		  = 0;
+	// Detonations per chain depth (0 = started by its own fuse)
+	TArray<int64> ChainDepthHistogram;
+
+	double WallSeconds = 0.0;
+
+	double GetMatchesPerSecond() const { return WallSeconds > 0.0 ? Matches / WallSeconds : 0.0; }
+	double GetTicksPerSecond() const { return WallSeconds > 0.0 ? TotalTicks / WallSeconds : 0.0; }
+
+	FString ToJson() const;
+};
+
+/**
+ * Runs independent headless matches in parallel (one task per match) and aggregates the results.
+ * Matches share nothing while they run, so throughput scales with the worker threads.
+ */
+BOMBERMAN_API FSimBatchStats RunSimBatch(const FSimBatchConfig& Config);
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Sim/BombermanSim.h"
+
+// Observation planes per environment, each Height x Width bytes, row major
+enum class ESimGymPlane : uint8
+{
+	Walls,
+	Blocks,
+	// 255 about to go off, fading towards 1 with a fresh fuse
+	Bombs,
+	// 255 burning, otherwise how soon the bombs that reach the cell go off (same scale as Bombs)
+	Danger,
+	// ESimPowerup of the powerup lying there
+	Powerups,
+	// Then one plane per player seat, 255 where the living player stands
+	FirstPlayer,
+};
+
+// Bytes per player after the planes: MaxBombCount, BombPower, speed steps, can kick, alive
+static constexpr int32 SimGymPlayerStats = 5;
+
+struct FSimGymConfig
+{
+	int32 NumEnvs	 = 16;
+	int32 NumPlayers = 4;
+	// Classic layout generated per episode from Seed and the episode count
+	int32 Width		   = 13;
+	int32 Height	   = 11;
+	int32 BlockPercent = 70;
+	int32 Seed		   = 0;
+	FSimRules Rules;
+
+	bool bSingleThreaded = false;
+};
+
+// Caller owned output of a step, sized by FBombermanSimGym::Get*Size, e.g. views into a shared memory region
+struct FSimGymBuffers
+{
+	// [Env][Plane][Y][X]
+	TArrayView<uint8> Observations;
+	// [Env][Player][Stat]
+	TArrayView<uint8> PlayerStats;
+	// [Env][Player], kills minus deaths during the step
+	TArrayView<float> Rewards;
+	// [Env], the episode ended on this step and the environment already started the next one
+	TArrayView<uint8> Dones;
+};
+
+/**
+ * Many headless matches stepped together for training, with a gym-style reset/step.
+ * Actions are ESimMctsAction values per player (the tree search's action set), each lasting one tick.
+ * Observations are written straight into the caller's buffers, environments step in parallel and
+ * nothing is allocated per step (a new episode rebuilds its state once).
+ */
+class BOMBERMAN_API FBombermanSimGym
+{
+public:
+	explicit FBombermanSimGym(const FSimGymConfig& InConfig);
+
+	const FSimGymConfig& GetConfig() const { return Config; }
+
+	int32 GetNumPlanes() const { return int32(ESimGymPlane::FirstPlayer) + Config.NumPlayers; }
+	int32 GetPlaneSize() const { return Config.Width * Config.Height; }
+
+	// Element counts of each buffer across all environments
+	int32 GetObservationSize() const { return Config.NumEnvs * GetNumPlanes() * GetPlaneSize(); }
+	int32 GetPlayerStatsSize() const { return Config.NumEnvs * Config.NumPlayers * SimGymPlayerStats; }
+	int32 GetRewardsSize() const { return Config.NumEnvs * Config.NumPlayers; }
+	int32 GetDonesSize() const { return Config.NumEnvs; }
+
+	// Starts a new episode in every environment and writes the first observations
+	void Reset(const FSimGymBuffers& Buffers);
+
+	// Actions are [Env][Player], missing or unknown actions wait
+	void Step(TConstArrayView<int8> Actions, const FSimGymBuffers& Buffers);
+
+private:
+	struct FEnv
+	{
+		FBombermanSim Sim;
+		TArray<FSimInput> Inputs;
+		int32 Episode = 0;
+
+		explicit FEnv(const FSimRules& Rules) : Sim(Rules) {}
+	};
+
+	FSimGymConfig Config;
+	TArray<FEnv> Envs;
+
+	void ResetEnv(int32 EnvIndex);
+	void StepEnv(int32 EnvIndex, TConstArrayView<int8> Actions, const FSimGymBuffers& Buffers);
+	void WriteObservation(int32 EnvIndex, const FSimGymBuffers& Buffers) const;
+};
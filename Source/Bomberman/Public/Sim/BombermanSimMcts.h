@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Sim/BombermanSim.h"
+#include "Sim/BombermanSimPolicies.h"
+
+// One node of the search: a move, a wait or an action, held until the player can take its next step
+enum class ESimMctsAction : uint8
+{
+	// Move along GridDirections[0..3]
+	MovePosX,
+	MoveNegX,
+	MovePosY,
+	MoveNegY,
+	Wait,
+	PlaceBomb,
+	// Kicks the bomb the player faces
+	Kick,
+
+	Num
+};
+
+struct FSimMctsConfig
+{
+	// Wall clock limit of one decision, checked every tick of the search
+	double BudgetSeconds = 0.01;
+	// Iterations per tree on top of the time limit, 0 for none (a fixed count gives reproducible decisions)
+	int32 MaxIterations = 0;
+	// Independent trees searched in parallel and merged at the root, 0 for one per worker thread
+	int32 NumTrees = 0;
+
+	// Macro steps from the root before the rollout takes over
+	int32 MaxDepth = 6;
+	// Ticks every player follows RolloutPolicy after the tree
+	int32 RolloutTicks = 180;
+	// UCT exploration constant
+	float Exploration = 0.7f;
+
+	// The other players inside the tree, and everyone during rollouts
+	FSimPolicyFunc OpponentPolicy = &BombermanSimPolicies::Greedy;
+	FSimPolicyFunc RolloutPolicy  = &BombermanSimPolicies::Greedy;
+
+	int32 Seed = 0;
+};
+
+struct FSimMctsResult
+{
+	// Input for the next tick, the first tick of the chosen action
+	FSimInput Input;
+	ESimMctsAction Action = ESimMctsAction::Wait;
+
+	// Mean rollout value of the chosen action in [0, 1], 0 is dying
+	float Value		 = 0.0f;
+	int32 Iterations = 0;
+	int32 Trees		 = 0;
+	double Seconds	 = 0.0;
+};
+
+/**
+ * Monte Carlo tree search for one player over the headless rules.
+ * Each iteration forks the root state into a per-tree FBombermanSim (copying FSimState reuses
+ * the buffers of the previous fork), replays the tree path as macro steps with the other
+ * players on OpponentPolicy, rolls out and scores survival, kills, powerups and cleared blocks.
+ * Trees run on worker threads without sharing anything and are merged by root visits.
+ * Keep the planner around between decisions: trees, states and the policies' per-tree scratch are
+ * reused, so a search only allocates while a tree or its buffers still grow.
+ */
+class BOMBERMAN_API FBombermanSimMcts
+{
+public:
+	explicit FBombermanSimMcts(const FSimRules& InRules = FSimRules());
+
+	FSimMctsResult Search(const FSimState& Root, int32 PlayerIndex, const FSimMctsConfig& Config);
+
+	// First tick's input of an action
+	static FSimInput ToInput(ESimMctsAction Action);
+
+private:
+	struct FNode
+	{
+		int32 Parent	 = INDEX_NONE;
+		int32 FirstChild = INDEX_NONE;
+		int32 NumChildren = 0;
+		ESimMctsAction Action = ESimMctsAction::Wait;
+		// Legal actions not expanded yet, one bit per ESimMctsAction
+		uint8 Untried = 0;
+		bool bExpanded	= false;
+		int32 Visits	= 0;
+		float ValueSum	= 0.0f;
+	};
+
+	struct FTree
+	{
+		TArray<FNode> Nodes;
+		FBombermanSim Sim;
+		TArray<FSimInput> Inputs;
+		TArray<int32> Path;
+		FRandomStream Random;
+		FSimPolicyScratch PolicyScratch;
+		int32 Iterations = 0;
+
+		explicit FTree(const FSimRules& Rules) : Sim(Rules) {}
+	};
+
+	FSimRules Rules;
+	TArray<TUniquePtr<FTree>> Trees;
+
+	// Scores of the root state, rollouts are valued against them
+	struct FRootStats
+	{
+		int32 Kills		= 0;
+		int32 Deaths	= 0;
+		int32 Abilities = 0;
+		int32 Blocks	= 0;
+	};
+
+	void RunTree(FTree& Tree, const FSimState& Root, const FRootStats& RootStats, int32 PlayerIndex, const FSimMctsConfig& Config, double Deadline) const;
+
+	// False when the deadline passed before the macro step finished
+	bool StepAction(FTree& Tree, int32 PlayerIndex, ESimMctsAction Action, const FSimMctsConfig& Config, double Deadline) const;
+
+	static uint8 GetLegalActions(const FSimState& State, int32 PlayerIndex);
+	FRootStats GetStats(const FSimState& State, int32 PlayerIndex) const;
+	float Evaluate(const FSimState& State, int32 PlayerIndex, const FRootStats& RootStats) const;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FSimState;
+struct FSimInput;
+class FRandomStream;
+class FBombermanSimMcts;
+
+// Search buffers of one policy caller, indexed like the grid and kept between calls
+struct BOMBERMAN_API FSimPolicyScratch
+{
+	TArray<uint8> Danger;
+	TArray<uint8> DangerAfter;
+	TArray<uint8> Burning;
+	TArray<uint8> Visited;
+	// Cell index and first direction
+	TArray<TPair<int32, int32>> Frontier;
+	TArray<TPair<int32, int32>> Next;
+
+	// Created on the first Mcts call, keeps its trees between calls
+	TUniquePtr<FBombermanSimMcts> Planner;
+
+	FSimPolicyScratch();
+	~FSimPolicyScratch();
+};
+
+// Chooses the input of one player for the next tick. Must only read the state (called from worker threads),
+// every concurrent caller brings its own Scratch.
+using FSimPolicyFunc = void (*)(const FSimState& State, int32 PlayerIndex, const FRandomStream& Random, FSimPolicyScratch& Scratch, FSimInput& OutInput);
+
+namespace BombermanSimPolicies
+{
+	// Stands still
+	BOMBERMAN_API void Idle(const FSimState& State, int32 PlayerIndex, const FRandomStream& Random, FSimPolicyScratch& Scratch, FSimInput& OutInput);
+
+	// Random walk, drops a bomb now and then
+	BOMBERMAN_API void RandomWalk(const FSimState& State, int32 PlayerIndex, const FRandomStream& Random, FSimPolicyScratch& Scratch, FSimInput& OutInput);
+
+	// Flees blasts, bombs blocks and players it can escape from, walks to powerups and blocks
+	BOMBERMAN_API void Greedy(const FSimState& State, int32 PlayerIndex, const FRandomStream& Random, FSimPolicyScratch& Scratch, FSimInput& OutInput);
+
+	// Tree search over the default rules (FBombermanSimMcts) with a fixed iteration count, Greedy opponents
+	BOMBERMAN_API void Mcts(const FSimState& State, int32 PlayerIndex, const FRandomStream& Random, FSimPolicyScratch& Scratch, FSimInput& OutInput);
+
+	// Policy by name ("Idle", "Random", "Greedy", "Mcts"), nullptr when unknown
+	BOMBERMAN_API FSimPolicyFunc Find(const FString& Name);
+}
@@ -6,16 +6,24 @@
 #include "GameFramework/Actor.h"
 
 #include "World/Explosion.h"
+#include "World/InstancedMeshRenderSubsystem.h"
+#include "Core/PoolableActor.h"
 #include "Bomb.generated.h"
 
 class ABombermanCharacter;
 class AExplosion;
+class UBombUpdateSubsystem;
 
 UCLASS()
-class BOMBERMAN_API ABomb : public AActor
+class BOMBERMAN_API ABomb : public AActor, public IPoolableActor
 {
 	GENERATED_BODY()
 
+	// Drives fuse, kick, owner pass and pulse of every bomb
+	friend class UBombUpdateSubsystem;
+	// Assigns the network id and mirrors server bombs on clients
+	friend class UBombermanGridStateComponent;
+
 public:
 	ABomb();
 
@@ -29,12 +37,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Bomb")
 	void ForceExplode();
 
+	UFUNCTION(BlueprintPure, Category = "Bomb")
+	bool IsExploding() const { return bIsExploding; }
+
+	// Called by the chain reaction resolver: the bomb is part of a resolved chain
+	void BeginDetonation();
+
+	// Called by the chain reaction resolver once the chain delay of this bomb has passed
+	void Detonate(TConstArrayView<FBlastCell> Cells);
+
 	UFUNCTION(BlueprintCallable, Category = "Bomb")
-	void SetBombPower(int32 NewPower) { ExplosionRange = NewPower; }
+	void SetBombPower(int32 NewPower);
 
 	UFUNCTION(BlueprintPure, Category = "Bomb")
 	int32 GetBombPower() const { return ExplosionRange; }
 
+	TSubclassOf<AExplosion> GetExplosionClass() const { return ExplosionClass; }
+
+	float GetDefaultExplosionTime() const { return DefaultExplosionTime; }
+
 	// Kick function
 	UFUNCTION(BlueprintCallable, Category = "Bomb|Kick")
 	bool CanBeKicked() const;
@@ -47,13 +68,27 @@ public:
 
 	// Owner management
 	UFUNCTION(BlueprintCallable, Category = "Bomb")
-	void SetBombOwner(ABombermanCharacter* NewOwner) { BombOwner = NewOwner; }
+	void SetBombOwner(ABombermanCharacter* NewOwner);
 
 	UFUNCTION(BlueprintPure, Category = "Bomb")
 	ABombermanCharacter* GetBombOwner() const { return BombOwner; }
 
 	void DisableOwnerCollision();
 
+	// Cell this bomb occupies on the grid
+	FGridCoord GetGridCell() const { return GridCell; }
+
+	// Moves the bomb onto Cell at once (server corrections)
+	void SnapToCell(FGridCoord Cell);
+
+	// Id in the replicated grid events, 0 until the server has placed it
+	uint16 GetNetId() const { return NetId; }
+
+	// IPoolableActor
+	virtual void OnAcquiredFromPool() override;
+	virtual void OnReturnedToPool() override;
+	virtual bool IsInPool() const override { return bInPool; }
+
 	// Delegate
 	DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnBombExploded, ABomb*, ExplodedBomb);
 	UPROPERTY(BlueprintAssignable, Category = "Bomb|Events")
@@ -61,7 +96,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
-	virtual void Tick(float DeltaTime) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	// virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
 	// virtual void NotifyActorEndOverlap(AActor* OtherActor) override;
 
@@ -143,31 +178,56 @@ private:
 	UPROPERTY()
 	ABombermanCharacter* BombOwner;
 
-	FTimerHandle ExplosionTimerHandle;
 	FTimerHandle OwnerIgnoreTimerHandle;
 
 	float ExplosionTimer;
 	bool bIsExploding  = false;
 	bool bOwnerCanPass = true;
+	bool bInPool	   = false;
 
 	// キック関連
 	bool bIsBeingKicked = false;
-	FVector _KickDirection;
-	float CurrentKickSpeed = 0.0f;
+
+	// Id in the replicated grid events, 0 when the clients do not know this bomb
+	uint16 NetId = 0;
+
+	// Slot in UBombUpdateSubsystem, INDEX_NONE while not updated
+	int32 UpdateSlot = INDEX_NONE;
+
+	// Instance in the shared bomb mesh when instanced rendering is on
+	FInstancedMeshHandle RenderHandle;
+	// Last pulse applied, instanced bombs carry it in the instance transform only
+	float PulseScale = 1.0f;
+
+	// グリッド関連
+	FGridCoord GridCell;
+	bool bRegisteredOnGrid = false;
 
 	// ===== 内部関数 =====
-	void CreateExplosion();
-	void CheckExplosionDirection(FVector Direction, int32 Range);
-	void UpdateKickMovement(float DeltaTime);
+	void ActivateBomb();
+	void CreateExplosion(TConstArrayView<FBlastCell> Cells);
+	// Kick motion from UBombUpdateSubsystem: the bomb takes over the next cell half way there,
+	// the location in between is only visual
+	void EnterKickCell(FGridCoord Cell);
+	void SetKickLocation(const FVector& Location);
 	void OnKickCollision();
 	void EnableOwnerCollision();
-	void UpdateTimerEffects(float DeltaTIme);
-	void UpdateOwnerCanPass();
+	void ApplyPulseScale(float Scale);
+	bool UpdateOwnerCanPass();
 
-	void SpawnExplosion(FVector Position, EExplosionType Type);
+	AExplosion* SpawnExplosion(FVector Position, EExplosionType Type);
 
 	// グリッド関連
-	FVector GetGridPosition(FVector WorldPosition) const;
+	class UBombermanGridSubsystem* GetGridSubsystem() const;
+	void UnregisterFromGrid();
+
+	UBombUpdateSubsystem* GetUpdateSubsystem() const;
+	void UnregisterFromUpdates();
+
+	// 描画関連
+	void AddRenderInstance();
+	void SyncRenderInstance();
+	void RemoveRenderInstance();
 
 	bool IsValidGridPosition(FVector Position) const
 	{
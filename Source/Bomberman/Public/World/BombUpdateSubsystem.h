@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BombUpdateSubsystem.generated.h"
+
+class ABomb;
+class UBombermanGridSubsystem;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGameplayTick, int64 /* Tick */);
+
+/**
+ * Updates every live bomb in one pass per frame (fuse, kick, owner pass, pulse animation)
+ * instead of a Tick per bomb actor. State is kept as parallel arrays indexed by slot.
+ * Also owns the fixed-step gameplay clock: fuses and kicks advance in whole ticks from a
+ * frame time accumulator, and the chain reaction steps with them.
+ */
+UCLASS()
+class BOMBERMAN_API UBombUpdateSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void Register(ABomb* Bomb);
+	void Unregister(ABomb* Bomb);
+
+	// Gameplay ticks stepped so far, see BombermanClock
+	int64 GetCurrentTick() const { return CurrentTick; }
+
+	// Broadcast after each fixed step, once fuses, kicks and the chain reaction of the tick ran
+	FOnGameplayTick OnFixedTickEnd;
+
+	void SetFuse(const ABomb* Bomb, float Seconds);
+	float GetFuseRemaining(const ABomb* Bomb) const;
+	// Tick the fuse runs out on, MAX_int64 while none is running
+	int64 GetFuseEndTick(const ABomb* Bomb) const;
+
+	// Plans the kick through the grid, returns the cells it will travel (0: blocked, nothing started)
+	int32 StartKick(const ABomb* Bomb, int32 Dir, float Speed);
+	void StopKick(const ABomb* Bomb);
+
+	// Runs one bomb's kick Seconds ahead in whole ticks (catching up after a rollback)
+	void AdvanceKick(const ABomb* Bomb, float Seconds);
+
+	void SetOwnerCanPass(const ABomb* Bomb, bool bCanPass);
+
+	int32 Num() const { return Bombs.Num(); }
+
+private:
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<ABomb>> Bombs;
+
+	int64 CurrentTick		 = 0;
+	double TickAccumulator	 = 0.0;
+	uint32 NextRegisterOrder = 0;
+
+	// ===== Per slot state =====
+	TArray<int64> FuseEndTicks;
+	// Registration order, bombs whose fuses end on the same tick go off in this order
+	TArray<uint32> RegisterOrders;
+	// Kicks run along a grid direction in fixed point, measured from the cell center they started on.
+	// KickTargets is the planned stop cell center, it only ever moves closer when something blocks the way
+	TArray<int8> KickDirs;
+	TArray<FVector> KickOrigins;
+	TArray<int32> KickTravels;
+	TArray<int32> KickTargets;
+	TArray<int32> KickSpeeds;
+	TArray<int32> KickDecelerations;
+	TArray<uint8> OwnerCanPass;
+
+	TArray<float> PulseSpeeds;
+	TArray<float> PulseMinScales;
+	TArray<float> PulseMaxScales;
+
+	// ===== Per frame scratch =====
+	TArray<float> PulseScales;
+	TArray<int32> ExpiredSlots;
+	TArray<ABomb*> ExpiredBombs;
+
+	void StepFixed();
+	void UpdateFuses();
+	void UpdateKicks();
+	void StepKickSlot(int32 Slot, const UBombermanGridSubsystem& Grid);
+	void UpdateOwnerPass();
+	void UpdatePulse(double Time);
+};
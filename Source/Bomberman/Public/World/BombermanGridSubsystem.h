@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "Core/BombermanDangerMap.h"
+#include "Core/BombermanGrid.h"
+#include "BombermanGridSubsystem.generated.h"
+
+class ABomb;
+class AExplosion;
+class ADestructibleBlock;
+class APowerup;
+class ABombermanCharacter;
+struct FSimRules;
+struct FSimState;
+
+/**
+ * Authoritative occupancy grid of the arena.
+ * Walls are probed once when the world begins play, everything else registers itself
+ * on spawn / move / destroy so gameplay queries never touch the physics scene.
+ */
+UCLASS(Config = Game)
+class BOMBERMAN_API UBombermanGridSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Probe static walls again (e.g. after streaming in a new arena)
+	UFUNCTION(BlueprintCallable, Category = "Bomberman|Grid")
+	void RebuildFromWorld();
+
+	const FBombermanGrid& GetGrid() const { return Grid; }
+	float GetCellSize() const { return Grid.CellSize; }
+
+	FGridCoord WorldToCell(const FVector& WorldPosition) const { return Grid.WorldToCell(WorldPosition); }
+	FVector CellToWorld(FGridCoord Cell, float Z) const { return Grid.CellToWorld(Cell, Z); }
+
+	bool HasAny(FGridCoord Cell, EGridCellFlags Mask) const { return Grid.HasAny(Cell, Mask); }
+
+	// Changes whenever a wall, block or bomb appears, moves or goes away (path caches key on it)
+	uint32 GetLayoutVersion() const { return LayoutVersion; }
+
+	// ===== Registration =====
+	FGridCoord RegisterBomb(ABomb* Bomb);
+	void UnregisterBomb(ABomb* Bomb, FGridCoord Cell);
+	void MoveBomb(ABomb* Bomb, FGridCoord From, FGridCoord To);
+
+	void RegisterBlock(ADestructibleBlock* Block);
+	void UnregisterBlock(ADestructibleBlock* Block);
+
+	void RegisterPowerup(APowerup* Powerup);
+	void UnregisterPowerup(APowerup* Powerup);
+
+	void RegisterPlayer(ABombermanCharacter* Player);
+	void UnregisterPlayer(ABombermanCharacter* Player);
+
+	// Burning cells, players standing on one take its damage once per tick
+	void RegisterExplosion(AExplosion* Explosion, FGridCoord Cell);
+	void UnregisterExplosion(AExplosion* Explosion, FGridCoord Cell);
+
+	// ===== Danger =====
+	// Earliest gameplay tick a blast reaches the cell: 0 while it burns, FBombermanDangerMap::Never if no bomb reaches it
+	int64 GetBurnTick(FGridCoord Cell) const;
+	// No blast reaches the cell up to and including Tick
+	bool IsSafeUntil(FGridCoord Cell, int64 Tick) const { return GetBurnTick(Cell) > Tick; }
+	const FBombermanDangerMap& GetDangerMap() const { return DangerMap; }
+
+	// Seconds until a blast reaches the location, 0 while it burns, -1 if no bomb reaches it (UI hints)
+	UFUNCTION(BlueprintPure, Category = "Bomberman|Grid")
+	float GetSecondsUntilBurn(const FVector& WorldLocation) const;
+
+	// Fuse end or, once its chain is resolved, the exact tick the bomb goes off at
+	void SetBombFuseTick(const ABomb* Bomb, int64 Tick);
+	void SetBombRange(const ABomb* Bomb, int32 Range);
+
+	// ===== Lookups =====
+	ADestructibleBlock* GetBlockAt(FGridCoord Cell) const;
+	ABomb* GetBombAt(FGridCoord Cell) const;
+	// Bomb on the cell next to Cell in direction Dir (index into GridDirections)
+	ABomb* GetAdjacentBomb(FGridCoord Cell, int32 Dir) const;
+	// Latest blast burning the cell
+	AExplosion* GetExplosionAt(FGridCoord Cell) const;
+	const TArray<TWeakObjectPtr<ABomb>>& GetBombs() const { return Bombs; }
+	// Indexed by seat, a player keeps its seat until it leaves and left seats stay empty until the next join
+	const TArray<TWeakObjectPtr<ABombermanCharacter>>& GetPlayers() const { return Players; }
+
+	// Copies the live arena into a headless simulation state (players in registration order)
+	void CaptureSimState(const FSimRules& Rules, FSimState& OutState) const;
+
+protected:
+	// World units per cell
+	UPROPERTY(Config)
+	float CellSize = 100.0f;
+
+	// Extra cells around the detected arena bounds (outer walls)
+	UPROPERTY(Config)
+	int32 BoundsPadding = 1;
+
+	// Arena half size in cells when no player starts or blocks are found
+	UPROPERTY(Config)
+	int32 FallbackHalfExtentCells = 16;
+
+	// Half height of the box used to probe static walls, centered at player start height
+	UPROPERTY(Config)
+	float WallProbeHalfHeight = 40.0f;
+
+private:
+	FBombermanGrid Grid;
+
+	// Per-cell destructible block, indexed like Grid.Cells
+	TArray<TWeakObjectPtr<ADestructibleBlock>> BlockCells;
+
+	// Per-cell bomb, indexed like Grid.Cells (kicked bombs cannot share a cell)
+	TArray<TWeakObjectPtr<ABomb>> BombCells;
+
+	// Per-cell live explosions, indexed like Grid.Cells, oldest first (blasts of several players can overlap)
+	TArray<TArray<TWeakObjectPtr<AExplosion>, TInlineAllocator<2>>> ExplosionCells;
+
+	// Per-cell powerup count, indexed like Grid.Cells (drops can land on a cell that already holds one)
+	TArray<uint8> PowerupCounts;
+
+	// Earliest burn tick per cell, kept up to date by the registrations below
+	FBombermanDangerMap DangerMap;
+
+	uint32 LayoutVersion = 0;
+
+	TArray<TWeakObjectPtr<ABomb>> Bombs;
+	TArray<TWeakObjectPtr<ABombermanCharacter>> Players;
+	TArray<int32> PlayerCellIndices;
+
+	void ProbeWalls(float ProbeZ);
+	void AddBombDanger(const ABomb* Bomb, FGridCoord Cell);
+	void UpdatePlayerCells();
+	void ApplyBlastDamage();
+};
@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#include "World/Explosion.h"
+#include "ChainReactionSubsystem.generated.h"
+
+class ABomb;
+class ADestructibleBlock;
+class UBombermanGridSubsystem;
+
+// A bomb taking part in a resolved chain
+struct FChainBomb
+{
+	TWeakObjectPtr<ABomb> Bomb;
+	FGridCoord Cell;
+	// Seconds after the resolve at which this bomb goes off (visual staggering)
+	float Delay = 0.0f;
+	// Range of FChainReactionResult::Cells burned by this bomb
+	int32 FirstCell = 0;
+	int32 NumCells	= 0;
+};
+
+// Everything one batch of detonations affects
+struct FChainReactionResult
+{
+	TArray<FChainBomb> Bombs;
+	// Every burning cell once, owned by the first bomb that reaches it,
+	// except that each bomb also owns the Center cell it sits on
+	TArray<FBlastCell> Cells;
+	TArray<TWeakObjectPtr<ADestructibleBlock>> Blocks;
+
+	void Reset()
+	{
+		Bombs.Reset();
+		Cells.Reset();
+		Blocks.Reset();
+	}
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnChainReactionResolved, const FChainReactionResult&);
+
+/**
+ * Collects the bombs detonating this tick and resolves the whole chain in a single
+ * breadth-first pass over the occupancy grid, instead of one timer and blast per bomb.
+ */
+UCLASS()
+class BOMBERMAN_API UChainReactionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Detonate the bomb with the next resolve, Delay seconds later
+	void QueueDetonation(ABomb* Bomb, float Delay = 0.0f);
+
+	// Resolves the queued detonations now, the bombs go off on the next tick (Tick calls this first)
+	void ResolveQueued();
+
+	// One fixed gameplay tick, driven by UBombUpdateSubsystem after the fuses of that tick
+	void StepFixed(int64 Tick);
+
+	// Last fixed tick stepped, chain delays and explosion lifetimes count from here
+	int64 GetCurrentTick() const { return CurrentTick; }
+
+	// Explosions return to the pool from here once their life time is over
+	void TrackExplosion(AExplosion* Explosion);
+	void UntrackExplosion(AExplosion* Explosion);
+
+	// Broadcast once per resolve with the batched result
+	FOnChainReactionResolved OnChainReactionResolved;
+
+private:
+	struct FQueuedDetonation
+	{
+		TWeakObjectPtr<ABomb> Bomb;
+		float Delay;
+	};
+
+	struct FPendingDetonation
+	{
+		TWeakObjectPtr<ABomb> Bomb;
+		int64 DetonateTick;
+		int32 FirstCell;
+		int32 NumCells;
+	};
+
+	TArray<FQueuedDetonation> Queue;
+	int64 CurrentTick = 0;
+
+	// Burning explosions, checked against their expire tick every fixed tick
+	TArray<TWeakObjectPtr<AExplosion>> LiveExplosions;
+
+	// Result of the last resolve, kept to reuse its allocations
+	FChainReactionResult Result;
+
+	// Bombs waiting for their chain delay, cells they will burn
+	TArray<FPendingDetonation> Pending;
+	TArray<FBlastCell> PendingCells;
+
+	// Per-cell scratch, indexed like the grid and cleared in place between resolves
+	TBitArray<> BurnedCells;
+
+	void Resolve(UBombermanGridSubsystem& Grid);
+	void DetonatePending(int64 Tick);
+	void CompactPendingCells();
+	void ExpireExplosions(int64 Tick);
+};
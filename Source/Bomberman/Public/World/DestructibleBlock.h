@@ -21,6 +21,9 @@ public:
     void SpawnPowerup();
 
 protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     float PowerupSpawnChance = 0.3f;
     
@@ -4,6 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+
+#include "Core/PoolableActor.h"
+#include "Core/BombermanGrid.h"
+#include "World/InstancedMeshRenderSubsystem.h"
 #include "Explosion.generated.h"
 
 class ABombermanCharacter;
@@ -18,11 +22,22 @@ enum class EExplosionType : uint8
     End         // The tip of the explosion
 };
 
+// One burning cell of a resolved blast
+struct FBlastCell
+{
+    FGridCoord Cell;
+    EExplosionType Type;
+    EGridCellFlags Flags; // Occupancy when the blast was resolved
+};
+
 
 UCLASS()
-class BOMBERMAN_API AExplosion : public AActor
+class BOMBERMAN_API AExplosion : public AActor, public IPoolableActor
 {
 	GENERATED_BODY()
+
+	// Returns expired explosions to the pool
+	friend class UChainReactionSubsystem;
 	
 public:
     AExplosion();
@@ -36,9 +51,23 @@ public:
     UFUNCTION(BlueprintPure, Category = "Explosion")
     ABombermanCharacter* GetExplosionOwner() const { return ExplosionOwner; }
 
+    float GetChainExplosionDelay() const { return ChainExplosionDelay; }
+    float GetRemainingLifeTime() const;
+
+    // Damage for a player standing on this cell, applied by the grid once per tick
+    void DamagePlayer(ABombermanCharacter* Player);
+
+    // Blueprint notifications for what this cell burned, sent by the detonating bomb
+    void NotifyBlockBurned(class ADestructibleBlock* Block) { OnBlockDestroyed(Block); }
+    void NotifyBombChained(ABomb* ChainBomb) { OnBombChainExploded(ChainBomb); }
+
+    // IPoolableActor
+    virtual void OnAcquiredFromPool() override;
+    virtual void OnReturnedToPool() override;
+    virtual bool IsInPool() const override { return bInPool; }
+
 protected:
     virtual void BeginPlay() override;
-    virtual void NotifyActorBeginOverlap(AActor* OtherActor) override;
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
     // ===== Components =====
@@ -81,11 +110,27 @@ private:
     UPROPERTY()
     ABomb* SourceBomb;
     
-    FTimerHandle LifeTimerHandle;
-    TSet<AActor*> DamagedActors; // Prevent duplicate damage
+    // Gameplay tick at which the chain subsystem returns this explosion, no per-actor timer
+    int64 ExpireTick = 0;
+    bool bLifeTracked = false;
+
+    // Cell this explosion burns on the grid while it is alive
+    FGridCoord GridCell;
+    bool bRegisteredOnGrid = false;
+
+    bool bInPool = false;
+
+    // Counted in the Explosion Cells gauge while burning
+    bool bCountedLive = false;
+
+    // Instance in the shared explosion mesh when instanced rendering is on
+    FInstancedMeshHandle RenderHandle;
     
     // ===== Internal functions =====
-    void DealDamageToActor(AActor* Actor);
-    void TriggerChainExplosion(ABomb* NearbyBomb);
+    void StartLifeTimer();
     void DestroyExplosion();
+    void StopLifeTracking();
+    void RemoveRenderInstance();
+    void UnregisterFromGrid();
+    void UncountLive();
 };
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InstancedMeshRenderSubsystem.generated.h"
+
+class UMaterialInterface;
+class UStaticMesh;
+class UStaticMeshComponent;
+class UInstancedStaticMeshComponent;
+
+// Slot of one rendered actor in a shared instanced mesh
+struct FInstancedMeshHandle
+{
+	int32 Batch	   = INDEX_NONE;
+	int32 Instance = INDEX_NONE;
+
+	bool IsValid() const { return Batch != INDEX_NONE; }
+	void Reset() { *this = FInstancedMeshHandle(); }
+};
+
+// Per-instance custom data layout, for bomb / explosion materials that read PerInstanceCustomData.
+// The look never depends on it: the pulse still moves the instance transform and each
+// explosion type keeps the mesh and materials its Blueprint gave it.
+namespace BombermanInstanceData
+{
+	static constexpr int32 NumFloats = 4;
+
+	// Bomb: parameters of the pulse, so a material can animate it on the GPU
+	static constexpr int32 BombPulseStartTime = 0;
+	static constexpr int32 BombPulseSpeed	  = 1;
+	static constexpr int32 BombPulseMinScale  = 2;
+	static constexpr int32 BombPulseMaxScale  = 3;
+
+	// Explosion: EExplosionType selects the look of the cell
+	static constexpr int32 ExplosionType	  = 0;
+	static constexpr int32 ExplosionStartTime = 1;
+	static constexpr int32 ExplosionLifeTime  = 2;
+}
+
+// Sources share a batch when both their mesh and their materials match
+struct FInstancedMeshBatchKey
+{
+	TObjectKey<UStaticMesh> Mesh;
+	TArray<TObjectKey<UMaterialInterface>, TInlineAllocator<4>> Materials;
+
+	bool operator==(const FInstancedMeshBatchKey& Other) const { return Mesh == Other.Mesh && Materials == Other.Materials; }
+
+	friend uint32 GetTypeHash(const FInstancedMeshBatchKey& Key)
+	{
+		uint32 Hash = GetTypeHash(Key.Mesh);
+		for (const TObjectKey<UMaterialInterface>& Material : Key.Materials)
+		{
+			Hash = HashCombineFast(Hash, GetTypeHash(Material));
+		}
+		return Hash;
+	}
+};
+
+USTRUCT()
+struct FInstancedMeshBatch
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UInstancedStaticMeshComponent> Component = nullptr;
+
+	// Hidden instances ready for reuse, instances are never removed so indices stay stable
+	TArray<int32> FreeInstances;
+
+	bool bDirty = false;
+};
+
+/**
+ * Renders bombs and explosion cells through one instanced static mesh per mesh asset,
+ * so a big blast is a handful of draw calls instead of one primitive per actor.
+ * Enabled with bomberman.InstancedRendering, actors keep their own mesh component otherwise.
+ */
+UCLASS()
+class BOMBERMAN_API UInstancedMeshRenderSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static bool IsEnabled();
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Takes over rendering of Source (hidden afterwards), using its mesh, materials and world transform.
+	// Sources with a dynamic material instance keep rendering themselves (invalid handle).
+	FInstancedMeshHandle AddInstance(UStaticMeshComponent* Source, TConstArrayView<float> CustomData);
+	// Shows Source again and frees the slot
+	void RemoveInstance(FInstancedMeshHandle& Handle, UStaticMeshComponent* Source);
+
+	void UpdateTransform(const FInstancedMeshHandle& Handle, const FTransform& WorldTransform);
+	void SetCustomData(const FInstancedMeshHandle& Handle, TConstArrayView<float> CustomData);
+
+private:
+	UPROPERTY(Transient)
+	TObjectPtr<AActor> RenderActor;
+
+	UPROPERTY(Transient)
+	TArray<FInstancedMeshBatch> Batches;
+
+	TMap<FInstancedMeshBatchKey, int32> BatchByKey;
+
+	// Reused between lookups, the inline materials keep AddInstance off the heap
+	FInstancedMeshBatchKey ScratchKey;
+
+	int32 FindOrAddBatch(const UStaticMeshComponent* Source);
+};
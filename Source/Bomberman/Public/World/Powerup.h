@@ -10,7 +10,8 @@ UCLASS()
 class BOMBERMAN_API APowerup : public AActor
 {
 	GENERATED_BODY()
-	
-
 
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 };